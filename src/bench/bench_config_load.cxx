@@ -0,0 +1,92 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <cppconfig/config.h>
+
+// Time to load a configuration folder made of many drop-in files by number of parsing threads
+// (Config::Options::threads).
+//
+// Usage: bench_config_load [files] [members]
+// A temporary folder with a default.json and `files` drop-in files in conf.d (60 by default), each
+// one with `members` objects (2000 by default), is loaded and removed.
+
+
+namespace {
+
+constexpr size_t kRuns { 5 }; ///< Loads per thread count; the fastest one is printed.
+
+// ----------------------------------------------------------------------------
+// fragment
+// ----------------------------------------------------------------------------
+std::string fragment (size_t file, size_t members) {
+  std::string json { "{ \"fragment_" };
+  json += std::to_string (file);
+  json += "\": {";
+
+  for (size_t m { 0 }; m < members; ++m) {
+    json += m? ", \"item_" : " \"item_";
+    json += std::to_string (m);
+    json += "\": { \"name\": \"value of the item\", \"enabled\": true, \"weight\": 0.25, \"ports\": [ 80, 443 ] }";
+  }
+
+  return json + " } }";
+}
+
+// ----------------------------------------------------------------------------
+// measure
+// ----------------------------------------------------------------------------
+double measure (const std::filesystem::path &folder, size_t threads) {
+  cppconfig::Config::Options options {};
+  options.threads = threads;
+
+  double best { 0 };
+  for (size_t run { 0 }; run < kRuns; ++run) {
+    const auto t0 { std::chrono::steady_clock::now() };
+    const cppconfig::Config config { folder, options };
+    const auto t1 { std::chrono::steady_clock::now() };
+
+    const double ms { std::chrono::duration<double, std::milli> (t1 - t0).count() };
+    if ((run == 0) || (ms < best))
+      best = ms;
+  }
+
+  return best;
+}
+
+}
+
+// ----------------------------------------------------------------------------
+// main
+// ----------------------------------------------------------------------------
+int main (int argc, char **argv) {
+  const size_t files { (argc > 1)? static_cast<size_t> (std::atoi (argv[1])) : 60 };
+  const size_t members { (argc > 2)? static_cast<size_t> (std::atoi (argv[2])) : 2000 };
+
+  const auto folder { std::filesystem::temp_directory_path() / ("bench_config_load_" + std::to_string (::getpid())) };
+  std::filesystem::create_directories (folder / "conf.d");
+
+  std::ofstream { folder / "default.json" } << "{ \"name\": \"bench\" }";
+  for (size_t f { 0 }; f < files; ++f) {
+    std::string fileName { std::to_string (100 + f) };
+    fileName += ".json";
+    std::ofstream { folder / "conf.d" / fileName } << fragment (f, members);
+  }
+
+  std::printf ("%-8s %10s\n", "threads", "load ms");
+  for (const size_t threads: { 1, 2, 4, 8 })
+    std::printf ("%-8zu %10.1f\n", threads, measure (folder, threads));
+
+  std::filesystem::remove_all (folder);
+  return 0;
+}
@@ -0,0 +1,102 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <cppconfig/config.h>
+
+// Latency of Config::get() by depth of the key, walking the tree and with the full-path index
+// (Config::Options::index).
+//
+// Usage: bench_config_lookup [depth]
+// A synthetic configuration with 8 sections, each one nested `depth` levels deep (12 by default)
+// with a few members at every level, is used. The keys end in the "port" member of each level.
+
+
+namespace {
+
+constexpr size_t kSections { 8 }; ///< Objects at the top level.
+constexpr size_t kIterations { 2000000 }; ///< Lookups per key.
+
+// ----------------------------------------------------------------------------
+// synthetic
+// ----------------------------------------------------------------------------
+std::string synthetic (size_t depth) {
+  std::string json { "{" };
+
+  for (size_t s { 0 }; s < kSections; ++s) {
+    json += (s? ", " : " ");
+    json += "\"section_" + std::to_string (s) + "\": ";
+
+    for (size_t d { 0 }; d < depth; ++d)
+      json += "{ \"name\": \"level\", \"enabled\": true, \"port\": 5432, \"child\": ";
+
+    json += "{ \"port\": 5432, \"hosts\": [ \"a\", \"b\" ] }";
+    json += std::string (depth, '}');
+  }
+
+  return json + " }";
+}
+
+// ----------------------------------------------------------------------------
+// key
+// ----------------------------------------------------------------------------
+std::string key (size_t section, size_t depth) {
+  std::string result { "section_" + std::to_string (section) };
+
+  for (size_t d { 0 }; d < depth; ++d)
+    result += ".child";
+
+  return result + ".port";
+}
+
+// ----------------------------------------------------------------------------
+// measure
+// ----------------------------------------------------------------------------
+double measure (const cppconfig::Config &config, const std::vector<std::string> &keys) {
+  int64_t sum { 0 };
+
+  const auto t0 { std::chrono::steady_clock::now() };
+  for (size_t i { 0 }; i < kIterations; ++i)
+    sum += config.get<int64_t> (keys[i % keys.size()]).value();
+  const auto t1 { std::chrono::steady_clock::now() };
+
+  if (sum == 0)
+    std::printf ("unexpected sum\n");
+
+  return std::chrono::duration<double, std::nano> (t1 - t0).count() / kIterations;
+}
+
+}
+
+// ----------------------------------------------------------------------------
+// main
+// ----------------------------------------------------------------------------
+int main (int argc, char **argv) {
+  const size_t depth { (argc > 1)? static_cast<size_t> (std::atoi (argv[1])) : 12 };
+  const auto json { synthetic (depth) };
+
+  cppconfig::Config::Options options {};
+  const cppconfig::Config walked { json.c_str(), json.size(), options };
+
+  options.index = true;
+  const cppconfig::Config indexed { json.c_str(), json.size(), options };
+
+  std::printf ("%-6s %14s %14s\n", "depth", "walk ns/get", "index ns/get");
+
+  for (size_t d { 0 }; d <= depth; d += (d < 4)? 1 : 4) {
+    std::vector<std::string> keys {};
+    for (size_t s { 0 }; s < kSections; ++s)
+      keys.push_back (key (s, d));
+
+    std::printf ("%-6zu %14.1f %14.1f\n", d + 2, measure (walked, keys), measure (indexed, keys));
+  }
+
+  return 0;
+}
@@ -0,0 +1,205 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <memory_resource>
+#include <new>
+#include <string>
+
+#include <cppconfig/json_parser.h>
+
+// Memory used by the JsonValue tree of a document: bytes and allocations per node, with the
+// default heap and with a monotonic arena.
+//
+// Usage: bench_json_memory [file.json]
+// Without a file, a synthetic configuration with many small per-tenant objects is used.
+
+
+namespace {
+
+size_t gBytes { 0 }; ///< Bytes requested to operator new.
+size_t gCalls { 0 }; ///< Calls to operator new.
+
+// ----------------------------------------------------------------------------
+// Counter
+//
+// Counts the requests to a memory resource before passing them upstream.
+// ----------------------------------------------------------------------------
+class Counter: public std::pmr::memory_resource {
+  public:
+    explicit Counter (std::pmr::memory_resource *upstream): _upstream { upstream } {
+      // empty
+    }
+
+    size_t bytes { 0 }; ///< Bytes requested.
+    size_t calls { 0 }; ///< Number of requests.
+
+  private:
+    std::pmr::memory_resource *_upstream; ///< Resource that allocates the memory.
+
+    void * do_allocate (size_t n, size_t align) override {
+      bytes += n;
+      ++calls;
+      return _upstream->allocate (n, align);
+    }
+
+    void do_deallocate (void *p, size_t n, size_t align) override {
+      _upstream->deallocate (p, n, align);
+    }
+
+    bool do_is_equal (const std::pmr::memory_resource &other) const noexcept override {
+      return this == &other;
+    }
+};
+
+// ----------------------------------------------------------------------------
+// synthetic
+// ----------------------------------------------------------------------------
+std::string synthetic (size_t tenants) {
+  std::string json { "{ \"tenants\": [" };
+
+  for (size_t i { 0 }; i < tenants; ++i) {
+    const auto n { std::to_string (i) };
+
+    json += (i? ", " : " ");
+    json += "{ \"id\": " + n + ", \"name\": \"tenant-" + n + "\", \"enabled\": true, \"db\": null, "
+      "\"limits\": { \"rps\": 100, \"burst\": 2.5 }, \"tags\": [ \"blue\", \"eu-west\" ] }";
+  }
+
+  return json + " ] }";
+}
+
+// ----------------------------------------------------------------------------
+// count
+// ----------------------------------------------------------------------------
+size_t count (const cppconfig::json::JsonValue &value) {
+  size_t nodes { 1 };
+
+  if (value.isObject()) {
+    for (const auto &[k, v]: value.asObject())
+      nodes += count (v);
+  }
+  else if (value.isArray()) {
+    for (const auto &v: value.asArray())
+      nodes += count (v);
+  }
+
+  return nodes;
+}
+
+// ----------------------------------------------------------------------------
+// report
+// ----------------------------------------------------------------------------
+void report (const char *name, size_t nodes, size_t bytes, size_t calls) {
+  std::printf (
+    "%-18s %10zu bytes %9zu allocs %8.1f bytes/node %6.2f allocs/node\n",
+    name, bytes, calls, static_cast<double> (bytes) / static_cast<double> (nodes),
+    static_cast<double> (calls) / static_cast<double> (nodes)
+  );
+}
+
+}
+
+// ----------------------------------------------------------------------------
+// operator new / delete
+// ----------------------------------------------------------------------------
+void * operator new (size_t n) {
+  gBytes += n;
+  ++gCalls;
+
+  if (void *p { std::malloc (n? n : 1) }; p)
+    return p;
+
+  throw std::bad_alloc {};
+}
+
+void * operator new (size_t n, std::align_val_t align) {
+  gBytes += n;
+  ++gCalls;
+
+  // std::pmr::new_delete_resource() uses the aligned versions
+  const auto a { static_cast<size_t> (align) };
+  if (void *p { std::aligned_alloc (a, (n + a - 1) / a * a) }; p)
+    return p;
+
+  throw std::bad_alloc {};
+}
+
+void operator delete (void *p) noexcept {
+  std::free (p);
+}
+
+void operator delete (void *p, size_t) noexcept {
+  std::free (p);
+}
+
+void operator delete (void *p, std::align_val_t) noexcept {
+  std::free (p);
+}
+
+void operator delete (void *p, size_t, std::align_val_t) noexcept {
+  std::free (p);
+}
+
+// ----------------------------------------------------------------------------
+// main
+// ----------------------------------------------------------------------------
+int main (int argc, char **argv) {
+  std::string json {};
+
+  if (argc > 1) {
+    std::ifstream file { argv[1] };
+    json.assign (std::istreambuf_iterator<char> { file }, std::istreambuf_iterator<char> {});
+  }
+  else {
+    json = synthetic (20000);
+  }
+
+  std::printf ("sizeof (JsonValue): %zu bytes\n", sizeof (cppconfig::json::JsonValue));
+
+  // default heap
+  {
+    cppconfig::json::JsonParser parser {};
+
+    const auto bytes { gBytes };
+    const auto calls { gCalls };
+
+    const auto root { parser.parse (json.data(), json.size()) };
+    if (!root.has_value()) {
+      std::fprintf (stderr, "parse error: %s\n", parser.error().str().c_str());
+      return 1;
+    }
+
+    const auto nodes { count (root.value()) };
+    std::printf ("nodes: %zu\n", nodes);
+
+    report ("heap", nodes, gBytes - bytes, gCalls - calls);
+  }
+
+  // arena: requests of the tree, then the blocks taken from the heap
+  {
+    std::pmr::monotonic_buffer_resource arena {};
+    Counter counter { &arena };
+
+    cppconfig::json::JsonParser::Options options {};
+    options.resource = &counter;
+
+    cppconfig::json::JsonParser parser { options };
+
+    const auto bytes { gBytes };
+    const auto calls { gCalls };
+
+    const auto root { parser.parse (json.data(), json.size()) };
+    const auto nodes { count (root.value()) };
+
+    report ("arena (requested)", nodes, counter.bytes, counter.calls);
+    report ("arena (heap)", nodes, gBytes - bytes, gCalls - calls);
+  }
+
+  return 0;
+}
@@ -6,9 +6,23 @@
 #ifndef __CPP_CONFIG_H__
 #define __CPP_CONFIG_H__
 #include <filesystem>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <string>
 #include <string_view>
+#include <typeinfo>
+#include <utility>
+#include <vector>
 
+#include <cppconfig/config_key.h>
+#include <cppconfig/json_layered_document.h>
 #include <cppconfig/json_parser.h>
+#include <cppconfig/json_path_index.h>
+#include <cppconfig/json_path_trie.h>
+#include <cppconfig/json_shared_value.h>
+#include <cppconfig/mm_file.h>
 
 
 namespace cppconfig {
@@ -36,12 +50,15 @@ namespace cppconfig {
 /// host-specific configurations.
 ///
 /// The class loads configuration files in the following order, allowing each step
-/// to override or extend the previous:
+/// to override or extend the previous (they can be parsed concurrently, see Options::threads):
 ///  @li default.json - The base configuration.
+///  @li conf.d/\*.json - Optional drop-in files, in alphabetical order.
 ///  @li {deployment}.json - Deployment-specific configuration, where `{deployment}`
 ///                          is derived from the `CPPCONFIG_ENV` environment variable.
 ///  @li {hostname}.json - Host-specific configuration, where `{hostname}` is the
 ///                        system's host name in lowercase.
+///  @li Environment variables named `CPPCONFIG__{key}__{key}...`, each one overriding the value
+///      at that path (see Options::environment).
 class Config {
   public:
     /// @brief Represents a system configuration interface.
@@ -59,6 +76,11 @@ class Config {
       /// @return A constant reference to a std::string containing the environment variable name.
       virtual const std::string & getEnvName() const;
 
+      /// @brief Retrieves the environment variables that override configuration values, those
+      /// whose name starts with `CPPCONFIG__`. The environment is scanned once per call.
+      /// @return The name and value of every variable, in no particular order.
+      virtual std::vector<std::pair<std::string, std::string>> getOverrides() const;
+
       /// @brief Returns a reference to the singleton instance of the System class.
       /// @return A constant reference to the singleton System instance.
       static const System & instance() {
@@ -68,21 +90,182 @@ class Config {
       }
     };
 
+    /// @brief Settings used to load the configuration.
+    struct Options {
+      /// @brief How the configuration is stored once loaded.
+      enum class Storage {
+        kTree, //!< A tree of json::JsonValue nodes.
+        kTape, //!< A json::Tape: one array of tagged words plus a string arena.
+        kLazy,   //!< A json::LazyDocument: values are parsed the first time they are requested, from the mapped files or from a copy of the buffer.
+        kLayered, //!< A json::LayeredDocument: every file is a separate layer, combined when it is looked up.
+        kShared   //!< A json::SharedValue: an immutable tree whose unchanged containers are shared between versions.
+      };
+
+      json::JsonParser::Options parser {}; ///< Settings of the JSON parser.
+      Storage storage { Storage::kTree }; ///< How the configuration is stored.
+      /// Allocates the parsed values from large memory blocks owned by the configuration, which are
+      /// released all at once when it is destroyed. Values replaced by parse() are not released before.
+      bool arena { false };
+      /// Builds a hash table of the full path of every value once the configuration is loaded (see
+      /// json::PathIndex), so get() finds a key with one probe whatever its depth. It is rebuilt by
+      /// parse(). Only used with Storage::kTree.
+      bool index { false };
+      /// Maximum number of threads that parse the files of a folder or of a list at the same time,
+      /// the calling one included. 1, the default, parses them one after another in the calling
+      /// thread; 0 uses one per file, up to the number of cores and at most 8. The files are also
+      /// parsed one after another when the parser allocates from a memory resource (see arena),
+      /// which is not meant to be shared between threads.
+      size_t threads { 1 };
+      /// Applies the environment variables returned by System::getOverrides() on top of the files of
+      /// a folder. `CPPCONFIG__database__port=5432` sets the integer "database.port": values that are
+      /// JSON (numbers, true, false, null, quoted strings, objects and arrays) are taken as such, any
+      /// other one as a string. A variable replaces the value at its path whatever its type, arrays
+      /// included. They are merged once, when the folder is loaded.
+      bool environment { true };
+    };
+
+    /// @brief A key parsed once, to be looked up many times.
+    ///
+    /// The key is split into its members and array positions when the path is built, and the
+    /// hash of every member key is computed then, so a lookup with a path only walks the values.
+    class Path {
+      public:
+        /// @brief A step of the path.
+        struct Segment {
+          std::string key {}; ///< Key of a member.
+          uint32_t hash { 0 }; ///< Hash of the key, see json::JsonObject::hash.
+          size_t index { 0 }; ///< Position of an item.
+          bool item { false }; ///< True for an array item, false for a member.
+        };
+
+        /// @brief Parses a key.
+        /// @param key The key, with the syntax of get().
+        /// @throws std::invalid_argument if an array position is not a number.
+        explicit Path (std::string_view key);
+
+        /// @brief Builds a path from a key split at compile time: nothing is parsed.
+        /// @param key The key.
+        template<size_t N, size_t M>
+        explicit Path (const Key<N, M> &key): _key { key.str() } {
+          _segments.reserve (M);
+          for (size_t i { 0 }; i < M; ++i) {
+            const auto &segment { key.segments[i] };
+            _segments.push_back (Segment { std::string { key.key (i) }, segment.hash, segment.index, segment.item });
+          }
+        }
+
+        /// @brief Gets the key the path was built from.
+        inline const std::string & str() const noexcept { return _key; }
+
+        /// @brief Gets the steps of the path.
+        inline const std::vector<Segment> & segments() const noexcept { return _segments; }
+
+      private:
+        std::string _key; ///< The key.
+        std::vector<Segment> _segments {}; ///< Steps of the key.
+    };
+
     /// @brief Constructs a Config object with the specified file path.
     /// @param fileName The path to the configuration file.
+    /// @param system The system information used to determine the environment and host-specific files.
     Config (const std::filesystem::path &fileName, const System &system = System::instance());
 
+    /// @brief Constructs a Config object with the specified file path and load settings.
+    /// @param fileName The path to the configuration file.
+    /// @param options The settings used to load the configuration.
+    /// @param system The system information used to determine the environment and host-specific files.
+    Config (const std::filesystem::path &fileName, const Options &options, const System &system = System::instance());
+
+    /// @brief Constructs a Config object from a list of files, each one extending or overriding the
+    /// previous ones. A folder in the list stands for the JSON files inside it, in alphabetical
+    /// order. The files can be parsed concurrently (see Options::threads) and merged in order.
+    /// @param fileNames The configuration files.
+    /// @throws std::invalid_argument if the list is empty.
+    /// @throws std::ios_base::failure if a file cannot be opened.
+    /// @throws std::runtime_error if a file cannot be parsed.
+    explicit Config (const std::vector<std::filesystem::path> &fileNames);
+
+    /// @brief Constructs a Config object from a list of files with the specified load settings.
+    /// @param fileNames The configuration files, see Config(const std::vector<std::filesystem::path> &).
+    /// @param options The settings used to load the configuration.
+    Config (const std::vector<std::filesystem::path> &fileNames, const Options &options);
+
     /// @brief Constructs a Config object with the provided JSON buffer.
     /// @param buffer The JSON buffer.
     /// @param len The length of the buffer (default is 0, which assumes a null-terminated buffer).
     Config (const char *buffer, size_t len = 0);
 
-    /// @brief Parses the provided JSON buffer and updates the configuration.
+    /// @brief Constructs a Config object with the provided JSON buffer and load settings.
+    /// When zero-copy strings are enabled, the buffer must outlive the Config object. With
+    /// Options::Storage::kLazy the buffer is copied, so it can be released afterwards.
+    /// @param buffer The JSON buffer.
+    /// @param len The length of the buffer (0 assumes a null-terminated buffer).
+    /// @param options The settings used to load the configuration.
+    Config (const char *buffer, size_t len, const Options &options);
+
+    Config (Config &&) noexcept;
+    Config & operator= (Config &&) noexcept;
+    ~Config();
+
+    /// @brief Parses the provided JSON buffer and updates the configuration. A layered
+    /// configuration keeps its layers if the buffer cannot be parsed. The buffer must outlive the
+    /// configuration when zero-copy strings are enabled; with Options::Storage::kLazy it is copied.
     /// @param buffer The JSON buffer.
     /// @param len The length of the buffer (default is 0, which assumes a null-terminated buffer).
     /// @return True if parsing is successful, false otherwise.
     bool parse (const char *buffer, size_t len = 0);
 
+    /// @brief Loads a JSON file as a layer of the configuration. Only the layer is parsed, the
+    /// other ones are not touched. It requires Options::Storage::kLayered.
+    /// @param name The name of the layer: "default", or the environment or host name of the file
+    /// it was loaded from. A layer with the same name is replaced and keeps its precedence,
+    /// otherwise the new layer takes precedence over all the others.
+    /// @param fileName The path to the JSON file.
+    /// @throws std::logic_error if the configuration is not layered.
+    /// @throws std::ios_base::failure if the file is not found.
+    /// @throws std::runtime_error if the file cannot be parsed.
+    void loadLayer (std::string_view name, const std::filesystem::path &fileName);
+
+    /// @brief Parses a JSON buffer as a layer of the configuration, as loadLayer() does.
+    /// When zero-copy strings are enabled, the buffer must outlive the layer.
+    /// @param name The name of the layer.
+    /// @param buffer The JSON buffer.
+    /// @param len The length of the buffer (0 assumes a null-terminated buffer).
+    /// @return True if parsing is successful, false otherwise.
+    /// @throws std::logic_error if the configuration is not layered.
+    bool parseLayer (std::string_view name, const char *buffer, size_t len = 0);
+
+    /// @brief Removes a layer of the configuration.
+    /// @param name The name of the layer.
+    /// @return True if there was a layer with that name.
+    /// @throws std::logic_error if the configuration is not layered.
+    bool removeLayer (std::string_view name);
+
+    /// @brief Changes the value of a key. A new version of the configuration is made, which shares
+    /// with the previous one every container that is not along the key, and replaces it. Snapshots
+    /// of the previous version are not affected. It requires Options::Storage::kShared, and must
+    /// not be called while other threads read the configuration.
+    /// @param key The key, with the syntax of get(). Missing members are added.
+    /// @param value The new value.
+    /// @return True if the value is set, false if the key goes through a value that is not a
+    /// container of the right kind or through a position beyond the end of an array.
+    /// @throws std::logic_error if the configuration is not shared.
+    bool set (std::string_view key, const json::JsonValue &value);
+
+    /// @brief Gets the current version of the configuration. It is not copied: the snapshot keeps
+    /// it alive and unchanged whatever is set afterwards.
+    /// @return The root of the configuration.
+    /// @throws std::logic_error if the configuration is not shared.
+    json::SharedValue snapshot() const;
+
+    /// @brief Builds a trie of the paths of the configuration, to list the keys below a prefix,
+    /// match wildcard patterns such as "upstreams.*.timeout" or find the longest existing prefix
+    /// of a key. It points to the values of the configuration: it is valid until the next call to
+    /// parse() or until the configuration is destroyed.
+    /// @return The trie.
+    /// @throws std::logic_error if the configuration is not stored as a tree.
+    json::PathTrie trie() const;
+
     /// @brief Retrieves a configuration value of the specified type.
     /// @tparam T The type of the configuration value.
     /// The supported types for T are:
@@ -91,69 +274,281 @@ class Config {
     ///   @li string: std::string
     ///   @li bloolean: bool
     ///   @li vector: std::vector<integer|float-point|string|boolean>
+    ///   @li views: std::string_view and std::span<const integer|float-point>. They reference memory
+    ///       owned by the configuration instead of copying the value, and are valid until the
+    ///       configuration is destroyed or changed (parse, set, loadLayer, parseLayer, removeLayer).
+    ///       The items of an array are converted the first time a span of their type is requested,
+    ///       and kept for the following requests.
     /// @param key The key to look up in the configuration, supporting dot notation for nested objects
     /// and array indexing with '[]' (e.g., "key1.array[3].key2").
     /// @return An optional containing the retrieved value, or std::nullopt if the key is not found.
     template<typename T = std::string>
     inline std::optional<T> get (std::string_view key) const {
-      const auto jsonVal { _getJsonValue (key) };
-      if (jsonVal.has_value()) {
-        if constexpr (std::is_same_v<T, bool>) {
-          return static_cast<T> (jsonVal.value().get().get<bool>());
-        }
-        else if constexpr (std::is_integral_v<T>) {
-          return static_cast<T> (jsonVal.value().get().get<int64_t>());
-        }
-        else if constexpr (std::is_floating_point_v<T>) {
-          return static_cast<T> (jsonVal.value().get().get<double>());
-        }
-        else if constexpr (
-          (std::is_same_v<T, std::vector<std::string>>) ||
-          (std::is_same_v<T, std::vector<double>>) ||
-          (std::is_same_v<T, std::vector<int64_t>>) ||
-          (std::is_same_v<T, std::vector<bool>>)
-        ) {
-          T result;
-          for (const auto &jv: jsonVal.value().get().asArray())
-            result.push_back (jv.get<typename T::value_type>());
-          return result;
-        }
-        else if constexpr (
-          (std::is_same_v<T, std::vector<int32_t>>) ||
-          (std::is_same_v<T, std::vector<int16_t>>) ||
-          (std::is_same_v<T, std::vector<int8_t>>) ||
-          (std::is_same_v<T, std::vector<uint64_t>>) ||
-          (std::is_same_v<T, std::vector<uint32_t>>) ||
-          (std::is_same_v<T, std::vector<uint16_t>>) ||
-          (std::is_same_v<T, std::vector<uint8_t>>)
-        ) {
-          T result;
-          for (const auto &jv: jsonVal.value().get().asArray())
-            result.push_back (static_cast<typename T::value_type> (jv.get<int64_t>()));
-          return result;
-        }
-        else if constexpr (std::is_same_v<T, std::vector<float>>) {
-          T result;
-          for (const auto &jv: jsonVal.value().get().asArray())
-            result.push_back (static_cast<typename T::value_type> (jv.get<double>()));
-          return result;
-        }
-        else {
-          return jsonVal.value().get().get<T>();
-        }
+      return _get<T> (key);
+    }
+
+    /// @brief Retrieves a configuration value of the specified type with a key parsed beforehand.
+    /// It is the fastest way to look up the same key many times.
+    /// @tparam T The type of the configuration value, as in get(std::string_view).
+    /// @param path The key.
+    /// @return An optional containing the retrieved value, or std::nullopt if the key is not found.
+    template<typename T = std::string>
+    inline std::optional<T> get (const Path &path) const {
+      return _get<T> (path);
+    }
+
+    /// @brief Retrieves a configuration value of the specified type with a key checked and split
+    /// at compile time, e.g. get<uint16_t, "database.port"_key>() with cppconfig::literals.
+    /// A malformed key does not compile.
+    /// @tparam T The type of the configuration value, as in get(std::string_view).
+    /// @tparam K The key.
+    /// @return An optional containing the retrieved value, or std::nullopt if the key is not found.
+    template<typename T, Key K>
+    inline std::optional<T> get() const {
+      static const Path path { K };
+      return _get<T> (path);
+    }
+
+  private:
+    /// @brief Looks up a value in the storage of the configuration and converts it.
+    /// @tparam T The requested type.
+    /// @tparam Key std::string_view or Path.
+    /// @param key The key.
+    /// @return The converted value, or std::nullopt if the key is not found.
+    template<typename T, typename Key>
+    inline std::optional<T> _get (const Key &key) const {
+      if (_storage == Options::Storage::kTape) {
+        if (const auto value { _getTapeValue (key) }; value.has_value())
+          return _as<T> (value.value());
+      }
+      else if (_storage == Options::Storage::kLazy) {
+        if (const auto jsonVal { _getLazyValue (key) }; jsonVal.has_value())
+          return _as<T> (jsonVal.value().get());
+      }
+      else if (_storage == Options::Storage::kLayered) {
+        if (const auto jsonVal { _getLayeredValue (key) }; jsonVal.has_value())
+          return _as<T> (jsonVal.value().get());
+      }
+      else if (_storage == Options::Storage::kShared) {
+        if (const auto *value { _getSharedValue (key) }; value != nullptr)
+          return _as<T> (*value);
+      }
+      else if (const auto jsonVal { _getJsonValue (key) }; jsonVal.has_value()) {
+        return _as<T> (jsonVal.value().get());
       }
 
       return std::nullopt;
     }
 
-  private:
+    /// @brief Converts a JSON value to the type requested by get().
+    /// @tparam T The requested type.
+    /// @tparam Node json::JsonValue, json::Tape::Value or json::SharedValue.
+    /// @param node The value.
+    /// @return The converted value.
+    template<typename T, typename Node>
+    inline T _as (const Node &node) const {
+      if constexpr (std::is_same_v<T, bool>) {
+        return static_cast<T> (node.template get<bool>());
+      }
+      else if constexpr (std::is_integral_v<T>) {
+        return static_cast<T> (node.template get<int64_t>());
+      }
+      else if constexpr (std::is_floating_point_v<T>) {
+        return static_cast<T> (node.template get<double>());
+      }
+      else if constexpr (std::is_same_v<T, std::string>) {
+        return std::string { node.asStringView() };
+      }
+      else if constexpr (std::is_same_v<T, std::string_view>) {
+        return node.asStringView();
+      }
+      else if constexpr (requires { typename T::element_type; }) {
+        using Item = typename T::element_type;
+        static_assert (
+          std::is_same_v<T, std::span<Item>> && std::is_const_v<Item> && std::is_arithmetic_v<Item> && !std::is_same_v<Item, const bool>,
+          "spans of numbers only: std::span<const integer|float-point>"
+        );
+
+        const auto *items { static_cast<const std::vector<std::remove_const_t<Item>> *> (_array (
+          _identity (node),
+          typeid (Item),
+          &_toVector<std::remove_const_t<Item>, Node>,
+          &node
+        )) };
+        return T { items->data(), items->size() };
+      }
+      else if constexpr (std::is_same_v<T, std::vector<std::string>>) {
+        T result;
+        result.reserve (_count (node));
+        for (const auto &jv: node.asArray())
+          result.emplace_back (jv.asStringView());
+        return result;
+      }
+      else if constexpr (
+        (std::is_same_v<T, std::vector<double>>) ||
+        (std::is_same_v<T, std::vector<int64_t>>) ||
+        (std::is_same_v<T, std::vector<bool>>)
+      ) {
+        T result;
+        result.reserve (_count (node));
+        for (const auto &jv: node.asArray())
+          result.push_back (jv.template get<typename T::value_type>());
+        return result;
+      }
+      else if constexpr (
+        (std::is_same_v<T, std::vector<int32_t>>) ||
+        (std::is_same_v<T, std::vector<int16_t>>) ||
+        (std::is_same_v<T, std::vector<int8_t>>) ||
+        (std::is_same_v<T, std::vector<uint64_t>>) ||
+        (std::is_same_v<T, std::vector<uint32_t>>) ||
+        (std::is_same_v<T, std::vector<uint16_t>>) ||
+        (std::is_same_v<T, std::vector<uint8_t>>)
+      ) {
+        T result;
+        result.reserve (_count (node));
+        for (const auto &jv: node.asArray())
+          result.push_back (static_cast<typename T::value_type> (jv.template get<int64_t>()));
+        return result;
+      }
+      else if constexpr (std::is_same_v<T, std::vector<float>>) {
+        T result;
+        result.reserve (_count (node));
+        for (const auto &jv: node.asArray())
+          result.push_back (static_cast<typename T::value_type> (jv.template get<double>()));
+        return result;
+      }
+      else if constexpr (requires { node.template get<T>(); }) {
+        return node.template get<T>();
+      }
+      else {
+        throw std::bad_variant_access {}; // not available in this storage
+      }
+    }
+
+    /// @brief Gets the number of items of an array, to reserve the vectors returned by get().
+    /// @throws std::bad_variant_access if the value is not an array.
+    template<typename Node>
+    static inline size_t _count (const Node &node) {
+      if constexpr (requires { node.asArray().size(); })
+        return node.asArray().size();
+      else
+        return node.size();
+    }
+
+    /// @brief Identifies a value for the arrays converted by _array(): its address, or its position
+    /// in the tape, which is not made of nodes.
+    template<typename Node>
+    static inline std::pair<const void *, size_t> _identity (const Node &node) noexcept {
+      if constexpr (std::is_same_v<Node, json::Tape::Value>)
+        return { nullptr, node.index() };
+      else
+        return { &node, 0 };
+    }
+
+    /// @brief Converts the items of an array, see _array().
+    /// @tparam Item The type of the items.
+    /// @tparam Node json::JsonValue, json::Tape::Value or json::SharedValue.
+    /// @param node The array.
+    /// @return A std::vector<Item> with the converted items.
+    /// @throws std::bad_variant_access if the value is not an array or an item is not a number.
+    template<typename Item, typename Node>
+    static std::shared_ptr<const void> _toVector (const void *node) {
+      const auto &array { *static_cast<const Node *> (node) };
+
+      auto result { std::make_shared<std::vector<Item>>() };
+      result->reserve (_count (array));
+      for (const auto &jv: array.asArray()) {
+        if constexpr (std::is_integral_v<Item>)
+          result->push_back (static_cast<Item> (jv.template get<int64_t>()));
+        else
+          result->push_back (static_cast<Item> (jv.template get<double>()));
+      }
+
+      return result;
+    }
+
+    /// @brief Gets the items of an array converted to a type, converting them the first time.
+    /// Arrays converted before are found without a lock; conversions take one.
+    /// @param id The array, see _identity().
+    /// @param type The type of the items.
+    /// @param convert Converts the items of @p node when they are not converted yet.
+    /// @param node The array.
+    /// @return The std::vector returned by @p convert, kept until the configuration is changed.
+    const void * _array (
+      std::pair<const void *, size_t> id,
+      const std::type_info &type,
+      std::shared_ptr<const void> (*convert) (const void *),
+      const void *node
+    ) const;
+
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> _arena {}; /// Memory of the parsed values, if Options::arena is set.
     json::JsonParser _parser {}; /// JSON parser for parsing configuration data.
+    Options::Storage _storage { Options::Storage::kTree }; /// How the configuration is stored.
+    size_t _threads { 1 }; /// Threads that parse the files of a folder, see Options::threads.
+    std::unique_ptr<const std::string> _overrides {}; /// JSON document of the environment variables, see Options::environment.
+    std::unique_ptr<const std::string> _buffer {}; /// Copy of the buffer parsed with Options::Storage::kLazy.
+    std::vector<std::unique_ptr<util::MMapFile<>>> _mappedFiles {}; /// Files referenced by zero-copy strings.
     std::optional<json::JsonValue> _root {}; /// Root JSON value representing the configuration.
+    bool _indexed { false }; /// Whether _root is indexed, see Options::index.
+    std::optional<json::PathIndex> _index {}; /// Full paths of the values of _root.
+    std::optional<json::Tape> _tape {}; /// The configuration when it is stored as a tape.
+    std::optional<json::LazyDocument> _lazy {}; /// The configuration when it is parsed on demand.
+    std::optional<json::LayeredDocument> _layered {}; /// The configuration when its files are kept as layers.
+    std::map<std::string, std::unique_ptr<util::MMapFile<>>, std::less<>> _layerFiles {}; /// Files referenced by the zero-copy strings of each layer.
+
+    std::optional<json::SharedValue> _shared {}; /// The configuration when it is stored as a shared tree.
+
+    struct Paths;
+    std::unique_ptr<Paths> _paths; /// Memoized lookups of the layered configuration.
+
+    struct Arrays;
+    std::unique_ptr<Arrays> _arrays; /// Arrays converted for get<std::span<const T>>().
 
     /// @brief Gets a reference to the JSON value associated with the specified key.
     /// @param sv The key to look up in the configuration.
     /// @return An optional reference to the JSON value, or std::nullopt if the key is not found.
     std::optional<std::reference_wrapper<const json::JsonValue>> _getJsonValue (const std::string_view &sv) const;
+    std::optional<std::reference_wrapper<const json::JsonValue>> _getJsonValue (const Path &path) const;
+
+    /// @brief Gets the tape value associated with the specified key.
+    /// @param sv The key to look up in the configuration.
+    /// @return The value, or std::nullopt if the key is not found.
+    std::optional<json::Tape::Value> _getTapeValue (const std::string_view &sv) const;
+    std::optional<json::Tape::Value> _getTapeValue (const Path &path) const;
+
+    /// @brief Gets the value associated with the specified key, parsing it on demand.
+    /// @param sv The key to look up in the configuration.
+    /// @return An optional reference to the JSON value, or std::nullopt if the key is not found.
+    std::optional<std::reference_wrapper<const json::JsonValue>> _getLazyValue (const std::string_view &sv) const;
+    std::optional<std::reference_wrapper<const json::JsonValue>> _getLazyValue (const Path &path) const;
+
+    /// @brief Gets the value associated with the specified key through the layers of the configuration.
+    /// The result of every key is memoized until the layers change.
+    /// @param sv The key to look up in the configuration.
+    /// @return An optional reference to the JSON value, or std::nullopt if the key is not found.
+    std::optional<std::reference_wrapper<const json::JsonValue>> _getLayeredValue (const std::string_view &sv) const;
+    std::optional<std::reference_wrapper<const json::JsonValue>> _getLayeredValue (const Path &path) const;
+
+    /// @brief Gets the shared value associated with the specified key.
+    /// @param sv The key to look up in the configuration.
+    /// @return The value, or nullptr if the key is not found.
+    const json::SharedValue * _getSharedValue (const std::string_view &sv) const;
+    const json::SharedValue * _getSharedValue (const Path &path) const;
+
+    /// @brief Removes every layer of the layered configuration and forgets the memoized lookups.
+    void _resetLayers();
+
+    /// @brief Sets a layer of the layered configuration and forgets the memoized lookups.
+    /// @param name The name of the layer.
+    /// @param value The root of the layer.
+    /// @param file The file referenced by the zero-copy strings of the layer, if any.
+    /// @param arrays How the arrays of the layer are combined with the ones below.
+    void _setLayer (
+      std::string_view name,
+      json::JsonValue &&value,
+      std::unique_ptr<util::MMapFile<>> &&file,
+      json::JsonValue::Arrays arrays = json::JsonValue::Arrays::kAppend
+    );
 
     /// @brief Loads a JSON file and returns its parsed content.
     /// @param fileName The path to the JSON file to be loaded.
@@ -162,11 +557,42 @@ class Config {
     /// @throws std::ios_base::failure if the specified file is not found.
     std::optional<json::JsonValue> _loadFile (const std::filesystem::path &fileName);
 
+    /// @brief Loads a JSON file into a tape.
+    /// @param fileName The path to the JSON file to be loaded.
+    /// @return An optional containing the tape if successful, or an empty optional if an error occurs
+    ///         during parsing.
+    /// @throws std::ios_base::failure if the specified file is not found.
+    std::optional<json::Tape> _loadTape (const std::filesystem::path &fileName);
+
+    /// @brief Validates a JSON file to be parsed on demand. The file is kept mapped as long as the configuration.
+    /// @param fileName The path to the JSON file to be loaded.
+    /// @return An optional containing the document if successful, or an empty optional if an error occurs
+    ///         during parsing.
+    /// @throws std::ios_base::failure if the specified file is not found.
+    std::optional<json::LazyDocument> _loadLazy (const std::filesystem::path &fileName);
+
+    /// @brief A file to load, see _loadFiles().
+    struct File {
+      std::string name; ///< Name of the layer of the file with Options::Storage::kLayered.
+      std::filesystem::path fileName; ///< The file.
+      std::string_view buffer {}; ///< The JSON document, parsed instead of the file when it is set.
+      json::JsonValue::Arrays arrays { json::JsonValue::Arrays::kAppend }; ///< How its arrays are combined with the previous files.
+    };
+
+    /// @brief Loads configuration files, each one extending or overriding the previous ones. They
+    /// are parsed concurrently and merged in order.
+    /// @param files The files.
+    /// @throws std::ios_base::failure if a file is not found.
+    /// @throws std::runtime_error if a file cannot be parsed. The error of the first of the files
+    /// that fail is thrown.
+    void _loadFiles (const std::vector<File> &files);
+
     /// @brief Loads configuration files from a specified folder based on the given system.
     /// @param folderName The path to the folder containing configuration files.
     /// @param system The system information used to determine the environment and host-specific files.
+    /// @param environment Applies the environment variables of @p system, see Options::environment.
     /// @throws std::runtime_error if any of the configuration files cannot be loaded or parsed successfully.
-    void _loadFolder (const std::filesystem::path &folderName, const System &system);
+    void _loadFolder (const std::filesystem::path &folderName, const System &system, bool environment);
 };
 
 }
@@ -0,0 +1,235 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#ifndef __CPP_CONFIG_KEY_H__
+#define __CPP_CONFIG_KEY_H__
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <cppconfig/json_object.h>
+
+
+namespace cppconfig {
+
+/// @brief A key split into its members and array positions at compile time, with the hash of
+/// every member key. It is a structural type, so it can be a template argument: see the
+/// _key literal and Config::get.
+/// @tparam N The size of the key, including the terminating null character.
+/// @tparam M The number of steps of the key.
+template<size_t N, size_t M>
+struct Key {
+  /// @brief A step of the key.
+  struct Segment {
+    size_t begin { 0 }; ///< Position of the member key in keys.
+    size_t size { 0 }; ///< Length of the member key.
+    size_t index { 0 }; ///< Position of an item.
+    uint32_t hash { 0 }; ///< Hash of the member key, see json::JsonObject::hash.
+    bool item { false }; ///< True for an array item, false for a member.
+  };
+
+  char chars[N] {}; ///< The key.
+  char keys[N] {}; ///< The member keys, without escape characters, one after the other.
+  Segment segments[M] {}; ///< Steps of the key.
+
+  /// @brief Gets the key.
+  constexpr std::string_view str() const { return { chars, N - 1 }; }
+
+  /// @brief Gets the member key of a step.
+  constexpr std::string_view key (size_t i) const { return { keys + segments[i].begin, segments[i].size }; }
+};
+
+/// @brief A string literal used as a template argument, which is checked and split into a Key.
+/// @tparam N The size of the literal, including the terminating null character.
+template<size_t N>
+struct KeyString {
+  char chars[N] {}; ///< The literal.
+
+  consteval KeyString (const char (&str)[N]) {
+    for (size_t i { 0 }; i < N; ++i)
+      chars[i] = str[i];
+  }
+
+  /// @brief Gets the literal.
+  constexpr std::string_view view() const { return { chars, N - 1 }; }
+
+  /// @brief Checks the syntax of the key, as get() reads it, and counts its steps.
+  /// @return The number of steps.
+  consteval size_t count() const {
+    return _scan ([] (size_t, size_t, bool, size_t) {});
+  }
+
+  /// @brief Splits the key.
+  /// @tparam M The number of steps, as returned by count().
+  template<size_t M>
+  consteval Key<N, M> split() const {
+    Key<N, M> key {};
+    size_t step { 0 };
+    size_t pos { 0 };
+
+    for (size_t i { 0 }; i < N; ++i)
+      key.chars[i] = chars[i];
+
+    _scan ([&] (size_t begin, size_t end, bool item, size_t index) {
+      auto &segment { key.segments[step++] };
+
+      if (item) {
+        segment.item = true;
+        segment.index = index;
+        return;
+      }
+
+      segment.begin = pos;
+      for (size_t i { begin }; i < end; ++i) {
+        if ((chars[i] == '\\') && (i + 1 < end) && (chars[i + 1] == '.'))
+          ++i;
+        key.keys[pos++] = chars[i];
+      }
+
+      segment.size = pos - segment.begin;
+      segment.hash = json::JsonObject::hash (key.key (step - 1));
+    });
+
+    return key;
+  }
+
+  private:
+    // ------------------------------------------------------------------------
+    // _scan
+    //
+    // Calls @p onSegment with the bounds of every step: a member key, which may
+    // contain escaped dots, or the digits of an array position. Any key that
+    // get() would not read as written stops the compilation.
+    // ------------------------------------------------------------------------
+    template<typename F>
+    consteval size_t _scan (F &&onSegment) const {
+      const auto sv { view() };
+      size_t count { 0 };
+
+      if (sv.empty())
+        throw std::invalid_argument { "malformed key: the key is empty" };
+
+      for (size_t i { 0 }; i < sv.size();) {
+        if (sv[i] == '[') {
+          size_t index { 0 };
+          size_t end { i + 1 };
+          for (; (end < sv.size()) && (sv[end] >= '0') && (sv[end] <= '9'); ++end)
+            index = index * 10 + static_cast<size_t> (sv[end] - '0');
+
+          if ((end == i + 1) || (end == sv.size()) || (sv[end] != ']'))
+            throw std::invalid_argument { "malformed key: an array position must be a number between brackets" };
+
+          onSegment (i + 1, end, true, index);
+          ++count;
+          i = end + 1;
+          continue;
+        }
+
+        if (count > 0) {
+          if (sv[i] != '.')
+            throw std::invalid_argument { "malformed key: a step must be followed by '.', '[' or the end of the key" };
+          ++i;
+        }
+
+        size_t end { i };
+        while ((end < sv.size()) && (sv[end] != '.') && (sv[end] != '[') && (sv[end] != ']')) {
+          if ((sv[end] == '\\') && (end + 1 < sv.size()) && (sv[end + 1] == '.'))
+            ++end;
+          ++end;
+        }
+
+        if (end == i)
+          throw std::invalid_argument { "malformed key: a member key is empty" };
+
+        onSegment (i, end, false, 0);
+        ++count;
+        i = end;
+      }
+
+      return count;
+    }
+};
+
+/// @brief Splits a key such as "a.b[2].c" into its steps at run time, calling @p onKey with each
+/// member key and @p onIndex with each array position. Dots in member keys are escaped with a
+/// backslash. The keys are passed as views of @p sv, so nothing is allocated unless a long key has
+/// escaped dots.
+/// @param sv The key.
+/// @param onKey Called with a std::string_view for every member; returns false to stop.
+/// @param onIndex Called with a size_t for every item; returns false to stop.
+/// @return False if a callback stopped the split or a position is not a number.
+template<typename OnKey, typename OnIndex>
+bool splitKey (std::string_view sv, OnKey &&onKey, OnIndex &&onIndex) {
+  std::string unescaped {};
+
+  for (size_t i { 0 }; i < sv.size();) {
+    if ((sv[i] == '.') || (sv[i] == ']')) {
+      ++i;
+    }
+    else if (sv[i] == '[') {
+      size_t index { 0 };
+      for (++i; (i < sv.size()) && (sv[i] != ']'); ++i) {
+        if ((sv[i] < '0') || (sv[i] > '9'))
+          return false;
+        index = index * 10 + static_cast<size_t> (sv[i] - '0');
+      }
+
+      if (!onIndex (index))
+        return false;
+    }
+    else {
+      bool escaped { false };
+      size_t end { i };
+      while ((end < sv.size()) && (sv[end] != '.') && (sv[end] != '[') && (sv[end] != ']')) {
+        if ((sv[end] == '\\') && (sv.size() > end + 1) && (sv[end + 1] == '.')) {
+          escaped = true;
+          ++end;
+        }
+        ++end;
+      }
+
+      auto key { sv.substr (i, end - i) };
+      if (escaped) {
+        unescaped.clear();
+        for (size_t j { 0 }; j < key.size(); ++j) {
+          if ((key[j] == '\\') && (key.size() > j + 1) && (key[j + 1] == '.'))
+            ++j;
+          unescaped.push_back (key[j]);
+        }
+        key = unescaped;
+      }
+
+      if (!onKey (key))
+        return false;
+
+      i = end;
+    }
+  }
+
+  return true;
+}
+
+/// @brief Checks if a member key can be written in a path that splitKey() reads back as the same
+/// key: it is not empty, has no brackets and does not end with a backslash.
+/// @param key The member key.
+inline bool addressable (std::string_view key) {
+  return !key.empty() && (key.back() != '\\') && (key.find_first_of ("[]") == std::string_view::npos);
+}
+
+namespace literals {
+
+/// @brief Checks and splits a key at compile time, e.g. "database.port"_key. A malformed key,
+/// such as "a[3", does not compile.
+template<KeyString S>
+consteval auto operator""_key() {
+  return S.template split<S.count()>();
+}
+
+}
+
+}
+
+#endif
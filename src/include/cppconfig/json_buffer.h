@@ -9,6 +9,9 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
+
+#include <cppconfig/simd_util.h>
 
 
 namespace cppconfig::json {
@@ -19,19 +22,35 @@ namespace cppconfig::json {
 /// reading the next character, checking if the end of the data has been reached, matching a sequence of characters,
 /// extracting a substring, counting characters based on a condition, moving forward in the buffer, and retrieving the current
 /// position in terms of line and column.
+///
+/// The line and column can be tracked eagerly, updating them with every character read, or lazily, where reading only
+/// advances the current index and the position is computed from the consumed data when it is requested.
 class Buffer {
   public:
+    /// @brief Modes used to track the line and column of the current position.
+    enum class Tracking {
+      kEager, ///< Line and column are updated with every character read.
+      kLazy   ///< Line and column are computed on request by counting the new lines consumed.
+    };
+
     /// @brief Constructs a buffer from a unique pointer to a character array and its length.
     /// @param d Unique pointer to the character data.
     /// @param len Length of the character data.
-    Buffer (std::unique_ptr<char []> &&d, size_t len): _data { std::move (d) }, _ptr { _data.get() }, _size { len } {
+    /// @param tracking The mode used to track the line and column.
+    Buffer (std::unique_ptr<char []> &&d, size_t len, Tracking tracking = Tracking::kEager):
+      _data { std::move (d) },
+      _ptr { _data.get() },
+      _size { len },
+      _tracking { tracking }
+    {
       // empty
     }
 
     /// @brief Constructs a buffer from a raw pointer to a character array and its length.
     /// @param d Pointer to the character data.
     /// @param len Length of the character data.
-    Buffer (const char *d, size_t len): _ptr { d }, _size { len } {
+    /// @param tracking The mode used to track the line and column.
+    Buffer (const char *d, size_t len, Tracking tracking = Tracking::kEager): _ptr { d }, _size { len }, _tracking { tracking } {
       // empty
     }
 
@@ -39,12 +58,14 @@ class Buffer {
     /// @return The next character.
     inline char next() {
       const auto c { _ptr[_idx++] };
-      if (c == '\n') {
-        ++_line;
-        _col = 0;
-      }
-      else {
-        ++_col;
+      if (_tracking == Tracking::kEager) {
+        if (c == '\n') {
+          ++_line;
+          _col = 0;
+        }
+        else {
+          ++_col;
+        }
       }
 
       return c;
@@ -61,7 +82,7 @@ class Buffer {
     /// @param count Number of characters to match.
     /// @return True if the sequence matches, false otherwise.
     inline bool match (const char *mem, size_t count) const {
-      if (_idx + count < _size)
+      if (_idx + count <= _size)
         return std::memcmp (_ptr + _idx, mem, count) == 0;
 
       return false;
@@ -95,17 +116,62 @@ class Buffer {
     /// @brief Advances the current position by a given length.
     /// @param len Number of characters to move forward.
     inline void forward (size_t len) {
-      _col += len;
+      if (_tracking == Tracking::kEager) {
+        const std::string_view skipped { _ptr + _idx, len };
+        if (const auto nl { skipped.rfind ('\n') }; nl != std::string_view::npos) {
+          _line += util::SimdUtil::count (skipped.data(), nl + 1, '\n');
+          _col = len - nl - 1;
+        }
+        else {
+          _col += len;
+        }
+      }
       _idx += len;
     }
 
+    /// @brief Moves the current position to the given offset.
+    /// The buffer switches to lazy tracking since the characters skipped are not inspected.
+    /// @param idx The new offset.
+    inline void seek (size_t idx) {
+      _tracking = Tracking::kLazy;
+      _idx = idx;
+    }
+
+    /// @brief Retrieves the mode used to track the line and column.
+    /// @return The tracking mode.
+    inline Tracking tracking() const { return _tracking; }
+
     /// @brief Retrieves the current line number.
+    /// In lazy mode the new lines consumed so far are counted with vector instructions.
     /// @return The current line number.
-    inline size_t line() const { return _line; }
+    inline size_t line() const {
+      if (_tracking == Tracking::kEager)
+        return _line;
+
+      return util::SimdUtil::count (_ptr, _idx, '\n');
+    }
 
     /// @brief Retrieves the current column number.
     /// @return The current column number.
-    inline size_t column() const { return _col; }
+    inline size_t column() const {
+      if (_tracking == Tracking::kEager)
+        return _col;
+
+      const auto nl { std::string_view { _ptr, _idx }.rfind ('\n') };
+      return (nl == std::string_view::npos) ? _idx : _idx - nl - 1;
+    }
+
+    /// @brief Gets the offset of the current character.
+    /// @return The offset of the current character.
+    inline size_t offset() const { return _idx; }
+
+    /// @brief Gets a pointer to the beginning of the character data.
+    /// @return Pointer to the beginning of the data.
+    inline const char * begin() const { return _ptr; }
+
+    /// @brief Gets the size of the character data.
+    /// @return The size of the data.
+    inline size_t size() const { return _size; }
 
     /// @brief Gets a pointer to the current character.
     /// @return Pointer to the current character.
@@ -120,8 +186,9 @@ class Buffer {
     const char *_ptr { nullptr };  // Raw pointer to the current position in the character data.
     size_t _size { 0 }; // Size of the character data.
     size_t _idx { 0 }; // Current index in the character data.
-    size_t _line { 0 }; // Current line number in the buffer.
-    size_t _col { 0 }; // Current column number in the buffer.
+    size_t _line { 0 }; // Current line number in the buffer (eager tracking only).
+    size_t _col { 0 }; // Current column number in the buffer (eager tracking only).
+    Tracking _tracking { Tracking::kEager }; // Mode used to track the line and column.
 };
 
 }
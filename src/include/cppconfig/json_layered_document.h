@@ -0,0 +1,105 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#ifndef __CPP_CONFIG_JSON_LAYERED_DOCUMENT_H__
+#define __CPP_CONFIG_JSON_LAYERED_DOCUMENT_H__
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <cppconfig/json_value.h>
+
+
+namespace cppconfig::json {
+
+/// @brief Stack of parsed JSON documents that are combined when they are looked up.
+///
+/// Every layer is kept as a separate JsonValue tree: the values of a layer take precedence over
+/// the ones of the layers below it, following the rules of JsonValue::merge, but nothing is merged
+/// when a layer is added. A lookup follows its path through all the layers at the same time, and
+/// only a container present in several layers is combined, the first time it is requested. A
+/// value whose type differs from the one below replaces it.
+///
+/// Layers have a name, so one of them can be replaced without touching the others: the cost is
+/// the one of building the new layer.
+///
+/// Lookups can be made from several threads at the same time, but not while the layers change.
+class LayeredDocument {
+  public:
+    /// @brief Position of a value in every layer of a document.
+    class Cursor {
+      public:
+        /// @brief Looks up a member of an object.
+        /// @param key The key.
+        /// @return The member, or nullopt if the value is not an object or has no such key.
+        std::optional<Cursor> find (std::string_view key) const;
+
+        /// @brief Gets an item of an array. The arrays of several layers are concatenated.
+        /// @param n The position of the item.
+        /// @return The item, or nullopt if the value is not an array or is too short.
+        std::optional<Cursor> at (size_t n) const;
+
+      private:
+        friend class LayeredDocument;
+
+        Cursor (const LayeredDocument *doc, std::vector<const JsonValue *> &&values): _doc { doc }, _values { std::move (values) } {
+          // empty
+        }
+
+        const LayeredDocument *_doc; ///< The document.
+        std::vector<const JsonValue *> _values; ///< Value in each layer, nullptr if it is not there.
+    };
+
+    LayeredDocument();
+    LayeredDocument (LayeredDocument &&) noexcept;
+    LayeredDocument & operator= (LayeredDocument &&) noexcept;
+    ~LayeredDocument();
+
+    /// @brief Gets the number of layers.
+    inline size_t size() const { return _layers.size(); }
+
+    /// @brief Gets the root value. The document must have one layer at least.
+    Cursor root() const;
+
+    /// @brief Gets the JsonValue of a position. A container present in several layers is merged
+    /// the first time it is requested.
+    /// @param cursor The position.
+    /// @return The value. It is valid until the layers change.
+    const JsonValue & value (const Cursor &cursor) const;
+
+    /// @brief Sets a layer.
+    /// @param name The name of the layer. A layer with the same name is replaced and keeps its
+    /// precedence, otherwise the new layer takes precedence over all the others.
+    /// @param value The root of the layer.
+    /// @param arrays How the arrays of the layer are combined with the ones below.
+    void set (std::string_view name, JsonValue &&value, JsonValue::Arrays arrays = JsonValue::Arrays::kAppend);
+
+    /// @brief Removes a layer.
+    /// @param name The name of the layer.
+    /// @return True if there was a layer with that name.
+    bool remove (std::string_view name);
+
+  private:
+    /// @brief A named document.
+    struct Layer {
+      std::string name; ///< Name of the layer.
+      JsonValue value; ///< Root of the layer.
+      JsonValue::Arrays arrays; ///< How its arrays are combined with the ones below.
+    };
+
+    struct Cache;
+
+    std::vector<Layer> _layers {}; ///< Layers, the one with the highest precedence last.
+    std::unique_ptr<Cache> _cache; ///< Merged containers.
+
+    /// @brief Keeps the layers whose values are combined for a position, as JsonValue::merge would.
+    std::vector<const JsonValue *> _fold (std::vector<const JsonValue *> &&values) const;
+};
+
+}
+
+#endif
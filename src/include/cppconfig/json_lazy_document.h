@@ -0,0 +1,123 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#ifndef __CPP_CONFIG_JSON_LAZY_DOCUMENT_H__
+#define __CPP_CONFIG_JSON_LAZY_DOCUMENT_H__
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <cppconfig/json_value.h>
+
+
+namespace cppconfig::json {
+
+class JsonParser;
+
+/// @brief JSON document that is parsed on demand.
+///
+/// When it is loaded the input is only validated and the boundaries of its objects and arrays are
+/// recorded. Lookups scan the members of the containers along the requested path, jumping over
+/// sibling subtrees with the recorded boundaries, and only the requested value is turned into a
+/// JsonValue. Scanned containers and built values are memoized, so every part of the input is
+/// visited at most once after loading. The input must outlive the document.
+///
+/// A document can hold several layers, as the files of a configuration folder: the values of a
+/// layer take precedence over the ones of the layers below it, following the rules of
+/// JsonValue::merge. A value whose type differs from the one below replaces it.
+///
+/// Lookups can be made from several threads at the same time.
+class LazyDocument {
+  public:
+    /// @brief Position of a value in every layer of a document.
+    class Cursor {
+      public:
+        /// @brief Looks up a member of an object.
+        /// @param key The key.
+        /// @return The member, or nullopt if the value is not an object or has no such key.
+        std::optional<Cursor> find (std::string_view key) const;
+
+        /// @brief Gets an item of an array. The arrays of several layers are concatenated.
+        /// @param n The position of the item.
+        /// @return The item, or nullopt if the value is not an array or is too short.
+        std::optional<Cursor> at (size_t n) const;
+
+      private:
+        friend class LazyDocument;
+
+        Cursor (const LazyDocument *doc, std::vector<size_t> &&offsets): _doc { doc }, _offsets { std::move (offsets) } {
+          // empty
+        }
+
+        const LazyDocument *_doc; ///< The document.
+        std::vector<size_t> _offsets; ///< Offset of the value in each layer, kNone if it is not there.
+    };
+
+    LazyDocument (LazyDocument &&) noexcept;
+    LazyDocument & operator= (LazyDocument &&) noexcept;
+    ~LazyDocument();
+
+    /// @brief Gets the root value.
+    Cursor root() const;
+
+    /// @brief Gets the JsonValue of a position, parsing it the first time it is requested.
+    /// @param cursor The position.
+    /// @return The value. It is valid as long as the document.
+    const JsonValue & value (const Cursor &cursor) const;
+
+    /// @brief Puts the layers of another document on top of the ones of this document.
+    /// @param doc The document whose values take precedence.
+    /// @param arrays How the arrays of @p doc are combined with the ones below.
+    void overlay (LazyDocument &&doc, JsonValue::Arrays arrays = JsonValue::Arrays::kAppend);
+
+  private:
+    friend class JsonParser;
+
+    static constexpr size_t kNone { std::numeric_limits<size_t>::max() };
+
+    /// @brief Offsets of the brackets of an object or an array.
+    struct Container {
+      size_t begin; ///< Offset of '{' or '['.
+      size_t end; ///< Offset of the matching '}' or ']'.
+    };
+
+    /// @brief One input and the boundaries of its containers, sorted by their beginning.
+    struct Layer {
+      std::string_view data {};
+      std::vector<Container> containers {};
+      JsonValue::Arrays arrays { JsonValue::Arrays::kAppend }; ///< How its arrays are combined with the ones below.
+    };
+
+    struct Members;
+    struct Cache;
+
+    std::vector<Layer> _layers {}; ///< Layers, the one with the highest precedence last.
+    std::unique_ptr<Cache> _cache; ///< Parser settings and memoized lookups.
+
+    /// @brief Constructs a document with one layer.
+    LazyDocument (const JsonParser &parser, Layer &&layer);
+
+    /// @brief Keeps the layers whose values are combined for a position, as JsonValue::merge would.
+    std::vector<size_t> _fold (std::vector<size_t> &&offsets) const;
+
+    /// @brief Gets the members of the container at @p offset of a layer, scanning it the first time.
+    const Members & _members (size_t layer, size_t offset) const;
+
+    /// @brief Gets the offset of the bracket that closes the container at @p offset of a layer.
+    size_t _end (size_t layer, size_t offset) const;
+
+    /// @brief Gets the offset that follows the value at @p offset of a layer.
+    size_t _skip (size_t layer, size_t offset) const;
+
+    /// @brief Builds the JsonValue of the value at @p offset of a layer.
+    JsonValue _parse (size_t layer, size_t offset) const;
+};
+
+}
+
+#endif
@@ -0,0 +1,261 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#ifndef __CPP_CONFIG_JSON_OBJECT_H__
+#define __CPP_CONFIG_JSON_OBJECT_H__
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cppconfig/json_value.h>
+
+
+namespace cppconfig::json {
+
+/// @brief Members of a JSON object, in insertion order.
+///
+/// The members are stored in one contiguous vector. Small objects, the vast majority in
+/// configuration files, are searched linearly. Once an object has more than kIndexThreshold
+/// members, an open-addressing index in the style of a Swiss table is built next to the vector:
+/// a control array holds a 7-bit tag of the hash of each key (or 0x80 for an empty slot) and is
+/// probed 8 slots at a time, so most of the keys that do not match are rejected without being
+/// compared. The control array and the positions of the members live in one allocation.
+///
+/// The hashes of the keys are kept in a second vector, parallel to the members, so a lookup hashes
+/// its key once and most of the keys that do not match, in small objects too, are told apart by
+/// scanning the hashes alone.
+///
+/// Keys are unique: inserting a key that is already present keeps the existing member. The
+/// keys must not be modified through the iterators.
+class JsonObject {
+  public:
+    using key_type = std::pmr::string;
+    using mapped_type = JsonValue;
+    using value_type = std::pair<std::pmr::string, JsonValue>;
+    using allocator_type = std::pmr::polymorphic_allocator<value_type>;
+    using size_type = size_t;
+    using iterator = std::pmr::vector<value_type>::iterator;
+    using const_iterator = std::pmr::vector<value_type>::const_iterator;
+
+    /// @brief Number of members above which the index is built.
+    static constexpr size_t kIndexThreshold { 8 };
+
+    /// @brief Constructs an empty object that allocates from the default resource.
+    JsonObject();
+
+    /// @brief Constructs an empty object.
+    /// @param alloc The allocator of the members and the index.
+    explicit JsonObject (const allocator_type &alloc);
+
+    /// @brief Copy constructor.
+    /// @param obj The object to be copied.
+    /// @param alloc The allocator of the copy, the default resource if it is not given.
+    JsonObject (const JsonObject &obj, const allocator_type &alloc = {});
+
+    /// @brief Move constructor. The object keeps the allocator of @p obj.
+    /// @param obj The object to be moved.
+    JsonObject (JsonObject &&obj) noexcept;
+
+    /// @brief Move constructor with a different allocator: the members are moved one by one if
+    /// the resources differ.
+    /// @param obj The object to be moved.
+    /// @param alloc The allocator of the new object.
+    JsonObject (JsonObject &&obj, const allocator_type &alloc);
+
+    JsonObject & operator= (const JsonObject &obj);
+    JsonObject & operator= (JsonObject &&obj);
+    ~JsonObject();
+
+    /// @brief Gets the allocator of the members.
+    inline allocator_type get_allocator() const noexcept { return _members.get_allocator(); }
+
+    inline iterator begin() noexcept { return _members.begin(); }
+    inline iterator end() noexcept { return _members.end(); }
+    inline const_iterator begin() const noexcept { return _members.begin(); }
+    inline const_iterator end() const noexcept { return _members.end(); }
+
+    /// @brief Gets the number of members.
+    inline size_t size() const noexcept { return _members.size(); }
+
+    /// @brief Checks if the object has no members.
+    inline bool empty() const noexcept { return _members.empty(); }
+
+    /// @brief Hashes a key, as the object does to store and look up its members. The key is read
+    /// 8 bytes at a time, and the result is the same at compile time and at runtime, so the
+    /// hashes of constant keys can be computed by the compiler.
+    /// @param key The key.
+    /// @return The hash.
+    static constexpr uint32_t hash (std::string_view key) {
+      constexpr uint64_t kMul { 0x9e3779b97f4a7c15 };
+
+      uint64_t h { key.size() * kMul };
+      size_t i { 0 };
+
+      for (; i + 8 <= key.size(); i += 8)
+        h = (h ^ _load (key.data() + i, 8)) * kMul;
+
+      if (i < key.size())
+        h = (h ^ _load (key.data() + i, key.size() - i)) * kMul;
+
+      // the low bits pick the slot and the tag of a member: fold in the high ones
+      h ^= h >> 29;
+      h *= 0xbf58476d1ce4e5b9;
+      h ^= h >> 32;
+
+      return static_cast<uint32_t> (h);
+    }
+
+    /// @brief Looks up a member.
+    /// @param key The key.
+    /// @return The member, or end() if there is no such key.
+    inline iterator find (std::string_view key) { return find (key, hash (key)); }
+
+    /// @brief Looks up a member.
+    /// @param key The key.
+    /// @return The member, or end() if there is no such key.
+    inline const_iterator find (std::string_view key) const { return find (key, hash (key)); }
+
+    /// @brief Looks up a member whose key has already been hashed.
+    /// @param key The key.
+    /// @param h The hash of the key, as returned by hash().
+    /// @return The member, or end() if there is no such key.
+    inline iterator find (std::string_view key, uint32_t h) {
+      return _members.begin() + static_cast<std::ptrdiff_t> (_find (key, h));
+    }
+
+    /// @brief Looks up a member whose key has already been hashed.
+    /// @param key The key.
+    /// @param h The hash of the key, as returned by hash().
+    /// @return The member, or end() if there is no such key.
+    inline const_iterator find (std::string_view key, uint32_t h) const {
+      return _members.begin() + static_cast<std::ptrdiff_t> (_find (key, h));
+    }
+
+    /// @brief Checks if a member exists.
+    inline bool contains (std::string_view key) const { return find (key) != end(); }
+
+    /// @brief Inserts a member if its key is not present yet.
+    /// @param key The key.
+    /// @param value The value, which is only moved if the member is inserted.
+    /// @return The member with that key, and true if it was inserted.
+    std::pair<iterator, bool> try_emplace (std::pmr::string &&key, JsonValue &&value);
+
+    /// @brief Inserts a copy of a member if its key is not present yet.
+    /// @param key The key.
+    /// @param value The value.
+    /// @return The member with that key, and true if it was inserted.
+    std::pair<iterator, bool> emplace (std::string_view key, const JsonValue &value);
+
+    /// @brief Inserts a member if its key is not present yet.
+    /// @param key The key.
+    /// @param value The value, which is only moved if the member is inserted.
+    /// @return The member with that key, and true if it was inserted.
+    inline std::pair<iterator, bool> emplace (std::pmr::string &&key, JsonValue &&value) {
+      return try_emplace (std::move (key), std::move (value));
+    }
+
+    /// @brief Reserves room for a number of members.
+    void reserve (size_t n);
+
+  private:
+    static constexpr uint8_t kEmpty { 0x80 }; ///< Control byte of an empty slot.
+    static constexpr size_t kGroup { 8 }; ///< Number of slots probed at a time.
+
+    std::pmr::vector<value_type> _members; ///< Members, in insertion order.
+    std::pmr::vector<uint32_t> _hashes; ///< Hash of the key of each member.
+
+    /// @brief Index of the members, empty for small objects. It holds the control byte of each
+    /// slot (a hash tag, or kEmpty) followed by the position in _members of the member of each slot.
+    std::pmr::vector<uint32_t> _index;
+
+    /// @brief Gets the number of slots of the index.
+    inline size_t _capacity() const { return _index.size() / 5 * 4; }
+
+    /// @brief Gets the control bytes of the index.
+    inline const uint8_t * _ctrl() const { return reinterpret_cast<const uint8_t *> (_index.data()); }
+    inline uint8_t * _ctrl() { return reinterpret_cast<uint8_t *> (_index.data()); }
+
+    /// @brief Gets the member positions of the index.
+    inline const uint32_t * _slots() const { return _index.data() + _capacity() / 4; }
+    inline uint32_t * _slots() { return _index.data() + _capacity() / 4; }
+
+    /// @brief Reads up to 8 bytes of a key as a little-endian word.
+    static constexpr uint64_t _load (const char *chars, size_t n) {
+      uint64_t word { 0 };
+
+      if (!std::is_constant_evaluated() && (n == 8) && (std::endian::native == std::endian::little)) {
+        std::memcpy (&word, chars, 8);
+        return word;
+      }
+
+      for (size_t i { 0 }; i < n; ++i)
+        word |= static_cast<uint64_t> (static_cast<uint8_t> (chars[i])) << (8 * i);
+
+      return word;
+    }
+
+    /// @brief Finds the position of a member.
+    /// @return The position, or size() if there is no such key.
+    size_t _find (std::string_view key, uint32_t h) const;
+
+    /// @brief Adds the member at position @p idx to the index.
+    void _insert (size_t idx);
+
+    /// @brief Records the hash of the last member and adds it to the index, building or growing
+    /// the index if needed.
+    void _insertLast (uint32_t h);
+
+    /// @brief Rebuilds the index with room for @p n members.
+    void _rehash (size_t n);
+};
+
+// ----------------------------------------------------------------------------
+// JsonValue members that need a complete JsonObject
+// ----------------------------------------------------------------------------
+inline bool JsonValue::exists (std::string_view k) const {
+  return find (k) != nullptr;
+}
+
+inline const JsonValue * JsonValue::find (std::string_view k) const {
+  if (!isObject())
+    return nullptr;
+
+  const auto it { _value.object->find (k) };
+  return (it != _value.object->end())? &it->second : nullptr;
+}
+
+inline JsonValue * JsonValue::find (std::string_view k) {
+  return const_cast<JsonValue *> (std::as_const (*this).find (k));
+}
+
+inline JsonValue & JsonValue::operator[] (std::string_view k) {
+  assert (isObject());
+  return _value.object->find (k)->second;
+}
+
+inline const JsonValue & JsonValue::operator[] (std::string_view k) const {
+  assert (isObject());
+  return _value.object->find (k)->second;
+}
+
+inline void JsonValue::_setObject() {
+  _value.object = std::pmr::polymorphic_allocator<> {}.new_object<Object>();
+  _tag = Tag::kObject;
+}
+
+inline void JsonValue::_setObject (Object &&map) {
+  _value.object = std::pmr::polymorphic_allocator<> { map.get_allocator() }.new_object<Object> (std::move (map));
+  _tag = Tag::kObject;
+}
+
+}
+
+#endif
@@ -5,11 +5,15 @@
 // ----------------------------------------------------------------------------
 #ifndef __CPP_CONFIG_JSON_PARSER_H__
 #define __CPP_CONFIG_JSON_PARSER_H__
+#include <cstring>
 #include <filesystem>
 #include <optional>
 #include <map>
+#include <memory_resource>
 #include <sstream>
 
+#include <cppconfig/json_lazy_document.h>
+#include <cppconfig/json_tape.h>
 #include <cppconfig/json_tokenizer.h>
 #include <cppconfig/json_value.h>
 
@@ -28,6 +32,7 @@ class JsonParser {
       kExpectPair,            //!< Expected key in a key-value pair.
       kExpectCommaOrEndObj,   //!< Expected ',' or '}'
       kExpectCommaOrEndArray, //!< Expected ',' or ']'
+      kMaxDepth,              //!< Containers nested deeper than Options::maxDepth
     };
 
     /// @brief Structure representing an error during JSON parsing.
@@ -65,6 +70,7 @@ class JsonParser {
           case ErrorCode::kExpectPair: return "expected key";
           case ErrorCode::kExpectCommaOrEndObj: return "expected ',' or '}'";
           case ErrorCode::kExpectCommaOrEndArray: return "expected ',' or ']'";
+          case ErrorCode::kMaxDepth: return "maximum nesting depth exceeded";
           default: return "unknown";
         }
 
@@ -72,37 +78,295 @@ class JsonParser {
       }
     };
 
+    /// @brief Parser settings.
+    struct Options {
+      JsonTokenizer::Options tokenizer {}; ///< Settings of the tokenizer used to split the input.
+      size_t maxDepth { 1024 }; ///< Maximum number of nested objects and arrays, the root included.
+      /// Memory of the values built by parse(): containers, keys and the strings that are not borrowed
+      /// from the input. It must outlive the values. Null uses the default resource.
+      std::pmr::memory_resource *resource { nullptr };
+    };
+
+    /// @brief Constructs a parser with the default settings.
+    JsonParser() = default;
+
+    /// @brief Constructs a parser with the given settings.
+    /// @param options The parser settings.
+    explicit JsonParser (const Options &options): _options { options } {
+      // empty
+    }
+
     /// @brief Parse JSON data from a buffer.
     /// @param buffer Pointer to the buffer containing JSON data.
     /// @param size Size of the buffer.
     /// @return Optional containing the parsed JSON value if successful, otherwise nullopt.
     std::optional<JsonValue> parse (const char *buffer, size_t size=0);
 
+    /// @brief Parse JSON data from a buffer, reporting every value to a handler instead of building a JsonValue.
+    ///
+    /// The handler is called as the values are read, in document order. It only needs to define the events
+    /// it is interested in, the other ones are skipped at compile time:
+    ///  @li onObjectBegin(), onArrayBegin(): a container begins.
+    ///  @li onEnd(): the innermost container ends.
+    ///  @li onKey (std::string_view): key of the next member of an object.
+    ///  @li onString (std::string_view), onInt (int64_t), onDouble (double), onBool (bool), onNull(): a value.
+    ///
+    /// Strings are decoded and reference either the buffer or a temporary, so they must be copied to be
+    /// kept after the call returns. onKey and onString can take a JsonToken&& instead of a std::string_view
+    /// to take ownership of the decoded string. The events received before an error are not undone.
+    /// @tparam Handler Type of the handler.
+    /// @param buffer Pointer to the buffer containing JSON data.
+    /// @param size Size of the buffer, or 0 if it is null-terminated.
+    /// @param handler The handler.
+    /// @return True if successful, otherwise false and error() describes the problem.
+    template<typename Handler>
+    bool parse (const char *buffer, size_t size, Handler &handler);
+
+    /// @brief Parse JSON data from a buffer into a tape instead of a JsonValue tree.
+    /// The strings are copied into the tape, so the buffer is not referenced once the function returns.
+    /// @param buffer Pointer to the buffer containing JSON data.
+    /// @param size Size of the buffer.
+    /// @return Optional containing the tape if successful, otherwise nullopt.
+    std::optional<Tape> parseTape (const char *buffer, size_t size=0);
+
+    /// @brief Validate JSON data and record the boundaries of its containers, to be parsed on demand.
+    /// @param buffer Pointer to the buffer containing JSON data. It must outlive the document.
+    /// @param size Size of the buffer.
+    /// @return Optional containing the document if the data is valid, otherwise nullopt.
+    std::optional<LazyDocument> parseLazy (const char *buffer, size_t size=0);
+
     /// @brief Get the last parsing error, if any.
     /// @return Reference to the last parsing error.
     inline const Error & error() const { return _error; }
 
+    /// @brief Get the parser settings.
+    /// @return Reference to the parser settings.
+    inline const Options & options() const { return _options; }
+
   private:
+    class TreeBuilder;
+    class TapeBuilder;
+    class IndexBuilder;
+
+    Options _options {}; // Parser settings
     std::unique_ptr<JsonTokenizer> _tokenizer; // Tokenizer object used for JSON parsing
     Error _error {}; // Last parsing error
+    std::vector<JsonTokenId> _stack {}; // Containers being parsed, the innermost last; reused between parses
+
+    /// @brief Parse a document with an explicit stack instead of recursion.
+    /// @tparam Handler Receives the values as they are parsed.
+    /// @param handler The handler.
+    /// @return True if successful.
+    template<typename Handler>
+    bool _parse (Handler &handler);
+
+    /// @brief Open a container, checking the maximum depth.
+    /// @return True if successful.
+    template<typename Handler>
+    bool _open (Handler &handler, JsonTokenId id);
+
+    /// @brief Report a scalar value to a handler.
+    template<typename Handler>
+    static void _value (Handler &handler, JsonToken &token);
 
-    /// @brief Parse a JSON object.
-    std::optional<JsonValue> _parseObject ();
-    /// @brief Parse a JSON array.
-    std::optional<JsonValue> _parseArray ();
+    /// @brief Report a key to a handler.
+    template<typename Handler>
+    static void _key (Handler &handler, JsonToken &token);
 
-    /// @brief Set the last parsing error and return nullopt.
+    /// @brief Set the last parsing error.
     /// @param code The ErrorCode indicating the type of error.
-    /// @return Nullopt.
-    inline std::optional<JsonValue> _setError (ErrorCode code) {
+    /// @return False.
+    inline bool _setError (ErrorCode code) {
       _error.code = code;
       _error.line = _tokenizer->line();
       _error.column = _tokenizer->column();
-      return std::nullopt;
+      return false;
     }
 
 };
 
+// ----------------------------------------------------------------------------
+// JsonParser::parse
+// ----------------------------------------------------------------------------
+template<typename Handler>
+inline bool JsonParser::parse (const char *data, size_t size, Handler &handler) {
+  if (size == 0) size = std::strlen(data);
+
+  // strings are only handed to the handler, so the tokens do not need their own copy
+  auto options { _options.tokenizer };
+  options.zeroCopy = true;
+
+  _tokenizer = std::make_unique<JsonTokenizer> (Buffer { data, size, Buffer::Tracking::kLazy }, options);
+
+  return _parse (handler);
+}
+
+// ----------------------------------------------------------------------------
+// JsonParser::_parse
+//
+// The grammar is checked as the former recursive descent parser did, so the same
+// errors are reported at the same positions: the key, the colon and the value of
+// a member are read before any of them is checked, and a comma may precede the
+// end of a container.
+// ----------------------------------------------------------------------------
+template<typename Handler>
+inline bool JsonParser::_parse (Handler &handler) {
+  _stack.clear();
+
+  auto token { _tokenizer->next() };
+  if (!token.has_value())
+    return _setError (ErrorCode::kExpectAny);
+
+  if (token->id() == JsonTokenId::kError)
+    return _setError (static_cast<ErrorCode> (_tokenizer->error()));
+  if ((token->id() != JsonTokenId::kObjectBegin) && (token->id() != JsonTokenId::kArrayBegin))
+    return _setError (ErrorCode::kExpectObject);
+
+  if (!_open (handler, token->id()))
+    return false;
+
+  bool item { true }; // true if a member or an item is expected, false if ',' or the end
+
+  do {
+    const bool object { _stack.back() == JsonTokenId::kObjectBegin };
+    bool close { false };
+
+    if (item) {
+      auto v { _tokenizer->next() }; // value, or key in objects
+
+      if (object) {
+        if (v.has_value() && (v->id() == JsonTokenId::kObjectEnd)) {
+          close = true;
+        }
+        else {
+          auto k { std::move (v) };
+          const auto c { _tokenizer->next() }; // colon
+          v = _tokenizer->next(); // value
+
+          if (
+            !k.has_value() || !c.has_value() || !v.has_value() ||
+            (k->id() != JsonTokenId::kValueString) ||
+            (c->id() != JsonTokenId::kColon)
+          ) {
+            return _setError (ErrorCode::kExpectPair);
+          }
+
+          _key (handler, k.value());
+        }
+      }
+      else if (!v.has_value()) {
+        return _setError (ErrorCode::kExpectAny);
+      }
+      else if (v->id() == JsonTokenId::kArrayEnd) {
+        close = true;
+      }
+
+      if (!close) {
+        switch (v->id()) {
+          case JsonTokenId::kValueInteger:
+          case JsonTokenId::kValueFloatPoint:
+          case JsonTokenId::kValueBoolean:
+          case JsonTokenId::kValueString:
+          case JsonTokenId::kValueNull:
+            _value (handler, v.value());
+            item = false;
+            break;
+          case JsonTokenId::kObjectBegin:
+          case JsonTokenId::kArrayBegin:
+            if (!_open (handler, v->id()))
+              return false;
+            break;
+          default:
+            return _setError (ErrorCode::kExpectAny);
+        }
+      }
+    }
+    else {
+      const auto n { _tokenizer->next() };
+
+      if (n.has_value() && (n->id() == JsonTokenId::kComma))
+        item = true;
+      else if (n.has_value() && (n->id() == (object ? JsonTokenId::kObjectEnd : JsonTokenId::kArrayEnd)))
+        close = true;
+      else
+        return _setError (object ? ErrorCode::kExpectCommaOrEndObj : ErrorCode::kExpectCommaOrEndArray);
+    }
+
+    if (close) {
+      if constexpr (requires { handler.onEnd(); })
+        handler.onEnd();
+      _stack.pop_back();
+      item = false;
+    }
+  }
+  while (!_stack.empty());
+
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+// JsonParser::_open
+// ----------------------------------------------------------------------------
+template<typename Handler>
+inline bool JsonParser::_open (Handler &handler, JsonTokenId id) {
+  if (_stack.size() >= _options.maxDepth)
+    return _setError (ErrorCode::kMaxDepth);
+
+  _stack.push_back (id);
+
+  if (id == JsonTokenId::kObjectBegin) {
+    if constexpr (requires { handler.onObjectBegin(); })
+      handler.onObjectBegin();
+  }
+  else {
+    if constexpr (requires { handler.onArrayBegin(); })
+      handler.onArrayBegin();
+  }
+
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+// JsonParser::_value
+// ----------------------------------------------------------------------------
+template<typename Handler>
+inline void JsonParser::_value (Handler &handler, JsonToken &token) {
+  switch (token.id()) {
+    case JsonTokenId::kValueInteger:
+      if constexpr (requires { handler.onInt (int64_t {}); })
+        handler.onInt (token.value<int64_t>());
+      break;
+    case JsonTokenId::kValueFloatPoint:
+      if constexpr (requires { handler.onDouble (double {}); })
+        handler.onDouble (token.value<double>());
+      break;
+    case JsonTokenId::kValueBoolean:
+      if constexpr (requires { handler.onBool (bool {}); })
+        handler.onBool (token.value<bool>());
+      break;
+    case JsonTokenId::kValueString:
+      if constexpr (requires (JsonToken &&t) { handler.onString (std::move (t)); })
+        handler.onString (std::move (token));
+      else if constexpr (requires { handler.onString (std::string_view {}); })
+        handler.onString (token.view());
+      break;
+    default:
+      if constexpr (requires { handler.onNull(); })
+        handler.onNull();
+  }
+}
+
+// ----------------------------------------------------------------------------
+// JsonParser::_key
+// ----------------------------------------------------------------------------
+template<typename Handler>
+inline void JsonParser::_key (Handler &handler, JsonToken &token) {
+  if constexpr (requires (JsonToken &&t) { handler.onKey (std::move (t)); })
+    handler.onKey (std::move (token));
+  else if constexpr (requires { handler.onKey (std::string_view {}); })
+    handler.onKey (token.view());
+}
+
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,62 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#ifndef __CPP_CONFIG_JSON_PATH_INDEX_H__
+#define __CPP_CONFIG_JSON_PATH_INDEX_H__
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <cppconfig/json_value.h>
+
+
+namespace cppconfig::json {
+
+/// @brief Hash table of the full path of every value of a JsonValue tree.
+///
+/// The paths are written as Config::get() reads them: member keys separated by dots, with their
+/// own dots escaped with a backslash, and array positions between brackets, e.g.
+/// "servers[3].host". All of them are stored one after the other in a single string, and the
+/// table is a flat array of slots probed linearly, so a lookup is one hash of the path and, most
+/// of the times, one key comparison, whatever the depth of the value.
+///
+/// Members whose key cannot be written in a path (see addressable()) are not indexed, nor is the
+/// root. The index holds pointers to the values: it is
+/// valid as long as the tree is not modified.
+class PathIndex {
+  public:
+    /// @brief Indexes a tree.
+    /// @param root The root of the tree.
+    explicit PathIndex (const JsonValue &root);
+
+    /// @brief Looks up a value.
+    /// @param path The full path of the value.
+    /// @return The value, or nullptr if the path is not indexed.
+    const JsonValue * find (std::string_view path) const;
+
+    /// @brief Gets the number of indexed values.
+    inline size_t size() const noexcept { return _size; }
+
+  private:
+    /// @brief A slot of the table.
+    struct Slot {
+      const JsonValue *value { nullptr }; ///< The value, nullptr for an empty slot.
+      size_t offset { 0 }; ///< Position of the path in _paths.
+      uint32_t length { 0 }; ///< Length of the path.
+      uint32_t hash { 0 }; ///< Hash of the path.
+    };
+
+    std::string _paths {}; ///< The paths, one after the other.
+    std::vector<Slot> _slots {}; ///< The table; its size is a power of 2.
+    size_t _size { 0 }; ///< Number of indexed values.
+
+    /// @brief Appends the paths of the values below @p value to _paths and records them in @p slots.
+    void _collect (const JsonValue &value, std::string &path, std::vector<Slot> &slots);
+};
+
+}
+
+#endif
@@ -0,0 +1,211 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#ifndef __CPP_CONFIG_JSON_PATH_TRIE_H__
+#define __CPP_CONFIG_JSON_PATH_TRIE_H__
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <cppconfig/json_value.h>
+
+
+namespace cppconfig::json {
+
+/// @brief Frozen trie of the paths of a JsonValue tree, for prefix scans, wildcard matches and
+/// longest-prefix lookups.
+///
+/// Every value is a node, the root included. The nodes are laid out in a single array in
+/// depth-first order, so the values below a node are the contiguous range that follows it, and a
+/// prefix scan is one lookup plus a walk over that range. Full paths, written as Config::get()
+/// reads them (e.g. "servers[3].host"), are stored one after the other in a single string and
+/// member keys are views of them when they have no escaped dots, so a result is a View: the
+/// position of a node, not a copy of its path or value.
+///
+/// The members left out of a PathIndex are left out of the trie too, with all their values, and
+/// the trie has the same lifetime: it is valid as long as the tree is not modified.
+class PathTrie {
+  private:
+    struct Node;
+
+  public:
+    /// @brief A node of the trie.
+    class View {
+      public:
+        /// @brief Gets the full path of the node, empty for the root.
+        std::string_view path() const noexcept;
+
+        /// @brief Gets the member key of the node, empty for items and the root.
+        std::string_view key() const noexcept;
+
+        /// @brief Checks if the node is an item of an array.
+        bool isItem() const noexcept;
+
+        /// @brief Gets the position of an item in its array, 0 for members.
+        size_t index() const noexcept;
+
+        /// @brief Gets the value of the node.
+        const JsonValue & value() const noexcept;
+
+        /// @brief Gets the number of values below the node.
+        size_t descendants() const noexcept;
+
+        bool operator== (const View &other) const noexcept = default;
+
+      private:
+        friend class PathTrie;
+
+        const PathTrie *_trie { nullptr };
+        uint32_t _node { 0 };
+
+        View (const PathTrie *trie, uint32_t node) noexcept : _trie { trie }, _node { node } {
+          // empty
+        }
+
+        const Node & _get() const noexcept { return _trie->_nodes[_node]; }
+    };
+
+    /// @brief A run of consecutive nodes in depth-first order, e.g. all the values below a node.
+    class Range {
+      public:
+        /// @brief Iterator over the views of a range.
+        class Iterator {
+          public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = View;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = View;
+
+            Iterator() = default;
+            View operator*() const noexcept { return View { _trie, _node }; }
+            Iterator & operator++() noexcept { ++_node; return *this; }
+            Iterator operator++ (int) noexcept { auto it { *this }; ++_node; return it; }
+            bool operator== (const Iterator &other) const noexcept = default;
+
+          private:
+            friend class Range;
+
+            const PathTrie *_trie { nullptr };
+            uint32_t _node { 0 };
+
+            Iterator (const PathTrie *trie, uint32_t node) noexcept : _trie { trie }, _node { node } {
+              // empty
+            }
+        };
+
+        Iterator begin() const noexcept { return Iterator { _trie, _begin }; }
+        Iterator end() const noexcept { return Iterator { _trie, _end }; }
+        size_t size() const noexcept { return _end - _begin; }
+        bool empty() const noexcept { return _begin == _end; }
+
+      private:
+        friend class PathTrie;
+
+        const PathTrie *_trie { nullptr };
+        uint32_t _begin { 0 };
+        uint32_t _end { 0 };
+
+        Range (const PathTrie *trie, uint32_t begin, uint32_t end) noexcept :
+          _trie { trie }, _begin { begin }, _end { end } {
+          // empty
+        }
+    };
+
+    /// @brief Builds the trie of a tree.
+    /// @param root The root of the tree.
+    explicit PathTrie (const JsonValue &root);
+
+    /// @brief Gets the root node.
+    View root() const noexcept { return View { this, 0 }; }
+
+    /// @brief Looks up a node.
+    /// @param path The full path of the node; empty for the root.
+    /// @return The node, or std::nullopt if there is no such path.
+    std::optional<View> find (std::string_view path) const;
+
+    /// @brief Gets all the values below a path, e.g. prefix("features") lists every feature and
+    /// everything inside them, in document order, without the "features" node itself.
+    /// @param path The full path of a node; empty for the whole tree.
+    /// @return The nodes below @p path; empty if there is no such path.
+    Range prefix (std::string_view path) const;
+
+    /// @brief Gets the children of a node.
+    /// @param path The full path of the node; empty for the root.
+    /// @return The members or items of the node, in document order.
+    std::vector<View> children (std::string_view path) const;
+
+    /// @brief Gets the nodes matching a pattern where a "*" step stands for any member or item,
+    /// e.g. "upstreams.*.timeout" or "servers[*].host".
+    /// @param pattern The pattern.
+    /// @return The matching nodes, in document order.
+    std::vector<View> match (std::string_view pattern) const;
+
+    /// @brief Gets the deepest node whose path is a prefix of @p path, e.g. the "features.beta"
+    /// node for "features.beta.rollout.percent" when beta is a boolean.
+    /// @param path A full path.
+    /// @return The node, the root if not even the first step of @p path exists.
+    View longestPrefix (std::string_view path) const;
+
+    /// @brief Gets the number of nodes, the root included.
+    inline size_t size() const noexcept { return _nodes.size(); }
+
+  private:
+    /// @brief A step of a path or a pattern.
+    struct Step {
+      std::string key {}; ///< The member key, without escape characters.
+      size_t index { 0 }; ///< Position of an item.
+      bool item { false }; ///< True for an item, false for a member.
+      bool any { false }; ///< True for a "*" step.
+    };
+
+    /// @brief A node of the trie.
+    struct Node {
+      const JsonValue *value { nullptr }; ///< The value.
+      uint32_t end { 0 }; ///< One past the last node below this one.
+      uint32_t offset { 0 }; ///< Position of the path in _paths.
+      uint32_t length { 0 }; ///< Length of the path.
+      uint32_t keyOffset { 0 }; ///< Position of the key, in _paths or in _keys when it is escaped.
+      uint32_t keyLength { 0 }; ///< Length of the key.
+      uint32_t hash { 0 }; ///< Hash of the key, see JsonObject::hash.
+      uint32_t index { 0 }; ///< Position of an item.
+      bool item { false }; ///< True for an item, false for a member.
+      bool escaped { false }; ///< True if the key is in _keys rather than in _paths.
+    };
+
+    std::vector<Node> _nodes {}; ///< The nodes in depth-first order.
+    std::string _paths {}; ///< The paths, one after the other.
+    std::string _keys {}; ///< The keys with dots, without escape characters.
+
+    /// @brief Appends the nodes below @p value.
+    void _collect (const JsonValue &value, std::string &path);
+
+    /// @brief Finds the member @p key of node @p parent.
+    /// @return The member, or 0 if there is none (0 is the root, never a child).
+    uint32_t _member (uint32_t parent, std::string_view key) const;
+
+    /// @brief Finds the item @p index of node @p parent.
+    /// @return The item, or 0 if there is none.
+    uint32_t _item (uint32_t parent, size_t index) const;
+
+    /// @brief Walks the steps of @p path as far as they exist.
+    /// @param node Set to the last node reached.
+    /// @return True if all the steps were found.
+    bool _walk (std::string_view path, uint32_t &node) const;
+
+    /// @brief Appends to @p views the nodes below @p node matching @p steps.
+    void _match (uint32_t node, std::span<const Step> steps, std::vector<View> &views) const;
+
+    /// @brief Splits a path or a pattern into its steps.
+    static bool _split (std::string_view path, std::vector<Step> &steps);
+};
+
+}
+
+#endif
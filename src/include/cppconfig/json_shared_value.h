@@ -0,0 +1,138 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#ifndef __CPP_CONFIG_JSON_SHARED_VALUE_H__
+#define __CPP_CONFIG_JSON_SHARED_VALUE_H__
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include <cppconfig/json_value.h>
+
+
+namespace cppconfig::json {
+
+/// @brief Immutable JSON value whose objects and arrays are shared between versions.
+///
+/// Scalars are stored inline, as in a JsonValue, while every object and array is a reference
+/// counted node that is never modified once it is built. Copying a SharedValue only takes a
+/// reference to its node, and set() makes a new version that reallocates the containers along
+/// the changed path and shares all the other ones with the previous version. Old and new versions
+/// can coexist cheaply, and each one stays valid and unchanged as long as it is referenced.
+///
+/// A SharedValue can be read from several threads at the same time.
+class SharedValue {
+  public:
+    /// @brief A member of an object.
+    using Member = std::pair<std::string, SharedValue>;
+
+    /// @brief A step of a path: the key of a member or the position of an item.
+    using Step = std::variant<std::string, size_t>;
+
+    /// @brief Constructs a null value.
+    SharedValue();
+
+    /// @brief Constructs a value from a tree of JsonValue nodes, which is copied.
+    /// @param value The value.
+    explicit SharedValue (const JsonValue &value);
+
+    /// @brief Constructs a value from a tree of JsonValue nodes, whose scalars are moved. Borrowed
+    /// strings are copied, so the value does not reference the parsed input.
+    /// @param value The value.
+    explicit SharedValue (JsonValue &&value);
+
+    inline bool isBool() const { return _scalar.isBool(); }
+    inline bool isInt() const { return _scalar.isInt(); }
+    inline bool isFloat() const { return _scalar.isFloat(); }
+    inline bool isString() const { return _scalar.isString(); }
+    inline bool isNull() const { return _scalar.isNull(); }
+    bool isObject() const;
+    bool isArray() const;
+
+    /// @brief Gets the stored value as a specific type.
+    /// @tparam T bool, int64_t, double or std::string_view.
+    /// @return The value.
+    /// @throws std::bad_variant_access if the value is not of the requested type, as JsonValue::get.
+    template<typename T>
+    inline T get() const {
+      if constexpr (std::is_same_v<T, bool> || std::is_same_v<T, int64_t> || std::is_same_v<T, double>)
+        return _scalar.get<T>();
+      else if constexpr (std::is_same_v<T, std::string_view>)
+        return _scalar.asStringView();
+      else
+        throw std::bad_variant_access {};
+    }
+
+    /// @brief Gets the stored value as a boolean.
+    inline bool asBool() const { return get<bool>(); }
+
+    /// @brief Gets the stored value as an integer.
+    inline int64_t asInt() const { return get<int64_t>(); }
+
+    /// @brief Gets the stored value as a floating-point number.
+    inline double asFloat() const { return get<double>(); }
+
+    /// @brief Gets a view of the stored string.
+    inline std::string_view asStringView() const { return get<std::string_view>(); }
+
+    /// @brief Gets the members of an object, in insertion order.
+    /// @throws std::bad_variant_access if the value is not an object.
+    const std::vector<Member> & asObject() const;
+
+    /// @brief Gets the items of an array.
+    /// @throws std::bad_variant_access if the value is not an array.
+    const std::vector<SharedValue> & asArray() const;
+
+    /// @brief Gets the number of members of an object or items of an array, 0 for other values.
+    size_t size() const;
+
+    /// @brief Looks up a member of an object.
+    /// @param key The key.
+    /// @return The value of the member, or nullptr if the value is not an object or has no such key.
+    const SharedValue * find (std::string_view key) const;
+
+    /// @brief Looks up a member of an object whose key has already been hashed.
+    /// @param key The key.
+    /// @param h The hash of the key, as returned by JsonObject::hash().
+    /// @return The value of the member, or nullptr if the value is not an object or has no such key.
+    const SharedValue * find (std::string_view key, uint32_t h) const;
+
+    /// @brief Gets an item of an array.
+    /// @param i The position of the item.
+    /// @return The item, or nullptr if the value is not an array or is too short.
+    const SharedValue * at (size_t i) const;
+
+    /// @brief Makes a new version of the value with the value of a path replaced. This value is
+    /// not modified: only the containers along the path are copied, every other one is shared.
+    /// @param path The path. Missing members are added, as empty objects if they are not the last
+    /// step; an item can be replaced, or appended at the position following the last one.
+    /// @param value The new value of the path.
+    /// @return The new version, or nullopt if the path goes through a value that is not a
+    /// container of the right kind, or through a position beyond the end of an array.
+    std::optional<SharedValue> set (std::span<const Step> path, SharedValue value) const;
+
+    /// @brief Checks if two values are the same container. Scalars are never shared.
+    /// @param other The other value.
+    inline bool shares (const SharedValue &other) const { return (_node != nullptr) && (_node == other._node); }
+
+  private:
+    struct Node;
+
+    JsonValue _scalar; ///< The value of a scalar, empty for a container.
+    std::shared_ptr<const Node> _node {}; ///< The members or items of a container.
+
+    explicit SharedValue (std::shared_ptr<const Node> &&node);
+
+    /// @brief Sets the value of a path below a value, or below a missing member if @p base is nullptr.
+    static std::optional<SharedValue> _set (const SharedValue *base, std::span<const Step> path, SharedValue &&value);
+};
+
+}
+
+#endif
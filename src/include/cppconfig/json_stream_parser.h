@@ -0,0 +1,140 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#ifndef __CPP_CONFIG_JSON_STREAM_PARSER_H__
+#define __CPP_CONFIG_JSON_STREAM_PARSER_H__
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <cppconfig/json_parser.h>
+
+
+namespace cppconfig::json {
+
+/// @brief Push-style JSON parser that accepts the input in chunks.
+///
+/// The input is delivered with feed() as it arrives (pipes, sockets, decompressors, ...) and
+/// finish() is called once the last chunk has been delivered. Tokens split across chunk
+/// boundaries (strings, numbers and literals) are kept until they are complete, so only the
+/// partial token is buffered instead of the whole document.
+///
+/// Every chunk is split at its last structural character ({, }, [, ], : or ,) outside a string.
+/// The data up to that point only contains complete tokens and is tokenized in place; the rest
+/// is kept for the next chunk.
+///
+/// Zero-copy strings are not supported, since chunks do not outlive the call to feed().
+class JsonStreamParser {
+  public:
+    /// @brief State of the parser after consuming some input.
+    enum class Status {
+      kNeedMore, //!< The document is not complete yet.
+      kDone,     //!< The document is complete. Any further input is ignored.
+      kError     //!< The input is not valid. See error().
+    };
+
+    /// @brief Default size of the chunks read from a file descriptor.
+    static constexpr size_t kDefaultChunkSize { 64 * 1024 };
+
+    /// @brief Constructs a parser with the default settings.
+    JsonStreamParser() = default;
+
+    /// @brief Constructs a parser with the given settings.
+    /// @param options The parser settings.
+    explicit JsonStreamParser (const JsonParser::Options &options);
+
+    /// @brief Consumes the next chunk of the document.
+    /// @param data Pointer to the chunk. It is not referenced once the function returns.
+    /// @param size Size of the chunk.
+    /// @return The state of the parser.
+    Status feed (const char *data, size_t size);
+
+    /// @brief Signals the end of the input and completes the pending token, if any.
+    /// @return kDone if the document is complete, kError otherwise.
+    Status finish();
+
+    /// @brief Parses the document read from a file descriptor until the end of file.
+    ///
+    /// A reader thread fills two buffers alternately while the calling thread tokenizes the other
+    /// one, so I/O overlaps with parsing. The file descriptor is not closed.
+    /// @param fd The file descriptor to read from (a pipe, socket, regular file, ...).
+    /// @param chunkSize Size of each of the two buffers.
+    /// @return The parsed JSON value if successful, otherwise nullopt.
+    /// @throws std::system_error if reading from the file descriptor fails.
+    std::optional<JsonValue> parse (int fd, size_t chunkSize = kDefaultChunkSize);
+
+    /// @brief Moves the parsed document out of the parser.
+    /// @return The parsed JSON value if finish() returned kDone, otherwise nullopt.
+    std::optional<JsonValue> take();
+
+    /// @brief Discards any state so a new document can be parsed.
+    void reset();
+
+    /// @brief Gets the current state of the parser.
+    inline Status status() const { return _status; }
+
+    /// @brief Get the last parsing error, if any.
+    /// @return Reference to the last parsing error.
+    inline const JsonParser::Error & error() const { return _error; }
+
+  private:
+    /// @brief Next token expected by the innermost container.
+    enum class Expect {
+      kRoot,       //!< '{' or '['.
+      kKeyOrEnd,   //!< A key or '}'.
+      kColon,      //!< ':' after a key.
+      kValue,      //!< A value.
+      kValueOrEnd, //!< A value or ']'.
+      kCommaOrEnd  //!< ',' or the end of the container.
+    };
+
+    /// @brief A container being built.
+    struct Frame {
+      bool object; ///< True for objects, false for arrays.
+      JsonValue::Object map {}; ///< Members of an object.
+      JsonValue::Array array {}; ///< Items of an array.
+      std::pmr::string key {}; ///< Key of the member whose value is expected.
+    };
+
+    JsonParser::Options _options {}; ///< Parser settings.
+    Status _status { Status::kNeedMore }; ///< Current state.
+    JsonParser::Error _error {}; ///< Last parsing error.
+
+    std::string _pending {}; ///< Bytes of the tokens that are not complete yet.
+    bool _inString { false }; ///< True if the end of the last chunk is inside a string.
+    bool _inEscape { false }; ///< True if the last chunk ends with a backslash inside a string.
+
+    std::vector<Frame> _stack {}; ///< Containers being built, the innermost last.
+    Expect _expect { Expect::kRoot }; ///< Next token expected.
+    std::optional<JsonValue> _root {}; ///< The parsed document.
+
+    size_t _line { 0 }; ///< Line of the first byte not tokenized yet.
+    size_t _column { 0 }; ///< Column of the first byte not tokenized yet.
+
+    /// @brief Tokenizes a region that only contains complete tokens.
+    /// @param data Pointer to the region.
+    /// @param size Size of the region.
+    void _tokenize (const char *data, size_t size);
+
+    /// @brief Adds a token to the document being built.
+    /// @param token The token.
+    /// @return The error found, or kNoError.
+    JsonParser::ErrorCode _push (JsonToken &&token);
+
+    /// @brief Adds a complete value to the innermost container or sets it as the document.
+    /// @param value The value.
+    void _add (JsonValue &&value);
+
+    /// @brief Sets the last parsing error.
+    /// @param code The ErrorCode indicating the type of error.
+    /// @param line Line of the error, relative to the region being tokenized.
+    /// @param column Column of the error, relative to the region being tokenized.
+    /// @return kError.
+    Status _setError (JsonParser::ErrorCode code, size_t line, size_t column);
+};
+
+}
+
+#endif
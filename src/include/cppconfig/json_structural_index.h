@@ -0,0 +1,63 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#ifndef __CPP_CONFIG_JSON_STRUCTURAL_INDEX_H__
+#define __CPP_CONFIG_JSON_STRUCTURAL_INDEX_H__
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <cppconfig/simd_util.h>
+
+
+namespace cppconfig::json {
+
+/// @brief Index of the structural positions of a JSON document.
+///
+/// The index is built in a single vectorized pass over the input (stage 1) and contains, in
+/// ascending order, the offset of:
+///  @li every structural character: quotes, backslashes, braces, brackets, colons and commas.
+///  @li the first character of every whitespace run (space, tab, new line, carriage return and NUL).
+///  @li the first character of every run of any other characters (numbers, literals, string contents).
+///
+/// A tokenizer can then jump straight from one position to the next one (stage 2) instead of
+/// inspecting the input byte by byte.
+class StructuralIndex {
+  public:
+    /// @brief Maximum document size (in bytes) that can be indexed.
+    static constexpr size_t kMaxSize { std::numeric_limits<uint32_t>::max() };
+
+    /// @brief Builds the index for the given buffer using the best instruction set available.
+    /// @param data Pointer to the JSON data.
+    /// @param size Size of the JSON data.
+    /// @return True if the index was built, false if the buffer is bigger than kMaxSize.
+    inline bool build (const char *data, size_t size) {
+      return build (data, size, util::SimdUtil::isa());
+    }
+
+    /// @brief Builds the index for the given buffer using the given instruction set.
+    /// @param data Pointer to the JSON data.
+    /// @param size Size of the JSON data.
+    /// @param isa Instruction set used to classify the input. It must be supported by the current CPU.
+    /// @return True if the index was built, false if the buffer is bigger than kMaxSize.
+    bool build (const char *data, size_t size, util::SimdUtil::Isa isa);
+
+    /// @brief Gets the number of indexed positions.
+    inline size_t size() const { return _positions.size(); }
+
+    /// @brief Gets the offset stored at the given index position.
+    /// @param i The index position.
+    inline uint32_t operator[] (size_t i) const { return _positions[i]; }
+
+    /// @brief Gets all the indexed offsets.
+    inline const std::vector<uint32_t> & positions() const { return _positions; }
+
+  private:
+    std::vector<uint32_t> _positions; ///< Sorted offsets of the structural positions.
+};
+
+}
+
+#endif
@@ -0,0 +1,277 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#ifndef __CPP_CONFIG_JSON_TAPE_H__
+#define __CPP_CONFIG_JSON_TAPE_H__
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include <cppconfig/json_value.h>
+
+
+namespace cppconfig::json {
+
+class JsonParser;
+
+/// @brief Flat representation of a JSON document.
+///
+/// The document is stored in one contiguous array of 64-bit words (the tape) plus a string arena,
+/// instead of a tree of JsonValue nodes. Every word holds a tag in its 8 most significant bits and
+/// a 56-bit payload:
+///  @li '{' and '[': index of the word following the matching '}' or ']', so a whole container
+///      is skipped in one step.
+///  @li '}' and ']': index of the matching '{' or '['.
+///  @li '"': offset in the string arena, where the string is stored as a 32-bit length followed
+///      by its characters. Object keys are strings too.
+///  @li 'l' and 'd': 64-bit integer and double. The value is stored in the next word.
+///  @li 't', 'f' and 'n': true, false and null.
+///
+/// The members of an object are stored as a key followed by its value.
+class Tape {
+  public:
+    /// @brief Type of the tape words.
+    enum class Tag : uint8_t {
+      kObjectBegin = '{', //!< Beginning of an object.
+      kObjectEnd = '}',   //!< End of an object.
+      kArrayBegin = '[',  //!< Beginning of an array.
+      kArrayEnd = ']',    //!< End of an array.
+      kString = '"',      //!< String.
+      kInteger = 'l',     //!< 64-bit integer.
+      kFloatPoint = 'd',  //!< Double.
+      kTrue = 't',        //!< true.
+      kFalse = 'f',       //!< false.
+      kNull = 'n'         //!< null.
+    };
+
+    class Value;
+
+    /// @brief Range over the items of an array.
+    class ArrayView {
+      public:
+        /// @brief Forward iterator over the items of an array.
+        class Iterator {
+          public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Value;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = Value;
+
+            Iterator() = default;
+            Iterator (const Tape *tape, size_t idx): _tape { tape }, _idx { idx } {}
+
+            inline Value operator*() const { return Value { _tape, _idx }; }
+            inline Iterator & operator++() { _idx = _tape->_next (_idx); return *this; }
+            inline Iterator operator++ (int) { auto it { *this }; ++(*this); return it; }
+            inline bool operator== (const Iterator &other) const { return _idx == other._idx; }
+
+          private:
+            const Tape *_tape { nullptr }; ///< The tape.
+            size_t _idx { 0 }; ///< Index of the current item.
+        };
+
+        ArrayView (const Tape *tape, size_t begin, size_t end): _tape { tape }, _begin { begin }, _end { end } {}
+
+        inline Iterator begin() const { return Iterator { _tape, _begin }; }
+        inline Iterator end() const { return Iterator { _tape, _end }; }
+
+      private:
+        const Tape *_tape; ///< The tape.
+        size_t _begin; ///< Index of the first item.
+        size_t _end; ///< Index of the closing bracket.
+    };
+
+    /// @brief Read-only view of a value stored in a tape. It is valid as long as the tape.
+    class Value {
+      public:
+        Value (const Tape *tape, size_t idx): _tape { tape }, _idx { idx } {}
+
+        /// @brief Gets the tag of the value.
+        inline Tag tag() const { return _tape->_tag (_idx); }
+
+        /// @brief Gets the index of the value in the tape.
+        inline size_t index() const { return _idx; }
+
+        inline bool isBool() const { return (tag() == Tag::kTrue) || (tag() == Tag::kFalse); }
+        inline bool isInt() const { return tag() == Tag::kInteger; }
+        inline bool isFloat() const { return tag() == Tag::kFloatPoint; }
+        inline bool isString() const { return tag() == Tag::kString; }
+        inline bool isNull() const { return tag() == Tag::kNull; }
+        inline bool isObject() const { return tag() == Tag::kObjectBegin; }
+        inline bool isArray() const { return tag() == Tag::kArrayBegin; }
+
+        /// @brief Gets the stored value as a specific type.
+        /// @tparam T bool, int64_t, double or std::string_view. Any other type throws.
+        /// @return The value.
+        /// @throws std::bad_variant_access if the value is not of the requested type, as JsonValue::get.
+        template<typename T>
+        inline T get() const {
+          if constexpr (std::is_same_v<T, bool>) {
+            if (!isBool()) throw std::bad_variant_access {};
+            return tag() == Tag::kTrue;
+          }
+          else if constexpr (std::is_same_v<T, int64_t>) {
+            if (!isInt()) throw std::bad_variant_access {};
+            return static_cast<int64_t> (_tape->_words[_idx + 1]);
+          }
+          else if constexpr (std::is_same_v<T, double>) {
+            if (!isFloat()) throw std::bad_variant_access {};
+            return std::bit_cast<double> (_tape->_words[_idx + 1]);
+          }
+          else if constexpr (std::is_same_v<T, std::string_view>) {
+            if (!isString()) throw std::bad_variant_access {};
+            return _tape->_string (_idx);
+          }
+          else {
+            throw std::bad_variant_access {};
+          }
+        }
+
+        /// @brief Gets the stored value as a boolean.
+        inline bool asBool() const { return get<bool>(); }
+
+        /// @brief Gets the stored value as an integer.
+        inline int64_t asInt() const { return get<int64_t>(); }
+
+        /// @brief Gets the stored value as a floating-point number.
+        inline double asFloat() const { return get<double>(); }
+
+        /// @brief Gets the stored string.
+        inline std::string_view asStringView() const { return get<std::string_view>(); }
+
+        /// @brief Gets the items of an array.
+        /// @throws std::bad_variant_access if the value is not an array.
+        inline ArrayView asArray() const {
+          if (!isArray()) throw std::bad_variant_access {};
+          return ArrayView { _tape, _idx + 1, _tape->_payload (_idx) - 1 };
+        }
+
+        /// @brief Gets the number of members of an object or items of an array, 0 for other values.
+        size_t size() const;
+
+        /// @brief Looks up a member of an object. The first one wins if the key is repeated.
+        /// @param key The key.
+        /// @return The value of the member, or nullopt if the value is not an object or has no such key.
+        std::optional<Value> find (std::string_view key) const;
+
+        /// @brief Gets an item of an array.
+        /// @param i The position of the item.
+        /// @return The item, or nullopt if the value is not an array or is too short.
+        std::optional<Value> at (size_t i) const;
+
+      private:
+        const Tape *_tape; ///< The tape.
+        size_t _idx; ///< Index of the first word of the value.
+    };
+
+    /// @brief Gets the root value. The tape must not be empty.
+    inline Value root() const { return Value { this, 0 }; }
+
+    /// @brief Checks if the tape holds no document.
+    inline bool empty() const { return _words.empty(); }
+
+    /// @brief Gets the tape words.
+    inline const std::vector<uint64_t> & words() const { return _words; }
+
+    /// @brief Gets the string arena.
+    inline const std::string & strings() const { return _strings; }
+
+    /// @brief Merges two documents with the rules of JsonValue::merge.
+    ///
+    /// Objects are merged member by member, arrays are concatenated unless @p arrays says
+    /// otherwise, and any other value of @p dst, or a value whose type differs, is replaced by the
+    /// one of @p src.
+    /// @param src The document whose values take precedence.
+    /// @param dst The document to be extended or overridden.
+    /// @param arrays How two arrays are combined.
+    /// @return The merged document.
+    static Tape merge (const Tape &src, const Tape &dst, JsonValue::Arrays arrays = JsonValue::Arrays::kAppend);
+
+  private:
+    friend class JsonParser;
+
+    static constexpr uint64_t kPayloadMask { (uint64_t { 1 } << 56) - 1 };
+
+    std::vector<uint64_t> _words {}; ///< Tagged words.
+    std::string _strings {}; ///< String arena.
+
+    inline Tag _tag (size_t idx) const { return static_cast<Tag> (_words[idx] >> 56); }
+    inline size_t _payload (size_t idx) const { return static_cast<size_t> (_words[idx] & kPayloadMask); }
+
+    /// @brief Gets the index of the value following the one at @p idx.
+    inline size_t _next (size_t idx) const {
+      switch (_tag (idx)) {
+        case Tag::kObjectBegin:
+        case Tag::kArrayBegin:
+          return _payload (idx);
+        case Tag::kInteger:
+        case Tag::kFloatPoint:
+          return idx + 2;
+        default:
+          return idx + 1;
+      }
+    }
+
+    /// @brief Gets the string referenced by the word at @p idx.
+    inline std::string_view _string (size_t idx) const {
+      const size_t offset { _payload (idx) };
+
+      uint32_t len;
+      std::memcpy (&len, _strings.data() + offset, sizeof (len));
+
+      return { _strings.data() + offset + sizeof (len), len };
+    }
+
+    inline void _append (Tag tag, uint64_t payload = 0) {
+      _words.push_back ((static_cast<uint64_t> (tag) << 56) | payload);
+    }
+
+    /// @brief Appends the beginning of a container and returns its index.
+    inline size_t _appendBegin (Tag tag) {
+      _append (tag);
+      return _words.size() - 1;
+    }
+
+    /// @brief Appends the end of the container that begins at @p begin.
+    inline void _appendEnd (Tag tag, size_t begin) {
+      _append (tag, begin);
+      _words[begin] |= _words.size();
+    }
+
+    inline void _appendString (std::string_view str) {
+      const auto len { static_cast<uint32_t> (str.size()) };
+
+      _append (Tag::kString, _strings.size());
+      _strings.append (reinterpret_cast<const char *> (&len), sizeof (len));
+      _strings.append (str);
+    }
+
+    inline void _appendInt (int64_t v) {
+      _append (Tag::kInteger);
+      _words.push_back (static_cast<uint64_t> (v));
+    }
+
+    inline void _appendDouble (double v) {
+      _append (Tag::kFloatPoint);
+      _words.push_back (std::bit_cast<uint64_t> (v));
+    }
+
+    /// @brief Appends a copy of the value at @p idx of another tape.
+    void _copy (const Tape &src, size_t idx);
+
+    /// @brief Appends the merge of the values at @p srcIdx and @p dstIdx.
+    void _merge (const Tape &src, size_t srcIdx, const Tape &dst, size_t dstIdx, JsonValue::Arrays arrays);
+};
+
+}
+
+#endif
@@ -74,6 +74,22 @@ class JsonToken {
       // empty
     }
 
+    /// Constructs a JsonToken taking the ownership of a string value.
+    /// @param v The string value for the token.
+    inline JsonToken (std::string &&v) noexcept: _id { JsonTokenId::kValueString }, _value { std::move (v) } {
+      // empty
+    }
+
+    /// Constructs a JsonToken with a string value that references external memory (no copy is done).
+    /// The memory referenced by @p v must outlive the token and any copy of it.
+    /// @param v The string value for the token.
+    /// @return The JsonToken.
+    static inline JsonToken borrow (std::string_view v) noexcept {
+      JsonToken token { JsonTokenId::kValueString };
+      token._value = v;
+      return token;
+    }
+
     /// @brief Copy constructor for JsonToken.
     /// @param obj obj The JsonToken object to be copied.
     inline JsonToken (const JsonToken &obj): _id { obj._id }, _value { obj._value } {
@@ -109,6 +125,28 @@ class JsonToken {
     /// @return The JsonTokenId of the token.
     inline JsonTokenId id() const { return _id; }
 
+    /// Checks if the token is a string that references external memory.
+    /// @return True if the string is borrowed, false otherwise.
+    inline bool borrowed() const { return std::holds_alternative<std::string_view> (_value); }
+
+    /// Returns a view of the string value of the token, whether it is owned or borrowed.
+    /// @return The string value of the token.
+    inline std::string_view view() const {
+      if (const auto *sv { std::get_if<std::string_view> (&_value) }; sv)
+        return *sv;
+
+      return std::get<std::string> (_value);
+    }
+
+    /// Moves the string value out of the token. A borrowed string is copied.
+    /// @return The string value of the token.
+    inline std::string takeString() {
+      if (const auto *sv { std::get_if<std::string_view> (&_value) }; sv)
+        return std::string { *sv };
+
+      return std::move (std::get<std::string> (_value));
+    }
+
     /// Returns a const reference to the value of the token.
     /// @tparam T The type of the value to retrieve.
     /// @return The value of the token as the specified type.
@@ -120,7 +158,8 @@ class JsonToken {
         std::is_same_v<T, std::variant_alternative_t<1, decltype(_value)>> ||
         std::is_same_v<T, std::variant_alternative_t<2, decltype(_value)>> ||
         std::is_same_v<T, std::variant_alternative_t<3, decltype(_value)>> ||
-        std::is_same_v<T, std::variant_alternative_t<4, decltype(_value)>>
+        std::is_same_v<T, std::variant_alternative_t<4, decltype(_value)>> ||
+        std::is_same_v<T, std::variant_alternative_t<5, decltype(_value)>>
       );
 
       return std::get<T> (_value);
@@ -137,7 +176,8 @@ class JsonToken {
         std::is_same_v<T, std::variant_alternative_t<1, decltype(_value)>> ||
         std::is_same_v<T, std::variant_alternative_t<2, decltype(_value)>> ||
         std::is_same_v<T, std::variant_alternative_t<3, decltype(_value)>> ||
-        std::is_same_v<T, std::variant_alternative_t<4, decltype(_value)>>
+        std::is_same_v<T, std::variant_alternative_t<4, decltype(_value)>> ||
+        std::is_same_v<T, std::variant_alternative_t<5, decltype(_value)>>
       );
 
       return std::get<T> (_value);
@@ -155,7 +195,7 @@ class JsonToken {
         case JsonTokenId::kArrayEnd: os << "ArrayEnd"; break;
         case JsonTokenId::kColon: os << "Colon"; break;
         case JsonTokenId::kComma: os << "Comma"; break;
-        case JsonTokenId::kValueString: os << "ValueString[" << std::get<std::string> (obj._value) << "]"; break;
+        case JsonTokenId::kValueString: os << "ValueString[" << obj.view() << "]"; break;
         case JsonTokenId::kValueFloatPoint: os << "kValueFloatPoint[" << std::get<double> (obj._value) << "]"; break;
         case JsonTokenId::kValueInteger: os << "kValueInteger[" << std::get<int64_t> (obj._value) << "]"; break;
         case JsonTokenId::kValueBoolean: os << "ValueBoolean[" << std::get<bool> (obj._value) << "]"; break;
@@ -169,7 +209,7 @@ class JsonToken {
 
   private:
     JsonTokenId _id; ///< The JsonTokenId of the token.
-    std::variant<std::string, bool, int64_t, double, std::nullptr_t> _value; ///< The value of the token, stored as a variant.
+    std::variant<std::string, bool, int64_t, double, std::nullptr_t, std::string_view> _value; ///< The value of the token, stored as a variant.
 };
 
 }
@@ -8,6 +8,7 @@
 #include <optional>
 
 #include <cppconfig/json_buffer.h>
+#include <cppconfig/json_structural_index.h>
 #include <cppconfig/json_token.h>
 
 
@@ -23,15 +24,34 @@ class JsonTokenizer {
       kInvalidEscape = 2   ///< Invalid escape sequence in a string.
     };
 
+    /// Enumeration representing the available tokenizer engines.
+    enum class Engine {
+      kScalar,  ///< Walks the input one byte at a time.
+      kIndexed  ///< Builds a SIMD structural index first and jumps between structural positions.
+    };
+
+    /// @brief Tokenizer settings.
+    struct Options {
+      Engine engine { Engine::kScalar }; ///< Engine used to split the input into tokens.
+      bool zeroCopy { false }; ///< Strings without escape sequences reference the input instead of being copied.
+    };
+
     /// @brief Constructor for JsonTokenizer.
     /// @param buffer The Buffer containing the JSON data to tokenize.
-    JsonTokenizer (Buffer &&buffer): _buffer { std::move (buffer) } {
+    JsonTokenizer (Buffer &&buffer): JsonTokenizer { std::move (buffer), Options {} } {
       // empty
     }
 
+    /// @brief Constructor for JsonTokenizer.
+    /// @param buffer The Buffer containing the JSON data to tokenize.
+    /// @param options The tokenizer settings.
+    JsonTokenizer (Buffer &&buffer, const Options &options);
+
     /// @brief Retrieves the next JSON token from the input data.
     /// @return An optional JsonToken, or std::nullopt if no more tokens are available or an error occurs.
-    std::optional<JsonToken> next();
+    inline std::optional<JsonToken> next() {
+      return (_engine == Engine::kIndexed) ? _nextIndexed() : _nextScalar();
+    }
 
     /// @brief Retrieves the current line.
     /// @return The current line number.
@@ -41,6 +61,14 @@ class JsonTokenizer {
     /// @return The current column number.
     inline size_t column() const { return _buffer.column(); }
 
+    /// @brief Retrieves the offset of the first character that has not been tokenized yet.
+    /// @return The offset in the data.
+    inline size_t offset() const { return _buffer.offset(); }
+
+    /// @brief Retrieves the engine used by the tokenizer.
+    /// @return The tokenizer engine.
+    inline Engine engine() const { return _engine; }
+
     /// @brief Retrieves the last error.
     /// @return  The last error.
     inline Error error() const { return _error; }
@@ -48,6 +76,18 @@ class JsonTokenizer {
   private:
     Buffer _buffer;  ///< The Buffer containing the JSON data to tokenize.
     Error _error { Error::kNoError };  ///< The current error state during tokenization.
+    Engine _engine { Engine::kScalar }; ///< The engine used to tokenize the data.
+    bool _zeroCopy { false }; ///< True if strings without escape sequences reference the data.
+    StructuralIndex _index {}; ///< Structural positions of the data (kIndexed engine only).
+    size_t _next { 0 }; ///< Next position of the structural index to visit (kIndexed engine only).
+
+    /// Retrieves the next token walking the buffer one byte at a time.
+    /// @return An optional JsonToken, or std::nullopt if no more tokens are available.
+    std::optional<JsonToken> _nextScalar();
+
+    /// Retrieves the next token jumping between the positions of the structural index.
+    /// @return An optional JsonToken, or std::nullopt if no more tokens are available.
+    std::optional<JsonToken> _nextIndexed();
 
     /// Handles a number.
     /// @return A JsonToken representing the number.
@@ -57,6 +97,32 @@ class JsonTokenizer {
     /// @return A JsonToken representing the string.
     JsonToken _handleString ();
 
+    /// Handles a string using the structural index.
+    /// @param start Offset of the opening quote.
+    /// @return A JsonToken representing the string.
+    JsonToken _handleStringIndexed (size_t start);
+
+    /// Handles a number or a literal (true, false, null) using the structural index.
+    /// @param start Offset of the first character of the value.
+    /// @param end Offset of the first character after the value.
+    /// @return A JsonToken representing the value.
+    JsonToken _handleScalarIndexed (size_t start, size_t end);
+
+    /// Decodes the escape sequence that follows a backslash. \\uXXXX sequences are encoded as UTF-8
+    /// and UTF-16 surrogate pairs are combined into a single code point.
+    /// @param p Pointer to the character following the backslash.
+    /// @param end Pointer to the end of the data.
+    /// @param str The string where the decoded character is appended.
+    /// @return The number of characters consumed, or 0 if the escape sequence is not valid.
+    static size_t _unescape (const char *p, const char *end, std::string &str);
+
+    /// Creates a string token for a string without escape sequences.
+    /// @param str The string, which references the data.
+    /// @return A JsonToken representing the string.
+    inline JsonToken _makeString (std::string_view str) const {
+      return _zeroCopy ? JsonToken::borrow (str) : JsonToken { str };
+    }
+
     /// Sets the error state and returns a JsonToken representing the error.
     /// @param err The error code to set.
     /// @return A JsonToken representing the error.
@@ -6,9 +6,15 @@
 #ifndef __CPP_CONFIG_JSON_VALUE_H__
 #define __CPP_CONFIG_JSON_VALUE_H__
 #include <cassert>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
 #include <unordered_map>
 #include <string>
+#include <string_view>
 #include <typeinfo>
+#include <utility>
+#include <variant>
 #include <vector>
 
 #include <cppconfig/json_tokenizer.h>
@@ -16,165 +22,281 @@
 
 namespace cppconfig::json {
 
+class JsonObject;
+
 /// @brief Represents a JSON value, which can be a boolean, integer, float, string, null, object, or array.
+///
+/// A value is a 16-byte tagged union: booleans, numbers and borrowed strings are stored inline,
+/// while owned strings, objects and arrays are one pointer to out-of-line storage.
+///
+/// Objects (see JsonObject) and arrays are std::pmr containers: a whole document can be
+/// allocated from one memory resource (see JsonParser::Options::resource). Copies use the default
+/// resource and own their strings, so they do not depend on the parsed input or on its resource;
+/// moves keep the resource of the moved value.
 class JsonValue {
   public:
+    /// @brief Members of an object.
+    using Object = JsonObject;
+
+    /// @brief Items of an array.
+    using Array = std::pmr::vector<JsonValue>;
+
+    /// @brief How merge() combines two arrays.
+    enum class Arrays {
+      kAppend, //!< The items of the source are appended to the ones of the destination.
+      kReplace //!< The source array replaces the destination one.
+    };
+
     /// @brief Constructs a JSON value from a JSON token (move semantics).
+    /// A borrowed string stays borrowed, an owned one is moved to the heap.
     /// @param token The JSON token.
-    JsonValue (JsonToken &&token): _token { std::move (token) } {
-      // empty
+    JsonValue (JsonToken &&token) {
+      switch (token.id()) {
+        case JsonTokenId::kValueBoolean:
+          _tag = Tag::kBool;
+          _value.b = token.value<bool>();
+          break;
+        case JsonTokenId::kValueInteger:
+          _tag = Tag::kInt;
+          _value.i = token.value<int64_t>();
+          break;
+        case JsonTokenId::kValueFloatPoint:
+          _tag = Tag::kFloat;
+          _value.d = token.value<double>();
+          break;
+        case JsonTokenId::kValueNull:
+          _tag = Tag::kNull;
+          break;
+        case JsonTokenId::kValueString:
+          if (const auto sv { token.view() }; token.borrowed() && (sv.size() <= std::numeric_limits<uint32_t>::max())) {
+            _tag = Tag::kStringView;
+            _value.chars = sv.data();
+            _size = static_cast<uint32_t> (sv.size());
+          }
+          else {
+            _tag = Tag::kString;
+            _value.string = new std::string { token.takeString() };
+          }
+          break;
+        case JsonTokenId::kObjectBegin:
+          _setObject();
+          break;
+        case JsonTokenId::kArrayBegin:
+          _setArray (Array {});
+          break;
+        default:
+          break;
+      }
     }
 
     /// @brief Constructs a JSON object value from a map of string to JSON values (move semantics).
+    /// The value keeps the memory resource of the map, which also holds the out-of-line storage.
     /// @param map The map representing the JSON object.
-    // JsonValue (std::unordered_map<std::string, JsonValue> &&map): _token { JsonTokenId::kObjectBegin }, _map { std::move (map) } {
-    JsonValue (std::unordered_map<std::string, JsonValue> &&map): _token { JsonTokenId::kObjectBegin } {
-      if (map.size())
-        _map = std::move (map);
-      // empty
+    JsonValue (Object &&map) {
+      _setObject (std::move (map));
     }
 
     /// @brief Constructs a JSON array value from a vector of JSON values (move semantics).
+    /// The value keeps the memory resource of the vector, which also holds the out-of-line storage.
+    /// @param array The vector representing the JSON array.
+    JsonValue (Array &&array) {
+      _setArray (std::move (array));
+    }
+
+    /// @brief Constructs a JSON object value from a standard map, whose values are moved.
+    /// @param map The map representing the JSON object.
+    JsonValue (std::unordered_map<std::string, JsonValue> &&map);
+
+    /// @brief Constructs a JSON array value from a standard vector, whose items are moved.
     /// @param array The vector representing the JSON array.
-    // JsonValue (std::vector<JsonValue> &&array): _token { JsonTokenId::kArrayBegin }, _array { std::move (array) } {
-    JsonValue (std::vector<JsonValue> &&array): _token { JsonTokenId::kArrayBegin } {
-      if (array.size()) _array = std::move (array);
-      // empty
+    JsonValue (std::vector<JsonValue> &&array) {
+      _setArray (Array {});
+      _value.array->reserve (array.size());
+      for (auto &v: array)
+        _value.array->push_back (std::move (v));
     }
 
-    /// @brief Copy constructor for JsonValue.
+    /// @brief Copy constructor for JsonValue. Out-of-line storage is copied with the default resource,
+    /// and a borrowed string is copied to an owned one.
     /// @param obj obj The JsonValue object to be copied.
-    JsonValue (const JsonValue &obj):
-      _token { obj._token },
-      _map { obj._map },
-      _array { obj._array }
-    {
-      // empty
+    JsonValue (const JsonValue &obj): _value { obj._value }, _size { obj._size }, _tag { obj._tag } {
+      if (_owns() || (_tag == Tag::kStringView))
+        _copy (obj);
     }
 
     /// @brief Copy assignment operator for JsonValue.
     /// @param obj The JsonValue object to be assigned.
     /// @return A reference to the current JsonValue instance after the assignment.
     JsonValue & operator= (const JsonValue &obj) {
-      _token = obj._token;
-      _map = obj._map;
-      _array = obj._array;
+      if (this != &obj)
+        *this = JsonValue { obj }; // obj may be part of this value
 
       return *this;
     }
 
-    /// @brief Move constructor for JsonValue.
+    /// @brief Move constructor for JsonValue. The moved value is left empty.
     /// @param obj The JsonValue object to be moved.
-    JsonValue (JsonValue &&obj) noexcept {
-      _token = std::move (obj._token);
-      if (obj._map.size()) _map = std::move (obj._map);
-      if (obj._array.size()) _array = std::move (obj._array);
+    JsonValue (JsonValue &&obj) noexcept: _value { obj._value }, _size { obj._size }, _tag { obj._tag } {
+      obj._tag = Tag::kEmpty;
     }
 
-    /// @brief Move assignment operator for JsonValue.
+    /// @brief Move assignment operator for JsonValue. The moved value is left empty.
     /// @param obj The JsonValue object to be moved.
     /// @return A reference to the current JsonValue instance after the move assignment.
     JsonValue & operator= (JsonValue &&obj) noexcept {
-      _token = std::move (obj._token);
-      if (obj._map.size()) _map = std::move (obj._map);
-      if (obj._array.size()) _array = std::move (obj._array);
+      if (this != &obj) {
+        // obj may be part of this value, so it is detached before this value is released
+        const auto value { obj._value };
+        const auto size { obj._size };
+        const auto tag { obj._tag };
+        obj._tag = Tag::kEmpty;
+
+        if (_owns())
+          _release();
+
+        _value = value;
+        _size = size;
+        _tag = tag;
+      }
 
       return *this;
     }
 
+    /// @brief Destructor.
+    ~JsonValue() {
+      if (_owns())
+        _release();
+    }
+
     /// @brief Checks if the JSON value is a boolean.
-    inline bool isBool() const { return _token.id() == JsonTokenId::kValueBoolean; }
+    inline bool isBool() const { return _tag == Tag::kBool; }
 
     /// @brief Checks if the JSON value is an integer.
-    inline bool isInt() const { return _token.id() == JsonTokenId::kValueInteger; }
+    inline bool isInt() const { return _tag == Tag::kInt; }
 
     /// @brief Checks if the JSON value is a floating-point number.
-    inline bool isFloat() const { return _token.id() == JsonTokenId::kValueFloatPoint; }
+    inline bool isFloat() const { return _tag == Tag::kFloat; }
 
     /// @brief Checks if the JSON value is a string.
-    inline bool isString() const { return _token.id() == JsonTokenId::kValueString; }
+    inline bool isString() const { return (_tag == Tag::kString) || (_tag == Tag::kStringView); }
 
     /// @brief Checks if the JSON value is null.
-    inline bool isNull() const { return _token.id() == JsonTokenId::kValueNull; }
+    inline bool isNull() const { return _tag == Tag::kNull; }
 
     /// @brief Checks if the JSON value is an object.
-    inline bool isObject() const { return _token.id() == JsonTokenId::kObjectBegin; }
+    inline bool isObject() const { return _tag == Tag::kObject; }
 
     /// @brief Checks if the JSON value is an array.
-    inline bool isArray() const { return _token.id() == JsonTokenId::kArrayBegin; }
+    inline bool isArray() const { return _tag == Tag::kArray; }
 
     /// @brief Checks if the JSON value is empty.
-    inline bool empty() const { return _token.id() == JsonTokenId::kEmpty; }
+    inline bool empty() const { return _tag == Tag::kEmpty; }
 
     /// @brief Checks if a key exists in the JSON object.
     /// @param k The key to check.
-    /// @return True if the key exists, false otherwise.
-    inline bool exists(const std::string &k) const {
-      return _map.find(k) != _map.end();
-    }
+    /// @return True if the value is an object and the key exists, false otherwise.
+    inline bool exists(std::string_view k) const;
+
+    /// @brief Looks up a member of a JSON object. The key is hashed once and nothing is allocated.
+    /// @param k The key.
+    /// @return The value of the member, or nullptr if the value is not an object or has no such key.
+    inline const JsonValue * find (std::string_view k) const;
+
+    /// @brief Looks up a member of a JSON object. The key is hashed once and nothing is allocated.
+    /// @param k The key.
+    /// @return The value of the member, or nullptr if the value is not an object or has no such key.
+    inline JsonValue * find (std::string_view k);
 
     /// @brief Gets the stored value as a specific type.
-    /// \tparam T The type to retrieve.
-    /// @return A reference to the stored value.
+    /// \tparam T bool, int64_t, double, std::string, std::string_view, Object or Array. Any other
+    /// type does not compile.
+    /// @return A const reference to the stored value; std::string_view is returned by value.
+    /// @throws std::bad_variant_access if the value is not of the requested type; a borrowed string
+    /// (see JsonToken::borrowed) is not a std::string, it is read as a std::string_view.
     template<typename T>
-    inline T & get () {
-      if constexpr (std::is_same_v<T, std::unordered_map<std::string, JsonValue>>) {
-        return _map;
+    inline std::conditional_t<std::is_same_v<T, std::string_view>, T, const T &> get () const {
+      static_assert (
+        std::is_same_v<T, bool> ||
+        std::is_same_v<T, int64_t> ||
+        std::is_same_v<T, double> ||
+        std::is_same_v<T, std::string> ||
+        std::is_same_v<T, std::string_view> ||
+        std::is_same_v<T, Object> ||
+        std::is_same_v<T, Array>,
+        "JsonValue::get supports bool, int64_t, double, std::string, std::string_view, Object and Array"
+      );
+
+      if constexpr (std::is_same_v<T, bool>) {
+        _expect (Tag::kBool);
+        return _value.b;
+      }
+      else if constexpr (std::is_same_v<T, int64_t>) {
+        _expect (Tag::kInt);
+        return _value.i;
+      }
+      else if constexpr (std::is_same_v<T, double>) {
+        _expect (Tag::kFloat);
+        return _value.d;
+      }
+      else if constexpr (std::is_same_v<T, std::string>) {
+        _expect (Tag::kString);
+        return *_value.string;
       }
-      else if constexpr (std::is_same_v<T, std::vector<JsonValue>>) {
-        return _array;
+      else if constexpr (std::is_same_v<T, std::string_view>) {
+        return asStringView();
+      }
+      else if constexpr (std::is_same_v<T, Object>) {
+        _expect (Tag::kObject);
+        return *_value.object;
       }
       else {
-        return _token.value<T> ();
+        _expect (Tag::kArray);
+        return *_value.array;
       }
     }
 
     /// @brief Gets the stored value as a specific type.
-    /// \tparam T The type to retrieve.
-    /// @return A const reference to the stored value.
+    /// \tparam T bool, int64_t, double, std::string, std::string_view, Object or Array. Any other
+    /// type does not compile.
+    /// @return A reference to the stored value; std::string_view is returned by value. A borrowed
+    /// string is copied to the heap before it is returned as a std::string.
+    /// @throws std::bad_variant_access if the value is not of the requested type.
     template<typename T>
-    inline const T & get () const {
-      if constexpr (std::is_same_v<T, std::unordered_map<std::string, JsonValue>>) {
-        return _map;
-      }
-      else if constexpr (std::is_same_v<T, std::vector<JsonValue>>) {
-        return _array;
-      }
+    inline std::conditional_t<std::is_same_v<T, std::string_view>, T, T &> get () {
+      if constexpr (std::is_same_v<T, std::string_view>)
+        return std::as_const (*this).template get<T>();
       else {
-        return _token.value<T> ();
+        if constexpr (std::is_same_v<T, std::string>)
+          _own();
+
+        return const_cast<T &> (std::as_const (*this).template get<T>());
       }
     }
 
     /// @brief Provides access to the value associated with a key in a JSON object.
     /// @param k The key.
     /// @return A reference to the JSON value associated with the key.
-    inline JsonValue & operator[] (const std::string &k) {
-      assert (_token.id() == JsonTokenId::kObjectBegin);
-      return _map.find (k)->second;
-    }
+    inline JsonValue & operator[] (std::string_view k);
 
     /// @brief Provides const access to the value associated with a key in a JSON object.
     /// @param k The key.
     /// @return A const reference to the JSON value associated with the key.
-    inline const JsonValue & operator[] (const std::string &k) const {
-      assert (_token.id() == JsonTokenId::kObjectBegin);
-      return _map.find (k)->second;
-    }
+    inline const JsonValue & operator[] (std::string_view k) const;
 
     /// @brief Provides access to the value at a specific index in a JSON array.
     /// @param i The index.
     /// @return A reference to the JSON value at the specified index.
     inline JsonValue & operator[] (size_t i) {
-      assert (_token.id() == JsonTokenId::kArrayBegin);
-      return _array[i];
+      assert (isArray());
+      return (*_value.array)[i];
     }
 
     /// @brief Provides const access to the value at a specific index in a JSON array.
     /// @param i The index.
     /// @return A const reference to the JSON value at the specified index.
     inline const JsonValue & operator[] (size_t i) const {
-      assert (_token.id() == JsonTokenId::kArrayBegin);
-      return _array[i];
+      assert (isArray());
+      return (*_value.array)[i];
     }
 
     /// @brief Gets the stored value as a boolean.
@@ -187,51 +309,148 @@ class JsonValue {
     inline double asFloat() const { return get<double>(); }
 
     /// @brief Gets the stored value as a const reference to a string.
+    /// @throws std::bad_variant_access if the value is not an owned string, like get<std::string>();
+    /// a borrowed string (see JsonToken::borrowed) is read with asStringView().
     inline const std::string & asString() const { return get<std::string>(); }
 
     /// @brief Gets the stored value as a reference to a string.
+    /// A borrowed string is copied to the heap first.
     inline std::string & asString() { return get<std::string>(); }
 
-    /// @brief Gets the stored value as a const reference to a map.
-    inline const std::unordered_map<std::string, JsonValue> & asObject() const {
-      return get<std::unordered_map<std::string, JsonValue>>();
-    }
+    /// @brief Gets a view of the stored string, whether it is owned or borrowed.
+    /// @throws std::bad_variant_access if the value is not a string.
+    inline std::string_view asStringView() const {
+      if (_tag == Tag::kStringView)
+        return std::string_view { _value.chars, _size };
 
-    /// @brief Gets the stored value as a reference to a map.
-    inline std::unordered_map<std::string, JsonValue> & asObject() {
-      return get<std::unordered_map<std::string, JsonValue>>();
+      _expect (Tag::kString);
+      return *_value.string;
     }
 
-    /// @brief Gets the stored value as a const reference to a vector.
-    inline std::vector<JsonValue> & asArray() { return get<std::vector<JsonValue>>(); }
+    /// @brief Gets the stored value as a const reference to a map.
+    inline const Object & asObject() const { return get<Object>(); }
+
+    /// @brief Gets the stored value as a reference to a map.
+    inline Object & asObject() { return get<Object>(); }
 
     /// @brief Gets the stored value as a reference to a vector.
-    inline const std::vector<JsonValue> & asArray() const { return get<std::vector<JsonValue>>(); }
+    inline Array & asArray() { return get<Array>(); }
 
-    /// @brief Gets the type of the value.
+    /// @brief Gets the stored value as a const reference to a vector.
+    inline const Array & asArray() const { return get<Array>(); }
+
+    /// @brief Gets the type of the value. Objects and arrays report the standard containers
+    /// they are equivalent to, whatever their allocator.
     inline const std::type_info & type() const {
       if (isBool()) return typeid(bool);
       if (isInt()) return typeid(int64_t);
       if (isFloat()) return typeid(double);
       if (isString()) return typeid(std::string);
       if (isNull()) return typeid(std::nullptr_t);
-      if (isObject()) return typeid(_map);
-      if (isArray()) return typeid(_array);
+      if (isObject()) return typeid(std::unordered_map<std::string, JsonValue>);
+      if (isArray()) return typeid(std::vector<JsonValue>);
       return typeid(void);
     }
 
     /// @brief Merges the contents of the source JSON value into the destination JSON value.
+    ///
+    /// Objects are merged member by member and arrays are concatenated, unless @p arrays says
+    /// otherwise. Any other value of @p dst, or a value whose type differs from the one of @p src,
+    /// is replaced by the source.
     /// @param src The source JSON value to be merged.
     /// @param dst The destination JSON value into which the source is merged.
-    /// @return true if the merge operation is successful, false otherwise.
-    static bool merge (const json::JsonValue &src, json::JsonValue &dst);
+    /// @param arrays How two arrays are combined.
+    /// @return true if every value replaced had the same type as the source (or was null),
+    /// false otherwise. The merge is complete in both cases.
+    static bool merge (const json::JsonValue &src, json::JsonValue &dst, Arrays arrays = Arrays::kAppend);
+
+    /// @brief Merges the contents of the source JSON value into the destination JSON value,
+    /// following the rules of the copying overload. Nothing is copied: members and items of
+    /// @p src are moved to @p dst, and @p src is left in an unspecified state.
+    /// @param src The source JSON value to be merged, consumed by the merge.
+    /// @param dst The destination JSON value into which the source is merged.
+    /// @param arrays How two arrays are combined.
+    /// @return true if every value replaced had the same type as the source (or was null),
+    /// false otherwise. The merge is complete in both cases.
+    static bool merge (json::JsonValue &&src, json::JsonValue &dst, Arrays arrays = Arrays::kAppend);
 
   private:
-    JsonToken _token; ///< The underlying JSON token.
-    std::unordered_map<std::string, JsonValue> _map; ///< Map representation for JSON object.
-    std::vector<JsonValue> _array; ///< Vector representation for JSON array.
+    /// @brief Kind of the stored value.
+    enum class Tag : uint8_t {
+      kEmpty,      //!< No value.
+      kNull,       //!< null.
+      kBool,       //!< Boolean, inline.
+      kInt,        //!< 64-bit integer, inline.
+      kFloat,      //!< Double, inline.
+      kString,     //!< String owned by the value, on the heap.
+      kStringView, //!< String that references external memory: pointer and 32-bit length.
+      kObject,     //!< Object, allocated from the resource of its map.
+      kArray       //!< Array, allocated from the resource of its vector.
+    };
+
+    /// @brief Inline value, or pointer to the out-of-line storage.
+    union Payload {
+      bool b;
+      int64_t i;
+      double d;
+      const char *chars;
+      std::string *string;
+      Object *object;
+      Array *array;
+    };
+
+    Payload _value { .i = 0 }; ///< The value.
+    uint32_t _size { 0 }; ///< Length of a borrowed string.
+    Tag _tag { Tag::kEmpty }; ///< Kind of the value.
+
+    /// @brief Checks if the value has out-of-line storage.
+    inline bool _owns() const {
+      return (_tag == Tag::kString) || (_tag == Tag::kObject) || (_tag == Tag::kArray);
+    }
+
+    /// @brief Checks if two values have the same type(); owned and borrowed strings do.
+    inline bool _sameType (const JsonValue &obj) const {
+      return (_tag == obj._tag) || (isString() && obj.isString());
+    }
+
+    /// @brief Copies a borrowed string to the heap, the value owns it afterwards.
+    inline void _own() {
+      if (_tag == Tag::kStringView) {
+        _value.string = new std::string { _value.chars, _size };
+        _tag = Tag::kString;
+      }
+    }
+
+    /// @brief Throws std::bad_variant_access if the value is not of the given kind.
+    inline void _expect (Tag tag) const {
+      if (_tag != tag)
+        throw std::bad_variant_access {};
+    }
+
+    /// @brief Sets the value to an empty object, allocated from the default resource.
+    inline void _setObject();
+
+    /// @brief Moves a map to the out-of-line storage, allocated from the resource of the map.
+    inline void _setObject (Object &&map);
+
+    /// @brief Moves a vector to the out-of-line storage, allocated from the resource of the vector.
+    inline void _setArray (Array &&array) {
+      _value.array = std::pmr::polymorphic_allocator<> { array.get_allocator() }.new_object<Array> (std::move (array));
+      _tag = Tag::kArray;
+    }
+
+    /// @brief Copies the out-of-line storage of another value, and the characters of a borrowed string.
+    void _copy (const JsonValue &obj);
+
+    /// @brief Releases the out-of-line storage.
+    void _release() noexcept;
 };
 
+static_assert (sizeof (JsonValue) == 16);
+
 }
 
+// the members that need a complete JsonObject are defined there
+#include <cppconfig/json_object.h>
+
 #endif
@@ -0,0 +1,37 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#ifndef __CPP_CONFIG_UTIL_NUMBER_UTIL_H__
+#define __CPP_CONFIG_UTIL_NUMBER_UTIL_H__
+#include <charconv>
+#include <cstdint>
+
+
+namespace cppconfig::util {
+
+/// @brief Provides locale-independent number parsing that behaves the same on every compiler.
+class NumberUtil {
+  public:
+    /// @brief Parses a decimal floating-point number, rounded to the nearest double (ties to even).
+    ///
+    /// The accepted syntax is the one of std::from_chars with std::chars_format::general:
+    /// an optional minus sign, digits with an optional decimal point and an optional exponent.
+    /// Numbers with up to 19 significant digits are converted with the Clinger fast path or
+    /// the Eisel-Lemire algorithm. The few inputs these cannot decide, for example long
+    /// mantissas very close to a halfway point, use an exact big decimal conversion. Any
+    /// double printed with its shortest representation is read back unchanged.
+    /// @param first Pointer to the first character.
+    /// @param last Pointer past the last character.
+    /// @param value Receives the parsed value.
+    /// @return As std::from_chars: ptr points to the first character not parsed. ec is
+    ///         std::errc::invalid_argument if there is no number, leaving @p value unchanged.
+    ///         It is std::errc::result_out_of_range on overflow or underflow, where @p value
+    ///         is set to the infinity or zero with the right sign.
+    [[nodiscard]] static std::from_chars_result parseDouble (const char *first, const char *last, double &value);
+};
+
+}
+
+#endif
@@ -0,0 +1,183 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#ifndef __CPP_CONFIG_RELOADABLE_CONFIG_H__
+#define __CPP_CONFIG_RELOADABLE_CONFIG_H__
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include <cppconfig/config.h>
+
+
+namespace cppconfig {
+
+/// @class ReloadableConfig
+/// @brief A configuration folder that is loaded again whenever its files change.
+///
+/// Every version is a complete Config, loaded from the folder as the Config constructor does
+/// (default.json, then conf.d/*.json, then {deployment}.json, then {hostname}.json). A background
+/// thread watches the folder and its conf.d folder, which may be created or removed later (with
+/// inotify on Linux, checking the modification times of the files elsewhere), waits until a burst
+/// of changes settles and loads a new version, which is published by swapping a single atomic
+/// pointer. Files replaced with a rename are seen as well.
+///
+/// Readers never take a lock: a lookup announces itself in a per-thread counter of the current
+/// epoch, reads the published version and leaves. A replaced version is released once all the
+/// readers of its epoch are gone, so a reader sees either the old or the new configuration, never
+/// a partially loaded one.
+class ReloadableConfig {
+  public:
+    /// @brief Settings used to load and watch the configuration.
+    struct Options {
+      /// Settings used to load every version. Options::Storage::kLazy and kLayered are not
+      /// supported: their lookups take a lock.
+      Config::Options config {};
+      /// Time without changes in the folder before a new version is loaded.
+      std::chrono::milliseconds debounce { 100 };
+      /// Time between checks of the files where inotify is not available.
+      std::chrono::milliseconds interval { 1000 };
+      /// Watches the folder. When false, new versions are only loaded by reload().
+      bool watch { true };
+      /// Called when a new version cannot be loaded, from the watcher thread or from reload(); the
+      /// current version is kept.
+      std::function<void (std::exception_ptr)> onError {};
+    };
+
+    /// @brief The version published when it was taken. It stays valid, and unchanged, while the
+    /// snapshot is alive, so several values can be read from the same version. A reload waits
+    /// for the snapshots of the previous version to be destroyed before releasing it: keep them
+    /// short-lived, and destroy them in the thread that took them.
+    class Snapshot {
+      public:
+        Snapshot (Snapshot &&other) noexcept;
+        Snapshot (const Snapshot &) = delete;
+        Snapshot & operator= (const Snapshot &) = delete;
+        Snapshot & operator= (Snapshot &&) = delete;
+        ~Snapshot();
+
+        /// @brief Gets the configuration.
+        inline const Config & operator*() const noexcept { return *_config; }
+
+        /// @brief Gets the configuration.
+        inline const Config * operator->() const noexcept { return _config; }
+
+      private:
+        friend class ReloadableConfig;
+
+        const ReloadableConfig *_owner { nullptr }; ///< The configuration.
+        std::atomic<uint64_t> *_readers { nullptr }; ///< Counter of the readers of the epoch.
+        const Config *_config { nullptr }; ///< The version.
+
+        explicit Snapshot (const ReloadableConfig &owner);
+    };
+
+    /// @brief Loads the configuration of a folder and starts watching it.
+    /// @param folderName The folder with the configuration files.
+    /// @param system The system information used to determine the environment and host-specific
+    /// files. It must outlive the object.
+    /// @throws std::invalid_argument if @p folderName is not a folder.
+    /// @throws Any exception thrown by the Config constructor.
+    ReloadableConfig (const std::filesystem::path &folderName, const Config::System &system = Config::System::instance());
+
+    /// @brief Loads the configuration of a folder with the specified settings and starts watching
+    /// it, unless Options::watch is false.
+    /// @param folderName The folder with the configuration files.
+    /// @param options The settings used to load and watch the configuration.
+    /// @param system The system information used to determine the environment and host-specific
+    /// files. It must outlive the object.
+    /// @throws std::invalid_argument if @p folderName is not a folder, or if the storage is
+    /// Options::Storage::kLazy or kLayered.
+    /// @throws Any exception thrown by the Config constructor.
+    ReloadableConfig (
+      const std::filesystem::path &folderName,
+      const Options &options,
+      const Config::System &system = Config::System::instance()
+    );
+
+    ReloadableConfig (const ReloadableConfig &) = delete;
+    ReloadableConfig & operator= (const ReloadableConfig &) = delete;
+
+    /// @brief Stops watching the folder and releases the current version.
+    ~ReloadableConfig();
+
+    /// @brief Takes a snapshot of the current version.
+    inline Snapshot snapshot() const { return Snapshot { *this }; }
+
+    /// @brief Retrieves a configuration value of the current version.
+    /// @tparam T The type of the configuration value, as in Config::get(std::string_view), except
+    /// views (std::string_view, std::span), which are read from a snapshot().
+    /// @param key The key.
+    /// @return An optional containing the retrieved value, or std::nullopt if the key is not found.
+    template<typename T = std::string>
+    inline std::optional<T> get (std::string_view key) const {
+      static_assert (kOwned<T>, "views are valid as long as their version: take them from a snapshot()");
+      return snapshot()->get<T> (key);
+    }
+
+    /// @brief Retrieves a configuration value of the current version with a key parsed beforehand.
+    /// @tparam T The type of the configuration value, as in get(std::string_view).
+    /// @param path The key.
+    /// @return An optional containing the retrieved value, or std::nullopt if the key is not found.
+    template<typename T = std::string>
+    inline std::optional<T> get (const Config::Path &path) const {
+      static_assert (kOwned<T>, "views are valid as long as their version: take them from a snapshot()");
+      return snapshot()->get<T> (path);
+    }
+
+    /// @brief Loads a new version now and publishes it. The watcher calls it when the files change.
+    /// @return True if the new version is published, false if it cannot be loaded, in which case
+    /// Options::onError is called with the error.
+    /// @throws std::logic_error if the calling thread holds a snapshot of this configuration: the
+    /// reload would wait for it forever.
+    bool reload();
+
+    /// @brief Gets the number of versions published after the first one.
+    inline uint64_t version() const noexcept { return _version.load (std::memory_order_acquire); }
+
+  private:
+    /// @brief Counters of the readers of the two last epochs, one cache line per group of threads.
+    struct alignas (64) Readers {
+      std::atomic<uint64_t> count[2] {}; ///< Readers of the even and odd epochs.
+    };
+
+    struct Watcher;
+
+    static constexpr size_t kStripes { 16 }; ///< Groups of reader threads.
+
+    /// True for the types get() returns by value, false for views of the version.
+    template<typename T>
+    static constexpr bool kOwned { !std::is_same_v<T, std::string_view> && !requires { typename T::element_type; } };
+
+    const std::filesystem::path _folderName; ///< The folder.
+    const Options _options; ///< Settings.
+    const Config::System &_system; ///< System information.
+
+    std::atomic<const Config *> _current { nullptr }; ///< The published version.
+    std::atomic<uint64_t> _epoch { 0 }; ///< Incremented every time a version is replaced.
+    std::atomic<uint64_t> _version { 0 }; ///< Number of versions published after the first one.
+    mutable std::array<Readers, kStripes> _readers {}; ///< Readers of the published versions.
+    std::mutex _reloading {}; ///< Serializes reload(); readers never take it.
+    std::unique_ptr<Watcher> _watcher; ///< The watcher thread.
+
+    /// @brief Announces a reader in the current epoch.
+    /// @return The counter to decrement when the reader is done.
+    std::atomic<uint64_t> * _enter() const noexcept;
+
+    /// @brief Waits until no reader of the previous epochs is left.
+    void _synchronize() noexcept;
+
+    /// @brief Watches the folder until the watcher is stopped.
+    void _watch();
+};
+
+}
+
+#endif
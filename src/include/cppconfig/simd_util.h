@@ -0,0 +1,67 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#ifndef __CPP_CONFIG_UTIL_SIMD_UTIL_H__
+#define __CPP_CONFIG_UTIL_SIMD_UTIL_H__
+#include <cstddef>
+#include <cstdint>
+
+
+namespace cppconfig::util {
+
+/// @brief Provides runtime detection of the SIMD instruction sets available on the host CPU.
+class SimdUtil {
+  public:
+    /// @brief Instruction sets the vectorized code paths can be built for.
+    enum class Isa {
+      kScalar, //!< Portable code without vector instructions.
+      kSse42,  //!< x86-64 SSE4.2.
+      kAvx2,   //!< x86-64 AVX2.
+      kNeon    //!< ARM NEON (AArch64).
+    };
+
+    /// @brief Returns the best instruction set supported by the current CPU.
+    /// The detection is done once and cached for the lifetime of the process.
+    /// @return The selected instruction set.
+    [[nodiscard]] static Isa isa();
+
+    /// @brief Checks whether the current CPU can execute code built for the given instruction set.
+    /// @param isa The instruction set to check.
+    /// @return True if the instruction set is supported, false otherwise.
+    [[nodiscard]] static bool supports (Isa isa);
+
+    /// @brief Counts the occurrences of a character in a buffer using the best instruction set available.
+    /// @param data Pointer to the buffer.
+    /// @param size Size of the buffer.
+    /// @param c The character to count.
+    /// @return The number of occurrences of @p c in the buffer.
+    [[nodiscard]] static size_t count (const char *data, size_t size, char c);
+
+    /// @brief Counts the occurrences of a character in a buffer using the given instruction set.
+    /// @param data Pointer to the buffer.
+    /// @param size Size of the buffer.
+    /// @param c The character to count.
+    /// @param isa Instruction set used to count. It must be supported by the current CPU.
+    /// @return The number of occurrences of @p c in the buffer.
+    [[nodiscard]] static size_t count (const char *data, size_t size, char c, Isa isa);
+
+    /// @brief Converts an Isa value to a string representation.
+    /// @param isa The Isa to convert.
+    /// @return String representation of the Isa.
+    static constexpr const char * toCString (const Isa isa) {
+      switch (isa) {
+        case Isa::kScalar: return "scalar";
+        case Isa::kSse42: return "sse4.2";
+        case Isa::kAvx2: return "avx2";
+        case Isa::kNeon: return "neon";
+      }
+
+      return "unknown";
+    }
+};
+
+}
+
+#endif
@@ -6,19 +6,559 @@
 #include <unistd.h>
 #include <limits.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
 #include <stdexcept>
 #include <format>
+#include <thread>
+#include <tuple>
+#include <typeindex>
+#include <unordered_map>
 
 #include <cppconfig/config.h>
-#include <cppconfig/mm_file.h>
+#include <cppconfig/json_tokenizer.h>
 
 #if !defined(HOST_NAME_MAX) && defined(_POSIX_HOST_NAME_MAX)
   #define HOST_NAME_MAX _POSIX_HOST_NAME_MAX
 #endif
 
+extern char **environ;
+
 
 namespace cppconfig {
 
+namespace {
+
+// ----------------------------------------------------------------------------
+// TreeCursor
+//
+// Adapts a JsonValue to the find/at interface of json::Tape::Value.
+// ----------------------------------------------------------------------------
+struct TreeCursor {
+  std::reference_wrapper<const json::JsonValue> value;
+
+  std::optional<TreeCursor> find (std::string_view key) const {
+    if (const auto *member { value.get().find (key) }; member != nullptr)
+      return TreeCursor { *member };
+    return std::nullopt;
+  }
+
+  std::optional<TreeCursor> find (std::string_view key, uint32_t hash) const {
+    if (!value.get().isObject())
+      return std::nullopt;
+
+    const auto &obj { value.get().asObject() };
+    if (const auto it { obj.find (key, hash) }; it != obj.end())
+      return TreeCursor { it->second };
+    return std::nullopt;
+  }
+
+  std::optional<TreeCursor> at (size_t index) const {
+    if (!value.get().isArray() || (index >= value.get().asArray().size()))
+      return std::nullopt;
+    return TreeCursor { value.get()[index] };
+  }
+};
+
+// ----------------------------------------------------------------------------
+// SharedCursor
+//
+// Adapts a json::SharedValue to the find/at interface of json::Tape::Value.
+// ----------------------------------------------------------------------------
+struct SharedCursor {
+  const json::SharedValue *value;
+
+  std::optional<SharedCursor> find (std::string_view key) const {
+    if (const auto *member { value->find (key) }; member != nullptr)
+      return SharedCursor { member };
+    return std::nullopt;
+  }
+
+  std::optional<SharedCursor> find (std::string_view key, uint32_t hash) const {
+    if (const auto *member { value->find (key, hash) }; member != nullptr)
+      return SharedCursor { member };
+    return std::nullopt;
+  }
+
+  std::optional<SharedCursor> at (size_t index) const {
+    if (const auto *item { value->at (index) }; item != nullptr)
+      return SharedCursor { item };
+    return std::nullopt;
+  }
+};
+
+// ----------------------------------------------------------------------------
+// walk
+//
+// Follows a key path such as "a.b[2].c" from the root.
+// ----------------------------------------------------------------------------
+template<typename Cursor>
+std::optional<Cursor> walk (Cursor v, const std::string_view &sv) {
+  const bool found { splitKey (
+    sv,
+    [&v] (std::string_view key) {
+      const auto member { v.find (key) };
+      if (member.has_value())
+        v = member.value();
+      return member.has_value();
+    },
+    [&v] (size_t index) {
+      const auto item { v.at (index) };
+      if (item.has_value())
+        v = item.value();
+      return item.has_value();
+    }
+  ) };
+
+  if (!found)
+    return std::nullopt;
+
+  return v;
+}
+
+// ----------------------------------------------------------------------------
+// walk
+//
+// Follows a parsed key path from the root. Member keys are looked up with their
+// precomputed hash when the cursor supports it.
+// ----------------------------------------------------------------------------
+template<typename Cursor>
+std::optional<Cursor> walk (Cursor v, const Config::Path &path) {
+  for (const auto &segment: path.segments()) {
+    std::optional<Cursor> next {};
+
+    if (segment.item)
+      next = v.at (segment.index);
+    else if constexpr (requires { v.find (segment.key, segment.hash); })
+      next = v.find (segment.key, segment.hash);
+    else
+      next = v.find (segment.key);
+
+    if (!next.has_value())
+      return std::nullopt;
+
+    v = std::move (next.value());
+  }
+
+  return v;
+}
+
+// ----------------------------------------------------------------------------
+// PathHash
+//
+// Lets the memoized paths be looked up with a std::string_view.
+// ----------------------------------------------------------------------------
+struct PathHash {
+  using is_transparent = void;
+
+  inline size_t operator() (std::string_view k) const noexcept { return std::hash<std::string_view> {} (k); }
+};
+
+// ----------------------------------------------------------------------------
+// parserOptions
+//
+// Settings of the parser, allocating the values from the arena of the configuration if it has one.
+// ----------------------------------------------------------------------------
+json::JsonParser::Options parserOptions (const json::JsonParser::Options &options, std::pmr::memory_resource *arena) {
+  auto result { options };
+  if (arena != nullptr)
+    result.resource = arena;
+
+  return result;
+}
+
+// ----------------------------------------------------------------------------
+// threadCount
+//
+// Threads that parse the files of a folder, see Config::Options::threads.
+// ----------------------------------------------------------------------------
+size_t threadCount (const Config::Options &options) {
+  // a memory resource is not meant to be shared between threads
+  if (options.arena || (options.parser.resource != nullptr))
+    return 1;
+
+  if (options.threads > 0)
+    return options.threads;
+
+  return std::clamp<size_t> (std::thread::hardware_concurrency(), 1, 8);
+}
+
+// ----------------------------------------------------------------------------
+// jsonFiles
+//
+// The JSON files of a folder, in alphabetical order.
+// ----------------------------------------------------------------------------
+std::vector<std::filesystem::path> jsonFiles (const std::filesystem::path &folderName) {
+  std::vector<std::filesystem::path> result {};
+
+  for (const auto &entry: std::filesystem::directory_iterator { folderName }) {
+    if (entry.is_regular_file() && (entry.path().extension() == ".json"))
+      result.push_back (entry.path());
+  }
+
+  std::sort (result.begin(), result.end());
+  return result;
+}
+
+constexpr std::string_view kOverridePrefix { "CPPCONFIG__" }; // variables that override values
+
+// ----------------------------------------------------------------------------
+// Override
+//
+// An environment variable that overrides a value, see Config::Options::environment.
+// ----------------------------------------------------------------------------
+struct Override {
+  std::vector<std::string> path {};
+  std::string_view value {};
+
+  inline bool operator< (const Override &other) const { return path < other.path; }
+};
+
+// ----------------------------------------------------------------------------
+// quote
+// ----------------------------------------------------------------------------
+void quote (std::string_view text, std::string &json) {
+  constexpr char kHex[] { "0123456789abcdef" };
+
+  json += '"';
+  for (const char c: text) {
+    if ((c == '"') || (c == '\\')) {
+      json += '\\';
+      json += c;
+    }
+    else if (static_cast<unsigned char> (c) < 0x20) {
+      json += "\\u00";
+      json += kHex[c >> 4];
+      json += kHex[c & 0xf];
+    }
+    else
+      json += c;
+  }
+  json += '"';
+}
+
+// ----------------------------------------------------------------------------
+// isJson
+//
+// Whether the value of an environment variable is a JSON value by itself: a
+// single scalar token, or an object or an array a parser accepts. Numbers
+// with leading zeros, such as "007", are kept as strings.
+// ----------------------------------------------------------------------------
+bool isJson (std::string_view value) {
+  using Id = json::JsonTokenId;
+
+  json::JsonTokenizer tokenizer { json::Buffer { value.data(), value.size() } };
+  const auto token { tokenizer.next() };
+  if (!token.has_value())
+    return false;
+
+  switch (token->id()) {
+    case Id::kObjectBegin:
+    case Id::kArrayBegin: {
+      // the parser stops at the end of the value, so the tokens after it are checked here
+      for (size_t depth { 1 }; depth > 0;) {
+        const auto next { tokenizer.next() };
+        if (!next.has_value() || (next->id() == Id::kError))
+          return false;
+
+        if ((next->id() == Id::kObjectBegin) || (next->id() == Id::kArrayBegin))
+          ++depth;
+        else if ((next->id() == Id::kObjectEnd) || (next->id() == Id::kArrayEnd))
+          --depth;
+      }
+
+      if (tokenizer.next().has_value() || (tokenizer.error() != json::JsonTokenizer::Error::kNoError))
+        return false;
+
+      // a parser of its own: the one of the configuration may allocate from its arena
+      json::JsonParser parser {};
+      return parser.parse (value.data(), value.size()).has_value();
+    }
+
+    case Id::kValueInteger:
+    case Id::kValueFloatPoint: {
+      const auto digits { value.substr (value.find_first_not_of ("- \t")) };
+      if ((digits.size() > 1) && (digits[0] == '0') && std::isdigit (static_cast<unsigned char> (digits[1])))
+        return false;
+    }
+      [[fallthrough]];
+
+    case Id::kValueString:
+    case Id::kValueBoolean:
+    case Id::kValueNull:
+      return !tokenizer.next().has_value() && (tokenizer.error() == json::JsonTokenizer::Error::kNoError);
+
+    default:
+      return false;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// writeOverrides
+//
+// Writes the object of the overrides in [begin, end), sorted by path, that
+// share their first @p depth keys. When a path is a prefix of other ones, the
+// longer paths win.
+// ----------------------------------------------------------------------------
+void writeOverrides (
+  std::vector<Override>::const_iterator begin,
+  std::vector<Override>::const_iterator end,
+  size_t depth,
+  std::string &json
+) {
+  json += '{';
+
+  for (auto it { begin }; it != end;) {
+    const auto &key { it->path[depth] };
+    const auto last { std::find_if (it, end, [&key, depth] (const Override &o) { return o.path[depth] != key; }) };
+
+    if (it != begin)
+      json += ',';
+    quote (key, json);
+    json += ':';
+
+    if ((std::next (it) == last) && (it->path.size() == depth + 1)) {
+      if (isJson (it->value))
+        json += it->value;
+      else
+        quote (it->value, json);
+    }
+    else {
+      // the shorter path sorts first
+      writeOverrides ((it->path.size() == depth + 1)? std::next (it) : it, last, depth + 1, json);
+    }
+
+    it = last;
+  }
+
+  json += '}';
+}
+
+// ----------------------------------------------------------------------------
+// overridesDocument
+//
+// The JSON document of the environment variables that override values, with
+// the prefix removed and the rest of the name split on "__". Variables with an
+// empty key are ignored.
+// ----------------------------------------------------------------------------
+std::string overridesDocument (const std::vector<std::pair<std::string, std::string>> &variables) {
+  constexpr std::string_view kSeparator { "__" };
+
+  std::vector<Override> overrides {};
+  overrides.reserve (variables.size());
+
+  for (const auto &[name, value]: variables) {
+    if (!name.starts_with (kOverridePrefix))
+      continue;
+
+    Override entry { .value = value };
+    bool valid { true };
+    for (std::string_view rest { std::string_view { name }.substr (kOverridePrefix.size()) }; valid;) {
+      const auto pos { rest.find (kSeparator) };
+      entry.path.emplace_back (rest.substr (0, pos));
+      valid = !entry.path.back().empty();
+      if (pos == std::string_view::npos)
+        break;
+      rest.remove_prefix (pos + kSeparator.size());
+    }
+
+    if (valid)
+      overrides.push_back (std::move (entry));
+  }
+
+  if (overrides.empty())
+    return {};
+
+  // a variable repeated in the list is taken once, the last one wins
+  std::stable_sort (overrides.begin(), overrides.end());
+  const auto first { std::unique (overrides.rbegin(), overrides.rend(), [] (const Override &a, const Override &b) {
+    return a.path == b.path;
+  }) };
+  overrides.erase (overrides.begin(), first.base());
+
+  std::string json {};
+  writeOverrides (overrides.cbegin(), overrides.cend(), 0, json);
+  return json;
+}
+
+// ----------------------------------------------------------------------------
+// Source
+//
+// A file, or a document in memory when @p buffer is set, to parse with parseFiles().
+// ----------------------------------------------------------------------------
+struct Source {
+  std::filesystem::path fileName {};
+  std::string_view buffer {};
+};
+
+// ----------------------------------------------------------------------------
+// Parsed
+//
+// A file parsed by parseFiles().
+// ----------------------------------------------------------------------------
+template<typename Doc>
+struct Parsed {
+  std::optional<Doc> doc {};
+  std::unique_ptr<util::MMapFile<>> file {};
+  std::string error {};
+  std::exception_ptr exception {};
+
+  // throws the error of the file, if it could not be loaded
+  Doc & value() {
+    if (exception)
+      std::rethrow_exception (exception);
+    if (!doc.has_value())
+      throw std::runtime_error { error };
+
+    return doc.value();
+  }
+};
+
+// ----------------------------------------------------------------------------
+// parseFiles
+//
+// Maps and parses files with @p parse on up to @p threads threads, the calling
+// one included. Sources in memory are parsed as they are, without a file.
+// Every thread has its own parser, with the settings of @p parser, which
+// parses the files itself when there is a single thread.
+// Errors are kept with their file rather than thrown, so that the caller
+// reports the first one in the order of the files.
+// ----------------------------------------------------------------------------
+template<typename Doc, typename Parse>
+std::vector<Parsed<Doc>> parseFiles (
+  const std::vector<Source> &sources,
+  json::JsonParser &parser,
+  size_t threads,
+  Parse &&parse
+) {
+  std::vector<Parsed<Doc>> result (sources.size());
+
+  const auto load { [&] (json::JsonParser &p, size_t i) {
+    auto &parsed { result[i] };
+    const auto &source { sources[i] };
+    try {
+      if (source.buffer.empty()) {
+        parsed.file = std::make_unique<util::MMapFile<>>();
+        if (!parsed.file->open (source.fileName))
+          throw std::ios_base::failure { "File '" + source.fileName.string() + "' not found" };
+
+        parsed.doc = parse (p, parsed.file->data(), parsed.file->bytes());
+      }
+      else
+        parsed.doc = parse (p, source.buffer.data(), source.buffer.size());
+
+      if (!parsed.doc.has_value())
+        parsed.error = source.fileName.string() + ":" + p.error().str();
+    }
+    catch (...) {
+      parsed.exception = std::current_exception();
+    }
+  } };
+
+  threads = std::min (threads, sources.size());
+  if (threads <= 1) {
+    for (size_t i { 0 }; i < sources.size(); ++i)
+      load (parser, i);
+
+    return result;
+  }
+
+  std::atomic<size_t> next { 0 };
+  const auto work { [&] {
+    json::JsonParser own { parser.options() };
+    for (size_t i { next.fetch_add (1) }; i < sources.size(); i = next.fetch_add (1))
+      load (own, i);
+  } };
+
+  {
+    std::vector<std::jthread> pool {};
+    for (size_t t { 1 }; t < threads; ++t)
+      pool.emplace_back (work);
+    work();
+  }
+
+  return result;
+}
+
+}
+
+// ----------------------------------------------------------------------------
+// Config::Paths
+// ----------------------------------------------------------------------------
+struct Config::Paths {
+  std::mutex mutex {}; ///< Serializes the lookups.
+  std::unordered_map<std::string, const json::JsonValue *, PathHash, std::equal_to<>> values {}; ///< Value of each path, nullptr if it is not found.
+};
+
+// ----------------------------------------------------------------------------
+// Config::Arrays
+// ----------------------------------------------------------------------------
+struct Config::Arrays {
+  /// The array (see Config::_identity) and the type of its converted items.
+  using Key = std::tuple<const void *, size_t, std::type_index>;
+
+  /// Items of an array converted to a type, as std::vector. A published node is never modified.
+  struct Node {
+    Key key; ///< The array and the type.
+    std::shared_ptr<const void> items; ///< The converted items.
+    const Node *next; ///< Next node of the bucket.
+  };
+
+  static constexpr size_t kBucketBits { 6 };
+
+  std::array<std::atomic<const Node *>, size_t { 1 } << kBucketBits> buckets {}; ///< Lists of nodes, read without a lock.
+  std::mutex mutex {}; ///< Serializes the conversions.
+  std::vector<std::unique_ptr<const Node>> nodes {}; ///< Every node.
+
+  // bucket of a key; the address of a node has its low bits clear, so they are mixed first
+  static inline size_t bucket (const Key &key) noexcept {
+    const auto hash { reinterpret_cast<uintptr_t> (std::get<0> (key)) ^ std::get<1> (key) ^ std::get<2> (key).hash_code() };
+    return static_cast<size_t> ((hash * 0x9e3779b97f4a7c15ull) >> (64 - kBucketBits));
+  }
+
+  // the node of a key in the list that starts at @p node, nullptr if it is not there
+  static inline const Node * find (const Node *node, const Key &key) noexcept {
+    for (; node != nullptr; node = node->next) {
+      if (node->key == key)
+        return node;
+    }
+
+    return nullptr;
+  }
+
+  // drops the converted arrays when the values they come from are replaced, which no lookup
+  // runs concurrently with
+  inline void clear() {
+    std::lock_guard lock { mutex };
+    for (auto &head: buckets)
+      head.store (nullptr, std::memory_order_relaxed);
+    nodes.clear();
+  }
+};
+
+// ----------------------------------------------------------------------------
+// Config::Path
+// ----------------------------------------------------------------------------
+Config::Path::Path (std::string_view key): _key { key } {
+  const bool valid { splitKey (
+    key,
+    [this] (std::string_view k) {
+      _segments.push_back (Segment { .key = std::string { k }, .hash = json::JsonObject::hash (k) });
+      return true;
+    },
+    [this] (size_t index) {
+      _segments.push_back (Segment { .index = index, .item = true });
+      return true;
+    }
+  ) };
+
+  if (!valid)
+    throw std::invalid_argument { "Invalid key '" + _key + "'" };
+}
+
 // ----------------------------------------------------------------------------
 // Config::System::getHostName
 // ----------------------------------------------------------------------------
@@ -47,20 +587,130 @@ const std::string & Config::System::getEnvName() const {
   return env;
 }
 
+// ----------------------------------------------------------------------------
+// Config::System::getOverrides
+// ----------------------------------------------------------------------------
+std::vector<std::pair<std::string, std::string>> Config::System::getOverrides() const {
+  std::vector<std::pair<std::string, std::string>> result {};
+  for (char **env { environ }; (env != nullptr) && (*env != nullptr); ++env) {
+    const std::string_view variable { *env };
+    if (!variable.starts_with (kOverridePrefix))
+      continue;
+
+    const auto pos { variable.find ('=') };
+    if (pos != std::string_view::npos)
+      result.emplace_back (variable.substr (0, pos), variable.substr (pos + 1));
+  }
+
+  return result;
+}
+
+// ----------------------------------------------------------------------------
+// Constructor
+// ----------------------------------------------------------------------------
+Config::Config (const std::filesystem::path &fileName, const System &system):
+  Config { fileName, Options {}, system }
+{
+  // empty
+}
+
 // ----------------------------------------------------------------------------
 // Constructor
 // ----------------------------------------------------------------------------
-Config::Config (const std::filesystem::path &fileName, const System &system) {
+Config::Config (const std::filesystem::path &fileName, const Options &options, const System &system):
+  _arena { options.arena? std::make_unique<std::pmr::monotonic_buffer_resource>() : nullptr },
+  _parser { parserOptions (options.parser, _arena.get()) },
+  _storage { options.storage },
+  _threads { threadCount (options) },
+  _indexed { options.index && (options.storage == Options::Storage::kTree) },
+  _paths { (options.storage == Options::Storage::kLayered)? std::make_unique<Paths>() : nullptr },
+  _arrays { std::make_unique<Arrays>() }
+{
   if (std::filesystem::is_directory (fileName))
-    _loadFolder (fileName, system);
-  else
+    _loadFolder (fileName, system, options.environment);
+  else if (_storage == Options::Storage::kTape)
+    _tape = _loadTape (fileName);
+  else if (_storage == Options::Storage::kLazy)
+    _lazy = _loadLazy (fileName);
+  else if (_storage == Options::Storage::kLayered) {
+    _resetLayers();
+    loadLayer ("default", fileName);
+  }
+  else {
     _root = _loadFile (fileName);
+  }
+
+  if ((_storage == Options::Storage::kShared) && _root.has_value()) {
+    _shared.emplace (std::move (_root.value()));
+    _root.reset();
+  }
+
+  if (_indexed && _root.has_value())
+    _index.emplace (_root.value());
+}
+
+// ----------------------------------------------------------------------------
+// Constructor
+// ----------------------------------------------------------------------------
+Config::Config (const std::vector<std::filesystem::path> &fileNames): Config { fileNames, Options {} } {
+  // empty
+}
+
+// ----------------------------------------------------------------------------
+// Constructor
+// ----------------------------------------------------------------------------
+Config::Config (const std::vector<std::filesystem::path> &fileNames, const Options &options):
+  _arena { options.arena? std::make_unique<std::pmr::monotonic_buffer_resource>() : nullptr },
+  _parser { parserOptions (options.parser, _arena.get()) },
+  _storage { options.storage },
+  _threads { threadCount (options) },
+  _indexed { options.index && (options.storage == Options::Storage::kTree) },
+  _paths { (options.storage == Options::Storage::kLayered)? std::make_unique<Paths>() : nullptr },
+  _arrays { std::make_unique<Arrays>() }
+{
+  std::vector<File> files {};
+  for (const auto &fileName: fileNames) {
+    if (std::filesystem::is_directory (fileName)) {
+      for (auto &json: jsonFiles (fileName))
+        files.push_back (File { json.string(), std::move (json) });
+    }
+    else
+      files.push_back (File { fileName.string(), fileName });
+  }
+
+  if (files.empty())
+    throw std::invalid_argument { "Config requires at least one file" };
+
+  _loadFiles (files);
+
+  if ((_storage == Options::Storage::kShared) && _root.has_value()) {
+    _shared.emplace (std::move (_root.value()));
+    _root.reset();
+  }
+
+  if (_indexed && _root.has_value())
+    _index.emplace (_root.value());
+}
+
+// ----------------------------------------------------------------------------
+// Constructor
+// ----------------------------------------------------------------------------
+Config::Config (const char *buffer, size_t len): Config { buffer, len, Options {} } {
+  // empty
 }
 
 // ----------------------------------------------------------------------------
 // Constructor
 // ----------------------------------------------------------------------------
-Config::Config (const char *buffer, size_t len) {
+Config::Config (const char *buffer, size_t len, const Options &options):
+  _arena { options.arena? std::make_unique<std::pmr::monotonic_buffer_resource>() : nullptr },
+  _parser { parserOptions (options.parser, _arena.get()) },
+  _storage { options.storage },
+  _threads { threadCount (options) },
+  _indexed { options.index && (options.storage == Options::Storage::kTree) },
+  _paths { (options.storage == Options::Storage::kLayered)? std::make_unique<Paths>() : nullptr },
+  _arrays { std::make_unique<Arrays>() }
+{
   if (!parse (buffer, len? len : std::strlen (buffer))) {
     throw std::runtime_error {
       "Parse error:" + std::to_string (_parser.error().line) + ", " + std::to_string (_parser.error().column)
@@ -68,127 +718,485 @@ Config::Config (const char *buffer, size_t len) {
   }
 }
 
+Config::Config (Config &&) noexcept = default;
+Config & Config::operator= (Config &&) noexcept = default;
+Config::~Config() = default;
+
 // ----------------------------------------------------------------------------
 // Config::parse
 // ----------------------------------------------------------------------------
 bool Config::parse (const char *buffer, size_t len) {
+  if (_storage == Options::Storage::kLayered) {
+    // the layers are replaced only if the document is valid
+    auto doc { _parser.parse (buffer, len? len : std::strlen (buffer)) };
+    if (!doc.has_value())
+      return false;
+
+    _resetLayers();
+    _setLayer ("default", std::move (doc.value()), nullptr);
+    return true;
+  }
+
+  _arrays->clear();
+
+  if (_storage == Options::Storage::kTape) {
+    _tape = _parser.parseTape (buffer, len? len : std::strlen (buffer));
+    return _tape.has_value();
+  }
+
+  if (_storage == Options::Storage::kLazy) {
+    // the values are parsed from the buffer when they are requested, so it is copied; the
+    // previous copy is released after the document that references it
+    auto copy { std::make_unique<const std::string> (buffer, len? len : std::strlen (buffer)) };
+    _lazy = _parser.parseLazy (copy->data(), copy->size());
+    _buffer = std::move (copy);
+    return _lazy.has_value();
+  }
+
+  // the index points to the values that are replaced
+  _index.reset();
+
   _root = _parser.parse (buffer, len? len : std::strlen (buffer));
   if (!_root.has_value())
     return false;
+
+  if (_indexed)
+    _index.emplace (_root.value());
+
+  if (_storage == Options::Storage::kShared) {
+    _shared.emplace (std::move (_root.value()));
+    _root.reset();
+  }
+
   return true;
 }
 
+// ----------------------------------------------------------------------------
+// Config::loadLayer
+// ----------------------------------------------------------------------------
+void Config::loadLayer (std::string_view name, const std::filesystem::path &fileName) {
+  if (_storage != Options::Storage::kLayered)
+    throw std::logic_error { "Config::loadLayer requires Options::Storage::kLayered" };
+
+  auto doc { _loadFile (fileName) };
+  if (!doc.has_value())
+    throw std::runtime_error { fileName.string() + ":" + _parser.error().str() };
+
+  // the mapped file belongs to the layer, and is released when the layer is replaced
+  std::unique_ptr<util::MMapFile<>> file {};
+  if (_parser.options().tokenizer.zeroCopy) {
+    file = std::move (_mappedFiles.back());
+    _mappedFiles.pop_back();
+  }
+
+  _setLayer (name, std::move (doc.value()), std::move (file));
+}
+
+// ----------------------------------------------------------------------------
+// Config::parseLayer
+// ----------------------------------------------------------------------------
+bool Config::parseLayer (std::string_view name, const char *buffer, size_t len) {
+  if (_storage != Options::Storage::kLayered)
+    throw std::logic_error { "Config::parseLayer requires Options::Storage::kLayered" };
+
+  auto doc { _parser.parse (buffer, len? len : std::strlen (buffer)) };
+  if (!doc.has_value())
+    return false;
+
+  _setLayer (name, std::move (doc.value()), nullptr);
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+// Config::removeLayer
+// ----------------------------------------------------------------------------
+bool Config::removeLayer (std::string_view name) {
+  if (_storage != Options::Storage::kLayered)
+    throw std::logic_error { "Config::removeLayer requires Options::Storage::kLayered" };
+
+  _arrays->clear();
+
+  std::lock_guard lock { _paths->mutex };
+  _paths->values.clear();
+
+  if (!_layered.value().remove (name))
+    return false;
+
+  if (const auto it { _layerFiles.find (name) }; it != _layerFiles.end())
+    _layerFiles.erase (it);
+
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+// Config::set
+// ----------------------------------------------------------------------------
+bool Config::set (std::string_view key, const json::JsonValue &value) {
+  if (_storage != Options::Storage::kShared)
+    throw std::logic_error { "Config::set requires Options::Storage::kShared" };
+
+  std::vector<json::SharedValue::Step> path {};
+  const bool valid { splitKey (
+    key,
+    [&path] (std::string_view k) { path.emplace_back (std::string { k }); return true; },
+    [&path] (size_t index) { path.emplace_back (index); return true; }
+  ) };
+
+  if (!valid)
+    return false;
+
+  auto version { _shared.value().set (path, json::SharedValue { value }) };
+  if (!version.has_value())
+    return false;
+
+  _arrays->clear();
+  _shared = std::move (version);
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+// Config::snapshot
+// ----------------------------------------------------------------------------
+json::SharedValue Config::snapshot() const {
+  if (_storage != Options::Storage::kShared)
+    throw std::logic_error { "Config::snapshot requires Options::Storage::kShared" };
+
+  return _shared.value();
+}
+
+// ----------------------------------------------------------------------------
+// Config::trie
+// ----------------------------------------------------------------------------
+json::PathTrie Config::trie() const {
+  if (_storage != Options::Storage::kTree)
+    throw std::logic_error { "Config::trie requires Options::Storage::kTree" };
+
+  return json::PathTrie { _root.value() };
+}
+
 // ----------------------------------------------------------------------------
 // Config::_getJsonValue
 // ----------------------------------------------------------------------------
 std::optional<std::reference_wrapper<const json::JsonValue>> Config::_getJsonValue (const std::string_view &sv) const {
-  std::reference_wrapper<const json::JsonValue> v { _root.value() };
+  // keys that are not written as the index writes them are walked
+  if (_index.has_value()) {
+    if (const auto *value { _index.value().find (sv) }; value != nullptr)
+      return *value;
+  }
 
-  int32_t index { -1 };
-  std::string str {};
-  str.reserve (sv.size());
-  for (size_t i { 0 }; i < sv.size(); ++i) {
-    if ((sv[i] == '\\') && (sv.size() > i + 1) && (sv[i + 1] == '.')) {
-      ++i;
-      str.push_back('.');
-    }
-    else if ((sv[i] == '.') || (sv[i] == ']')) {
-      if (!str.empty()) {
-        if (!v.get().exists (str))
-          return std::nullopt;
+  const auto cursor { walk (TreeCursor { _root.value() }, sv) };
+  if (!cursor.has_value())
+    return std::nullopt;
 
-        v = v.get()[str];
+  return cursor.value().value;
+}
 
-        str.clear();
-      }
+std::optional<std::reference_wrapper<const json::JsonValue>> Config::_getJsonValue (const Path &path) const {
+  if (_index.has_value()) {
+    if (const auto *value { _index.value().find (path.str()) }; value != nullptr)
+      return *value;
+  }
 
-      if (index != -1) {
-        if (!v.get().isArray() || (index >= std::ssize (v.get().asArray())))
-          return std::nullopt;
+  const auto cursor { walk (TreeCursor { _root.value() }, path) };
+  if (!cursor.has_value())
+    return std::nullopt;
 
-        v = v.get()[index];
+  return cursor.value().value;
+}
 
-        index = -1;
-      }
-    }
-    else if ((sv[i] == '[')) {
-      index = 0;
-      for (i = i + 1; i < sv.size(); ++i) {
-        if (std::isdigit (sv[i])) {
-          index = index * 10 + (static_cast<size_t>(sv[i]) - 48);
-        }
-        else if (sv[i] == ']') {
-          --i;
-          break;
-        }
-        else {
-          return std::nullopt;
-        }
-      }
-    }
-    else {
-      str.push_back (sv[i]);
+// ----------------------------------------------------------------------------
+// Config::_getTapeValue
+// ----------------------------------------------------------------------------
+std::optional<json::Tape::Value> Config::_getTapeValue (const std::string_view &sv) const {
+  return walk (_tape.value().root(), sv);
+}
+
+std::optional<json::Tape::Value> Config::_getTapeValue (const Path &path) const {
+  return walk (_tape.value().root(), path);
+}
+
+// ----------------------------------------------------------------------------
+// Config::_getLazyValue
+// ----------------------------------------------------------------------------
+std::optional<std::reference_wrapper<const json::JsonValue>> Config::_getLazyValue (const std::string_view &sv) const {
+  const auto cursor { walk (_lazy.value().root(), sv) };
+  if (!cursor.has_value())
+    return std::nullopt;
+
+  return _lazy.value().value (cursor.value());
+}
+
+std::optional<std::reference_wrapper<const json::JsonValue>> Config::_getLazyValue (const Path &path) const {
+  const auto cursor { walk (_lazy.value().root(), path) };
+  if (!cursor.has_value())
+    return std::nullopt;
+
+  return _lazy.value().value (cursor.value());
+}
+
+// ----------------------------------------------------------------------------
+// Config::_getLayeredValue
+// ----------------------------------------------------------------------------
+std::optional<std::reference_wrapper<const json::JsonValue>> Config::_getLayeredValue (const std::string_view &sv) const {
+  std::lock_guard lock { _paths->mutex };
+
+  auto it { _paths->values.find (sv) };
+  if (it == _paths->values.end()) {
+    const auto &doc { _layered.value() };
+
+    const json::JsonValue *value { nullptr };
+    if (doc.size() > 0) {
+      if (const auto cursor { walk (doc.root(), sv) }; cursor.has_value())
+        value = &doc.value (cursor.value());
     }
+
+    it = _paths->values.emplace (std::string { sv }, value).first;
   }
 
-  if (!str.empty()) {
-    if (!v.get().exists (str))
-      return std::nullopt;
+  if (it->second == nullptr)
+    return std::nullopt;
 
-    v = v.get()[str];
-  }
+  return *it->second;
+}
 
-  if (index != -1) {
-    if (!v.get().isArray() || (index >= std::ssize (v.get().asArray())))
-      return std::nullopt;
+std::optional<std::reference_wrapper<const json::JsonValue>> Config::_getLayeredValue (const Path &path) const {
+  // lookups are memoized by key
+  return _getLayeredValue (path.str());
+}
 
-    v = v.get()[index];
-  }
+// ----------------------------------------------------------------------------
+// Config::_getSharedValue
+// ----------------------------------------------------------------------------
+const json::SharedValue * Config::_getSharedValue (const std::string_view &sv) const {
+  const auto cursor { walk (SharedCursor { &_shared.value() }, sv) };
+  if (!cursor.has_value())
+    return nullptr;
 
-  return v;
+  return cursor.value().value;
+}
+
+const json::SharedValue * Config::_getSharedValue (const Path &path) const {
+  const auto cursor { walk (SharedCursor { &_shared.value() }, path) };
+  if (!cursor.has_value())
+    return nullptr;
+
+  return cursor.value().value;
+}
+
+// ----------------------------------------------------------------------------
+// Config::_array
+// ----------------------------------------------------------------------------
+const void * Config::_array (
+  std::pair<const void *, size_t> id,
+  const std::type_info &type,
+  std::shared_ptr<const void> (*convert) (const void *),
+  const void *node
+) const {
+  const Arrays::Key key { id.first, id.second, std::type_index { type } };
+  auto &head { _arrays->buckets[Arrays::bucket (key)] };
+
+  // the arrays converted before are found without a lock
+  if (const auto *found { Arrays::find (head.load (std::memory_order_acquire), key) }; found != nullptr)
+    return found->items.get();
+
+  std::lock_guard lock { _arrays->mutex };
+
+  // another thread may have converted it meanwhile
+  const auto *first { head.load (std::memory_order_relaxed) };
+  if (const auto *found { Arrays::find (first, key) }; found != nullptr)
+    return found->items.get();
+
+  // the node is complete before it is published
+  const auto &added { _arrays->nodes.emplace_back (std::make_unique<const Arrays::Node> (Arrays::Node { key, convert (node), first })) };
+  head.store (added.get(), std::memory_order_release);
+
+  return added->items.get();
+}
+
+// ----------------------------------------------------------------------------
+// Config::_resetLayers
+// ----------------------------------------------------------------------------
+void Config::_resetLayers() {
+  _arrays->clear();
+
+  // the memoized lookups point into the layers that are destroyed
+  std::lock_guard lock { _paths->mutex };
+  _paths->values.clear();
+
+  _layered.emplace();
+  _layerFiles.clear();
+}
+
+// ----------------------------------------------------------------------------
+// Config::_setLayer
+// ----------------------------------------------------------------------------
+void Config::_setLayer (
+  std::string_view name,
+  json::JsonValue &&value,
+  std::unique_ptr<util::MMapFile<>> &&file,
+  json::JsonValue::Arrays arrays
+) {
+  _arrays->clear();
+
+  std::lock_guard lock { _paths->mutex };
+  _paths->values.clear();
+
+  _layered.value().set (name, std::move (value), arrays);
+
+  // the previous file of the layer is not referenced anymore
+  if (const auto it { _layerFiles.find (name) }; it != _layerFiles.end())
+    _layerFiles.erase (it);
+  if (file != nullptr)
+    _layerFiles.emplace (std::string { name }, std::move (file));
 }
 
 // ----------------------------------------------------------------------------
 // Config::_loadFile
 // ----------------------------------------------------------------------------
 std::optional<json::JsonValue> Config::_loadFile (const std::filesystem::path &fileName) {
+  auto mmFile { std::make_unique<util::MMapFile<>>() };
+
+  if (!mmFile->open (fileName))
+    throw std::ios_base::failure { "File '" + fileName.string() + "' not found" };
+
+  auto doc { _parser.parse (mmFile->data(), mmFile->bytes()) };
+
+  // zero-copy strings reference the mapped file, so it is kept open as long as the configuration
+  if (doc.has_value() && _parser.options().tokenizer.zeroCopy)
+    _mappedFiles.push_back (std::move (mmFile));
+
+  return doc;
+}
+
+// ----------------------------------------------------------------------------
+// Config::_loadTape
+// ----------------------------------------------------------------------------
+std::optional<json::Tape> Config::_loadTape (const std::filesystem::path &fileName) {
   util::MMapFile<> mmFile {};
 
   if (!mmFile.open (fileName))
     throw std::ios_base::failure { "File '" + fileName.string() + "' not found" };
 
-  return _parser.parse (mmFile.data(), mmFile.bytes());
+  // the tape copies every string to its arena, so the file is not needed afterwards
+  return _parser.parseTape (mmFile.data(), mmFile.bytes());
+}
+
+// ----------------------------------------------------------------------------
+// Config::_loadLazy
+// ----------------------------------------------------------------------------
+std::optional<json::LazyDocument> Config::_loadLazy (const std::filesystem::path &fileName) {
+  auto mmFile { std::make_unique<util::MMapFile<>>() };
+
+  if (!mmFile->open (fileName))
+    throw std::ios_base::failure { "File '" + fileName.string() + "' not found" };
+
+  auto doc { _parser.parseLazy (mmFile->data(), mmFile->bytes()) };
+
+  // values are parsed from the mapped file when they are requested
+  if (doc.has_value())
+    _mappedFiles.push_back (std::move (mmFile));
+
+  return doc;
+}
+
+// ----------------------------------------------------------------------------
+// Config::_loadFiles
+// ----------------------------------------------------------------------------
+void Config::_loadFiles (const std::vector<File> &files) {
+  std::vector<Source> sources {};
+  for (const auto &file: files)
+    sources.push_back (Source { file.fileName, file.buffer });
+
+  const bool zeroCopy { _parser.options().tokenizer.zeroCopy };
+
+  if (_storage == Options::Storage::kTape) {
+    auto tapes { parseFiles<json::Tape> (sources, _parser, _threads, [] (json::JsonParser &parser, const char *data, size_t size) {
+      return parser.parseTape (data, size);
+    }) };
+
+    // the tape copies every string to its arena, so the files are not needed afterwards
+    _tape = std::move (tapes[0].value());
+    for (size_t i { 1 }; i < tapes.size(); ++i)
+      _tape = json::Tape::merge (tapes[i].value(), _tape.value(), files[i].arrays);
+
+    return;
+  }
+
+  if (_storage == Options::Storage::kLazy) {
+    auto docs { parseFiles<json::LazyDocument> (sources, _parser, _threads, [] (json::JsonParser &parser, const char *data, size_t size) {
+      return parser.parseLazy (data, size);
+    }) };
+
+    // values are parsed from the mapped files when they are requested
+    _lazy = std::move (docs[0].value());
+    _mappedFiles.push_back (std::move (docs[0].file));
+    for (size_t i { 1 }; i < docs.size(); ++i) {
+      _lazy.value().overlay (std::move (docs[i].value()), files[i].arrays);
+      if (docs[i].file)
+        _mappedFiles.push_back (std::move (docs[i].file));
+    }
+
+    return;
+  }
+
+  auto docs { parseFiles<json::JsonValue> (sources, _parser, _threads, [] (json::JsonParser &parser, const char *data, size_t size) {
+    return parser.parse (data, size);
+  }) };
+
+  if (_storage == Options::Storage::kLayered) {
+    _resetLayers();
+
+    // the mapped file belongs to the layer, and is released when the layer is replaced
+    for (size_t i { 0 }; i < docs.size(); ++i)
+      _setLayer (files[i].name, std::move (docs[i].value()), zeroCopy? std::move (docs[i].file) : nullptr, files[i].arrays);
+
+    return;
+  }
+
+  // zero-copy strings reference the mapped files, so they are kept open as long as the configuration
+  _root = std::move (docs[0].value());
+  if (zeroCopy)
+    _mappedFiles.push_back (std::move (docs[0].file));
+
+  for (size_t i { 1 }; i < docs.size(); ++i) {
+    json::JsonValue::merge (std::move (docs[i].value()), _root.value(), files[i].arrays);
+    if (zeroCopy && docs[i].file)
+      _mappedFiles.push_back (std::move (docs[i].file));
+  }
 }
 
 // ----------------------------------------------------------------------------
 // Config::_loadFolder
 // ----------------------------------------------------------------------------
-void Config::_loadFolder (const std::filesystem::path &folderName, const System &system) {
-  const auto defaultFileName { folderName / "default.json" };
+void Config::_loadFolder (const std::filesystem::path &folderName, const System &system, bool environment) {
   const auto envFileName { (folderName / system.getEnvName()).replace_extension ("json") };
   const auto hostFileName { (folderName / system.getHostName()).replace_extension ("json") };
 
-  _root = _loadFile (defaultFileName);
-  if (!_root.has_value())
-    throw std::runtime_error { defaultFileName.string() + ":" + _parser.error().str() };
-
-  if (std::filesystem::exists (envFileName)) {
-    auto envDoc = _loadFile (envFileName);
+  std::vector<File> files { File { "default", folderName / "default.json" } };
 
-    if (!envDoc.has_value())
-      throw std::runtime_error { envFileName.string() + ":" + _parser.error().str() };
-
-    json::JsonValue::merge (envDoc.value(), _root.value());
+  // the drop-in files extend the defaults, and are overridden by the environment and host files
+  if (const auto dropIns { folderName / "conf.d" }; std::filesystem::is_directory (dropIns)) {
+    for (auto &fileName: jsonFiles (dropIns))
+      files.push_back (File { "conf.d/" + fileName.filename().string(), std::move (fileName) });
   }
 
-  if (std::filesystem::exists (hostFileName)) {
-    auto hostDoc = _loadFile (hostFileName);
+  if (std::filesystem::exists (envFileName))
+    files.push_back (File { system.getEnvName(), envFileName });
 
-    if (!hostDoc.has_value())
-      throw std::runtime_error { hostFileName.string() + ":" + _parser.error().str() };
+  if (std::filesystem::exists (hostFileName))
+    files.push_back (File { system.getHostName(), hostFileName });
 
-    json::JsonValue::merge (hostDoc.value(), _root.value());
+  // the environment variables are gathered in one document, merged last; the buffer is kept for
+  // the values that reference it (zero-copy strings, lazy storage). Their arrays replace the ones
+  // of the files, as any other value.
+  if (environment) {
+    if (auto json { overridesDocument (system.getOverrides()) }; !json.empty()) {
+      _overrides = std::make_unique<const std::string> (std::move (json));
+      files.push_back (File { "environment", "environment", *_overrides, json::JsonValue::Arrays::kReplace });
+    }
   }
+
+  _loadFiles (files);
 }
 
 }
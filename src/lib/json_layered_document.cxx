@@ -0,0 +1,193 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#include <algorithm>
+#include <map>
+#include <mutex>
+
+#include <cppconfig/json_layered_document.h>
+
+
+namespace cppconfig::json {
+
+namespace {
+
+// ----------------------------------------------------------------------------
+// kind
+//
+// Containers of the same kind are combined, any other value replaces the ones below.
+// ----------------------------------------------------------------------------
+char kind (const JsonValue &value) {
+  if (value.isObject()) return '{';
+  if (value.isArray()) return '[';
+  if (value.isString()) return '"';
+  if (value.isNull()) return 'n';
+  if (value.isBool()) return 't';
+  if (value.isInt()) return 'l';
+  return 'd';
+}
+
+}
+
+// ----------------------------------------------------------------------------
+// LayeredDocument::Cache
+// ----------------------------------------------------------------------------
+struct LayeredDocument::Cache {
+  std::mutex mutex {}; ///< Serializes the merges.
+  std::map<std::vector<const JsonValue *>, JsonValue> merged {}; ///< Values combined from several layers.
+};
+
+// ----------------------------------------------------------------------------
+// Constructor
+// ----------------------------------------------------------------------------
+LayeredDocument::LayeredDocument(): _cache { std::make_unique<Cache>() } {
+  // empty
+}
+
+LayeredDocument::LayeredDocument (LayeredDocument &&) noexcept = default;
+LayeredDocument & LayeredDocument::operator= (LayeredDocument &&) noexcept = default;
+LayeredDocument::~LayeredDocument() = default;
+
+// ----------------------------------------------------------------------------
+// LayeredDocument::root
+// ----------------------------------------------------------------------------
+LayeredDocument::Cursor LayeredDocument::root() const {
+  std::vector<const JsonValue *> values {};
+  for (const auto &layer: _layers)
+    values.push_back (&layer.value);
+
+  return Cursor { this, _fold (std::move (values)) };
+}
+
+// ----------------------------------------------------------------------------
+// LayeredDocument::value
+// ----------------------------------------------------------------------------
+const JsonValue & LayeredDocument::value (const Cursor &cursor) const {
+  std::vector<size_t> layers {};
+  for (size_t i { 0 }; i < cursor._values.size(); ++i) {
+    if (cursor._values[i] != nullptr)
+      layers.push_back (i);
+  }
+
+  if (layers.size() == 1)
+    return *cursor._values[layers.front()];
+
+  // containers of the same kind in several layers
+  std::lock_guard lock { _cache->mutex };
+
+  if (const auto it { _cache->merged.find (cursor._values) }; it != _cache->merged.end())
+    return it->second;
+
+  JsonValue value { *cursor._values[layers.front()] };
+  for (size_t i { 1 }; i < layers.size(); ++i)
+    JsonValue::merge (*cursor._values[layers[i]], value, _layers[layers[i]].arrays);
+
+  return _cache->merged.emplace (cursor._values, std::move (value)).first->second;
+}
+
+// ----------------------------------------------------------------------------
+// LayeredDocument::set
+// ----------------------------------------------------------------------------
+void LayeredDocument::set (std::string_view name, JsonValue &&value, JsonValue::Arrays arrays) {
+  _cache->merged.clear();
+
+  const auto it { std::find_if (_layers.begin(), _layers.end(), [name] (const Layer &layer) {
+    return layer.name == name;
+  }) };
+
+  if (it != _layers.end()) {
+    it->value = std::move (value);
+    it->arrays = arrays;
+  }
+  else {
+    _layers.push_back (Layer { std::string { name }, std::move (value), arrays });
+  }
+}
+
+// ----------------------------------------------------------------------------
+// LayeredDocument::remove
+// ----------------------------------------------------------------------------
+bool LayeredDocument::remove (std::string_view name) {
+  const auto it { std::find_if (_layers.begin(), _layers.end(), [name] (const Layer &layer) {
+    return layer.name == name;
+  }) };
+
+  if (it == _layers.end())
+    return false;
+
+  _cache->merged.clear();
+  _layers.erase (it);
+
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+// LayeredDocument::Cursor::find
+// ----------------------------------------------------------------------------
+std::optional<LayeredDocument::Cursor> LayeredDocument::Cursor::find (std::string_view key) const {
+  std::vector<const JsonValue *> values (_values.size(), nullptr);
+  bool found { false };
+
+  for (size_t i { 0 }; i < _values.size(); ++i) {
+    if (_values[i] != nullptr) {
+      values[i] = _values[i]->find (key);
+      found = found || (values[i] != nullptr);
+    }
+  }
+
+  if (!found)
+    return std::nullopt;
+
+  return Cursor { _doc, _doc->_fold (std::move (values)) };
+}
+
+// ----------------------------------------------------------------------------
+// LayeredDocument::Cursor::at
+// ----------------------------------------------------------------------------
+std::optional<LayeredDocument::Cursor> LayeredDocument::Cursor::at (size_t n) const {
+  for (size_t i { 0 }; i < _values.size(); ++i) {
+    if ((_values[i] == nullptr) || !_values[i]->isArray())
+      continue;
+
+    const auto &items { _values[i]->asArray() };
+    if (n < items.size()) {
+      std::vector<const JsonValue *> values (_values.size(), nullptr);
+      values[i] = &items[n];
+      return Cursor { _doc, std::move (values) };
+    }
+
+    n -= items.size();
+  }
+
+  return std::nullopt;
+}
+
+// ----------------------------------------------------------------------------
+// LayeredDocument::_fold
+//
+// Mirrors JsonValue::merge applied from the lowest layer up: containers of the
+// same kind are combined, except arrays of a layer that replaces them, and any
+// other value replaces the values below.
+// ----------------------------------------------------------------------------
+std::vector<const JsonValue *> LayeredDocument::_fold (std::vector<const JsonValue *> &&values) const {
+  char base { 0 };
+
+  for (size_t i { 0 }; i < values.size(); ++i) {
+    if (values[i] == nullptr)
+      continue;
+
+    const auto k { kind (*values[i]) };
+    const bool combined { (k == base) && ((k == '{') || ((k == '[') && (_layers[i].arrays == JsonValue::Arrays::kAppend))) };
+
+    if ((base != 0) && !combined)
+      std::fill (values.begin(), values.begin() + static_cast<std::ptrdiff_t> (i), nullptr);
+
+    base = k;
+  }
+
+  return std::move (values);
+}
+
+}
@@ -0,0 +1,348 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+#include <cppconfig/json_lazy_document.h>
+#include <cppconfig/json_parser.h>
+
+
+namespace cppconfig::json {
+
+namespace {
+
+// ----------------------------------------------------------------------------
+// isSpace
+// ----------------------------------------------------------------------------
+inline bool isSpace (char c) {
+  return (c == ' ') || (c == '\n') || (c == '\r') || (c == '\t');
+}
+
+// ----------------------------------------------------------------------------
+// skipSpace
+// ----------------------------------------------------------------------------
+inline size_t skipSpace (std::string_view data, size_t offset) {
+  while ((offset < data.size()) && isSpace (data[offset]))
+    ++offset;
+  return offset;
+}
+
+// ----------------------------------------------------------------------------
+// skipString
+//
+// Returns the offset that follows the closing quote of the string at @p offset.
+// ----------------------------------------------------------------------------
+inline size_t skipString (std::string_view data, size_t offset) {
+  for (offset = data.find_first_of ("\"\\", offset + 1); data[offset] == '\\'; offset = data.find_first_of ("\"\\", offset + 2)) {
+    // empty
+  }
+
+  return offset + 1;
+}
+
+// ----------------------------------------------------------------------------
+// kind
+//
+// Containers of the same kind are combined, any other value replaces the ones
+// below: 'l' and 'd' tell integers and floating-point numbers apart.
+// ----------------------------------------------------------------------------
+char kind (std::string_view data, size_t offset) {
+  switch (data[offset]) {
+    case '{':
+    case '[':
+    case '"':
+    case 'n':
+      return data[offset];
+    case 't':
+    case 'f':
+      return 't';
+    default:
+      for (; (offset < data.size()) && !isSpace (data[offset]); ++offset) {
+        if ((data[offset] == ',') || (data[offset] == '}') || (data[offset] == ']'))
+          break;
+        if ((data[offset] == '.') || (data[offset] == 'e') || (data[offset] == 'E'))
+          return 'd';
+      }
+      return 'l';
+  }
+}
+
+// ----------------------------------------------------------------------------
+// KeyHash
+//
+// Lets the keys of the scanned objects be looked up with a std::string_view.
+// ----------------------------------------------------------------------------
+struct KeyHash {
+  using is_transparent = void;
+
+  inline size_t operator() (std::string_view k) const noexcept { return std::hash<std::string_view> {} (k); }
+};
+
+}
+
+// ----------------------------------------------------------------------------
+// LazyDocument::Members
+// ----------------------------------------------------------------------------
+struct LazyDocument::Members {
+  std::unordered_map<std::string, size_t, KeyHash, std::equal_to<>> keys {}; ///< Offset of the value of each member; the first one wins.
+  std::vector<size_t> items {}; ///< Offset of each item of an array.
+};
+
+// ----------------------------------------------------------------------------
+// LazyDocument::Cache
+// ----------------------------------------------------------------------------
+struct LazyDocument::Cache {
+  JsonParser::Options options {}; ///< Settings used to parse the requested values.
+  std::mutex mutex {}; ///< Serializes the lookups.
+  std::vector<std::unordered_map<size_t, Members>> members {}; ///< Scanned containers of each layer.
+  std::vector<std::unordered_map<size_t, JsonValue>> values {}; ///< Parsed values of each layer.
+  std::map<std::vector<size_t>, JsonValue> merged {}; ///< Values combined from several layers.
+};
+
+// ----------------------------------------------------------------------------
+// Constructor
+// ----------------------------------------------------------------------------
+LazyDocument::LazyDocument (const JsonParser &parser, Layer &&layer): _cache { std::make_unique<Cache>() } {
+  _cache->options = parser.options();
+  _cache->members.resize (1);
+  _cache->values.resize (1);
+
+  _layers.push_back (std::move (layer));
+}
+
+LazyDocument::LazyDocument (LazyDocument &&) noexcept = default;
+LazyDocument & LazyDocument::operator= (LazyDocument &&) noexcept = default;
+LazyDocument::~LazyDocument() = default;
+
+// ----------------------------------------------------------------------------
+// LazyDocument::root
+// ----------------------------------------------------------------------------
+LazyDocument::Cursor LazyDocument::root() const {
+  std::vector<size_t> offsets {};
+  for (const auto &layer: _layers)
+    offsets.push_back (layer.containers.front().begin);
+
+  return Cursor { this, _fold (std::move (offsets)) };
+}
+
+// ----------------------------------------------------------------------------
+// LazyDocument::value
+// ----------------------------------------------------------------------------
+const JsonValue & LazyDocument::value (const Cursor &cursor) const {
+  std::lock_guard lock { _cache->mutex };
+
+  std::vector<size_t> layers {};
+  for (size_t i { 0 }; i < cursor._offsets.size(); ++i) {
+    if (cursor._offsets[i] != kNone)
+      layers.push_back (i);
+  }
+
+  const auto get { [this] (size_t layer, size_t offset) -> const JsonValue & {
+    auto &values { _cache->values[layer] };
+    if (const auto it { values.find (offset) }; it != values.end())
+      return it->second;
+
+    return values.emplace (offset, _parse (layer, offset)).first->second;
+  } };
+
+  if (layers.size() == 1)
+    return get (layers.front(), cursor._offsets[layers.front()]);
+
+  // containers of the same kind in several layers
+  if (const auto it { _cache->merged.find (cursor._offsets) }; it != _cache->merged.end())
+    return it->second;
+
+  JsonValue value { get (layers.front(), cursor._offsets[layers.front()]) };
+  for (size_t i { 1 }; i < layers.size(); ++i)
+    JsonValue::merge (get (layers[i], cursor._offsets[layers[i]]), value, _layers[layers[i]].arrays);
+
+  return _cache->merged.emplace (cursor._offsets, std::move (value)).first->second;
+}
+
+// ----------------------------------------------------------------------------
+// LazyDocument::overlay
+// ----------------------------------------------------------------------------
+void LazyDocument::overlay (LazyDocument &&doc, JsonValue::Arrays arrays) {
+  for (auto &layer: doc._layers) {
+    layer.arrays = arrays;
+    _layers.push_back (std::move (layer));
+  }
+
+  _cache->members.resize (_layers.size());
+  _cache->values.resize (_layers.size());
+  _cache->merged.clear();
+}
+
+// ----------------------------------------------------------------------------
+// LazyDocument::Cursor::find
+// ----------------------------------------------------------------------------
+std::optional<LazyDocument::Cursor> LazyDocument::Cursor::find (std::string_view key) const {
+  std::lock_guard lock { _doc->_cache->mutex };
+
+  std::vector<size_t> offsets (_offsets.size(), kNone);
+  bool found { false };
+
+  for (size_t i { 0 }; i < _offsets.size(); ++i) {
+    if ((_offsets[i] == kNone) || (_doc->_layers[i].data[_offsets[i]] != '{'))
+      continue;
+
+    const auto &keys { _doc->_members (i, _offsets[i]).keys };
+    if (const auto it { keys.find (key) }; it != keys.end()) {
+      offsets[i] = it->second;
+      found = true;
+    }
+  }
+
+  if (!found)
+    return std::nullopt;
+
+  return Cursor { _doc, _doc->_fold (std::move (offsets)) };
+}
+
+// ----------------------------------------------------------------------------
+// LazyDocument::Cursor::at
+// ----------------------------------------------------------------------------
+std::optional<LazyDocument::Cursor> LazyDocument::Cursor::at (size_t n) const {
+  std::lock_guard lock { _doc->_cache->mutex };
+
+  for (size_t i { 0 }; i < _offsets.size(); ++i) {
+    if ((_offsets[i] == kNone) || (_doc->_layers[i].data[_offsets[i]] != '['))
+      continue;
+
+    const auto &items { _doc->_members (i, _offsets[i]).items };
+    if (n < items.size()) {
+      std::vector<size_t> offsets (_offsets.size(), kNone);
+      offsets[i] = items[n];
+      return Cursor { _doc, std::move (offsets) };
+    }
+
+    n -= items.size();
+  }
+
+  return std::nullopt;
+}
+
+// ----------------------------------------------------------------------------
+// LazyDocument::_fold
+//
+// Mirrors JsonValue::merge applied from the lowest layer up: containers of the
+// same kind are combined, except arrays of a layer that replaces them, and any
+// other value replaces the values below.
+// ----------------------------------------------------------------------------
+std::vector<size_t> LazyDocument::_fold (std::vector<size_t> &&offsets) const {
+  char base { 0 };
+
+  for (size_t i { 0 }; i < offsets.size(); ++i) {
+    if (offsets[i] == kNone)
+      continue;
+
+    const auto k { kind (_layers[i].data, offsets[i]) };
+    const bool combined { (k == base) && ((k == '{') || ((k == '[') && (_layers[i].arrays == JsonValue::Arrays::kAppend))) };
+
+    if ((base != 0) && !combined)
+      std::fill (offsets.begin(), offsets.begin() + static_cast<std::ptrdiff_t> (i), kNone);
+
+    base = k;
+  }
+
+  return std::move (offsets);
+}
+
+// ----------------------------------------------------------------------------
+// LazyDocument::_members
+// ----------------------------------------------------------------------------
+const LazyDocument::Members & LazyDocument::_members (size_t layer, size_t offset) const {
+  auto &scanned { _cache->members[layer] };
+  if (const auto it { scanned.find (offset) }; it != scanned.end())
+    return it->second;
+
+  const auto data { _layers[layer].data };
+  const bool object { data[offset] == '{' };
+  const size_t end { _end (layer, offset) };
+
+  Members members {};
+
+  // the input was validated when it was loaded
+  for (size_t p { skipSpace (data, offset + 1) }; p < end; p = skipSpace (data, p)) {
+    if (object) {
+      const size_t q { skipString (data, p) };
+      const auto key { data.substr (p + 1, q - p - 2) };
+
+      if (key.find ('\\') == std::string_view::npos) {
+        members.keys.try_emplace (std::string { key }, skipSpace (data, skipSpace (data, q) + 1));
+      }
+      else {
+        JsonTokenizer tokenizer { Buffer { data.data() + p, q - p }, JsonTokenizer::Options {} };
+        members.keys.try_emplace (tokenizer.next()->takeString(), skipSpace (data, skipSpace (data, q) + 1));
+      }
+
+      p = skipSpace (data, skipSpace (data, q) + 1);
+    }
+    else {
+      members.items.push_back (p);
+    }
+
+    p = skipSpace (data, _skip (layer, p));
+    if (data[p] == ',')
+      ++p;
+  }
+
+  return scanned.emplace (offset, std::move (members)).first->second;
+}
+
+// ----------------------------------------------------------------------------
+// LazyDocument::_end
+// ----------------------------------------------------------------------------
+size_t LazyDocument::_end (size_t layer, size_t offset) const {
+  const auto &containers { _layers[layer].containers };
+
+  const auto it { std::lower_bound (containers.begin(), containers.end(), offset, [] (const Container &c, size_t o) {
+    return c.begin < o;
+  }) };
+
+  return it->end;
+}
+
+// ----------------------------------------------------------------------------
+// LazyDocument::_skip
+// ----------------------------------------------------------------------------
+size_t LazyDocument::_skip (size_t layer, size_t offset) const {
+  const auto data { _layers[layer].data };
+
+  switch (data[offset]) {
+    case '{':
+    case '[':
+      return _end (layer, offset) + 1;
+    case '"':
+      return skipString (data, offset);
+    default:
+      while ((offset < data.size()) && !isSpace (data[offset]) && (data[offset] != ',') && (data[offset] != '}') && (data[offset] != ']'))
+        ++offset;
+      return offset;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// LazyDocument::_parse
+// ----------------------------------------------------------------------------
+JsonValue LazyDocument::_parse (size_t layer, size_t offset) const {
+  const auto data { _layers[layer].data };
+
+  if ((data[offset] == '{') || (data[offset] == '[')) {
+    JsonParser parser { _cache->options };
+    return std::move (parser.parse (data.data() + offset, _end (layer, offset) - offset + 1).value());
+  }
+
+  auto options { _cache->options.tokenizer };
+  options.engine = JsonTokenizer::Engine::kScalar;
+
+  JsonTokenizer tokenizer { Buffer { data.data() + offset, _skip (layer, offset) - offset }, options };
+  return JsonValue { std::move (tokenizer.next().value()) };
+}
+
+}
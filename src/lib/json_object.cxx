@@ -0,0 +1,200 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#include <bit>
+#include <cstring>
+
+#include <cppconfig/json_object.h>
+
+
+namespace cppconfig::json {
+
+namespace {
+
+constexpr uint64_t kLsbs { 0x0101010101010101 };
+constexpr uint64_t kMsbs { 0x8080808080808080 };
+
+// ----------------------------------------------------------------------------
+// load
+//
+// Loads a group of control bytes: byte i of the group is byte i of the word.
+// ----------------------------------------------------------------------------
+inline uint64_t load (const uint8_t *ctrl) {
+  uint64_t group;
+  std::memcpy (&group, ctrl, sizeof (group));
+
+  if constexpr (std::endian::native == std::endian::big)
+    group = __builtin_bswap64 (group);
+
+  return group;
+}
+
+// ----------------------------------------------------------------------------
+// match
+//
+// Sets the most significant bit of the bytes of @p group that are equal to
+// @p tag. A byte that follows a match may be reported too: the candidates are
+// checked by comparing the keys anyway.
+// ----------------------------------------------------------------------------
+inline uint64_t match (uint64_t group, uint8_t tag) {
+  const uint64_t x { group ^ (kLsbs * tag) };
+  return (x - kLsbs) & ~x & kMsbs;
+}
+
+}
+
+// ----------------------------------------------------------------------------
+// Constructors
+// ----------------------------------------------------------------------------
+JsonObject::JsonObject(): JsonObject { allocator_type {} } {
+  // empty
+}
+
+JsonObject::JsonObject (const allocator_type &alloc): _members { alloc }, _hashes { alloc }, _index { alloc } {
+  // empty
+}
+
+JsonObject::JsonObject (const JsonObject &obj, const allocator_type &alloc):
+  _members { obj._members, alloc }, _hashes { obj._hashes, alloc }, _index { obj._index, alloc } {
+  // empty
+}
+
+JsonObject::JsonObject (JsonObject &&obj) noexcept = default;
+
+JsonObject::JsonObject (JsonObject &&obj, const allocator_type &alloc):
+  _members { std::move (obj._members), alloc }, _hashes { std::move (obj._hashes), alloc },
+  _index { std::move (obj._index), alloc } {
+  // empty
+}
+
+JsonObject & JsonObject::operator= (const JsonObject &) = default;
+JsonObject & JsonObject::operator= (JsonObject &&) = default;
+JsonObject::~JsonObject() = default;
+
+// ----------------------------------------------------------------------------
+// JsonObject::try_emplace
+// ----------------------------------------------------------------------------
+std::pair<JsonObject::iterator, bool> JsonObject::try_emplace (std::pmr::string &&key, JsonValue &&value) {
+  const uint32_t h { hash (key) };
+
+  if (const size_t idx { _find (key, h) }; idx != _members.size())
+    return { _members.begin() + static_cast<std::ptrdiff_t> (idx), false };
+
+  _members.emplace_back (std::move (key), std::move (value));
+  _insertLast (h);
+
+  return { _members.end() - 1, true };
+}
+
+// ----------------------------------------------------------------------------
+// JsonObject::emplace
+// ----------------------------------------------------------------------------
+std::pair<JsonObject::iterator, bool> JsonObject::emplace (std::string_view key, const JsonValue &value) {
+  const uint32_t h { hash (key) };
+
+  if (const size_t idx { _find (key, h) }; idx != _members.size())
+    return { _members.begin() + static_cast<std::ptrdiff_t> (idx), false };
+
+  _members.emplace_back (key, value);
+  _insertLast (h);
+
+  return { _members.end() - 1, true };
+}
+
+// ----------------------------------------------------------------------------
+// JsonObject::reserve
+// ----------------------------------------------------------------------------
+void JsonObject::reserve (size_t n) {
+  _members.reserve (n);
+  _hashes.reserve (n);
+
+  if ((n > kIndexThreshold) && (n > _capacity() / 8 * 7))
+    _rehash (n);
+}
+
+// ----------------------------------------------------------------------------
+// JsonObject::_find
+//
+// Without an index the hashes are compared one by one. With an index, groups
+// of slots are probed in triangular steps, which visits every group because
+// their number is a power of 2; the first group with an empty slot ends the
+// search, as there are no deletions. The keys are only compared if their
+// hashes are equal.
+// ----------------------------------------------------------------------------
+size_t JsonObject::_find (std::string_view key, uint32_t h) const {
+  if (_index.empty()) {
+    for (size_t i { 0 }; i < _hashes.size(); ++i) {
+      if ((_hashes[i] == h) && (_members[i].first == key))
+        return i;
+    }
+    return _members.size();
+  }
+
+  const auto tag { static_cast<uint8_t> (h & 0x7f) };
+  const size_t mask { _capacity() / kGroup - 1 };
+
+  for (size_t g { (h >> 7) & mask }, step { 1 };; g = (g + step++) & mask) {
+    const uint64_t group { load (_ctrl() + g * kGroup) };
+
+    for (uint64_t m { match (group, tag) }; m != 0; m &= m - 1) {
+      const size_t idx { _slots()[g * kGroup + static_cast<size_t> (std::countr_zero (m)) / 8] };
+      if ((_hashes[idx] == h) && (_members[idx].first == key))
+        return idx;
+    }
+
+    if ((group & kMsbs) != 0)
+      return _members.size();
+  }
+}
+
+// ----------------------------------------------------------------------------
+// JsonObject::_insert
+// ----------------------------------------------------------------------------
+void JsonObject::_insert (size_t idx) {
+  const uint32_t h { _hashes[idx] };
+  const size_t mask { _capacity() / kGroup - 1 };
+
+  for (size_t g { (h >> 7) & mask }, step { 1 };; g = (g + step++) & mask) {
+    if (const uint64_t empty { load (_ctrl() + g * kGroup) & kMsbs }; empty != 0) {
+      const size_t slot { g * kGroup + static_cast<size_t> (std::countr_zero (empty)) / 8 };
+      _ctrl()[slot] = static_cast<uint8_t> (h & 0x7f);
+      _slots()[slot] = static_cast<uint32_t> (idx);
+      return;
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+// JsonObject::_insertLast
+// ----------------------------------------------------------------------------
+void JsonObject::_insertLast (uint32_t h) {
+  _hashes.push_back (h);
+
+  if (_members.size() <= _capacity() / 8 * 7)
+    _insert (_members.size() - 1);
+  else if (_members.size() > kIndexThreshold)
+    _rehash (_members.size());
+}
+
+// ----------------------------------------------------------------------------
+// JsonObject::_rehash
+//
+// The index keeps at least 1/8 of its slots empty, so probes are short and
+// always end.
+// ----------------------------------------------------------------------------
+void JsonObject::_rehash (size_t n) {
+  size_t capacity { 2 * kGroup };
+  while (n > capacity / 8 * 7)
+    capacity *= 2;
+
+  // control bytes, 4 per word, followed by the slots
+  _index.assign (capacity / 4 + capacity, 0);
+  std::memset (_index.data(), kEmpty, capacity);
+
+  for (size_t i { 0 }; i < _members.size(); ++i)
+    _insert (i);
+}
+
+}
@@ -4,7 +4,6 @@
 // Copyright (c) 2023-2024 Carlos Carrasco
 // ----------------------------------------------------------------------------
 #include <cppconfig/json_parser.h>
-#include <iostream>
 
 
 namespace cppconfig::json {
@@ -19,145 +18,232 @@ static_assert (
 );
 
 
+// ----------------------------------------------------------------------------
+// JsonParser::TreeBuilder
+//
+// Handler that builds a JsonValue tree. The members and items of the open containers are kept on
+// one stack and a container is built when it is closed, so its storage is allocated once with its
+// exact size. An open container holds its place in its parent with an empty value.
+//
+// With a memory resource, the strings owned by their tokens are copied to it and borrowed, so the
+// whole document lives in the resource.
+// ----------------------------------------------------------------------------
+class JsonParser::TreeBuilder {
+  public:
+    std::optional<JsonValue> root {}; ///< The document.
+
+    explicit TreeBuilder (std::pmr::memory_resource *resource):
+      _resource { resource? resource : std::pmr::get_default_resource() },
+      _copyStrings { resource != nullptr },
+      _key { _resource }
+    {
+      // empty
+    }
+
+    inline void onObjectBegin() { _open (true); }
+    inline void onArrayBegin() { _open (false); }
+    inline void onKey (std::string_view key) { _key.assign (key); }
+    inline void onInt (int64_t v) { _add (JsonValue { JsonToken { v } }); }
+    inline void onDouble (double v) { _add (JsonValue { JsonToken { v } }); }
+    inline void onBool (bool v) { _add (JsonValue { JsonToken { v } }); }
+    inline void onNull() { _add (JsonValue { JsonToken { JsonTokenId::kValueNull } }); }
+
+    inline void onString (JsonToken &&token) {
+      if (!_copyStrings || token.borrowed()) {
+        _add (JsonValue { std::move (token) });
+        return;
+      }
+
+      const auto str { token.view() };
+      auto *data { static_cast<char *> (_resource->allocate (str.size(), alignof (char))) };
+      std::memcpy (data, str.data(), str.size());
+
+      _add (JsonValue { JsonToken::borrow (std::string_view { data, str.size() }) });
+    }
+
+    inline void onEnd() {
+      const auto frame { _frames.back() };
+      _frames.pop_back();
+
+      const auto first { _pending.begin() + static_cast<std::ptrdiff_t> (frame.begin) };
+      JsonValue value { JsonToken {} };
+
+      if (frame.object) {
+        JsonValue::Object map { _resource };
+        map.reserve (_pending.size() - frame.begin);
+        for (auto it { first }; it != _pending.end(); ++it)
+          map.try_emplace (std::move (it->first), std::move (it->second)); // the first member wins
+
+        value = JsonValue { std::move (map) };
+      }
+      else {
+        JsonValue::Array array { _resource };
+        array.reserve (_pending.size() - frame.begin);
+        for (auto it { first }; it != _pending.end(); ++it)
+          array.push_back (std::move (it->second));
+
+        value = JsonValue { std::move (array) };
+      }
+
+      _pending.erase (first, _pending.end());
+
+      if (_frames.empty())
+        root.emplace (std::move (value));
+      else
+        _pending.back().second = std::move (value);
+    }
+
+  private:
+    /// @brief Container being built.
+    struct Frame {
+      size_t begin; ///< Position in _pending of its first member or item.
+      bool object; ///< True for objects, false for arrays.
+    };
+
+    std::pmr::memory_resource *_resource; ///< Memory of the containers and the keys.
+    bool _copyStrings; ///< True if the owned strings are copied to the resource.
+    std::vector<Frame> _frames {}; ///< Containers being built, the innermost last.
+    std::vector<JsonValue::Object::value_type> _pending {}; ///< Members and items of the containers being built; items have no key.
+    std::pmr::string _key; ///< Key of the next member.
+
+    inline void _open (bool object) {
+      if (!_frames.empty())
+        _add (JsonValue { JsonToken {} });
+
+      _frames.push_back (Frame { _pending.size(), object });
+    }
+
+    inline void _add (JsonValue &&value) {
+      if (_frames.empty())
+        root.emplace (std::move (value));
+      else if (_frames.back().object)
+        _pending.emplace_back (std::move (_key), std::move (value));
+      else
+        _pending.emplace_back (std::pmr::string {}, std::move (value));
+    }
+};
+
+// ----------------------------------------------------------------------------
+// JsonParser::TapeBuilder
+//
+// Handler that appends the values to a tape.
+// ----------------------------------------------------------------------------
+class JsonParser::TapeBuilder {
+  public:
+    explicit TapeBuilder (Tape &tape): _tape { tape } {
+      // empty
+    }
+
+    inline void onObjectBegin() { _begins.push_back (_tape._appendBegin (Tape::Tag::kObjectBegin)); }
+    inline void onArrayBegin() { _begins.push_back (_tape._appendBegin (Tape::Tag::kArrayBegin)); }
+    inline void onKey (std::string_view key) { _tape._appendString (key); }
+    inline void onString (std::string_view str) { _tape._appendString (str); }
+    inline void onInt (int64_t v) { _tape._appendInt (v); }
+    inline void onDouble (double v) { _tape._appendDouble (v); }
+    inline void onBool (bool v) { _tape._append (v ? Tape::Tag::kTrue : Tape::Tag::kFalse); }
+    inline void onNull() { _tape._append (Tape::Tag::kNull); }
+
+    inline void onEnd() {
+      const auto begin { _begins.back() };
+      _begins.pop_back();
+
+      _tape._appendEnd ((_tape._tag (begin) == Tape::Tag::kObjectBegin) ? Tape::Tag::kObjectEnd : Tape::Tag::kArrayEnd, begin);
+    }
+
+  private:
+    Tape &_tape; ///< The tape being built.
+    std::vector<size_t> _begins {}; ///< Indices of the containers being built, the innermost last.
+};
+
+// ----------------------------------------------------------------------------
+// JsonParser::IndexBuilder
+//
+// Handler that only records the offsets of the brackets of every container.
+// ----------------------------------------------------------------------------
+class JsonParser::IndexBuilder {
+  public:
+    IndexBuilder (const JsonTokenizer &tokenizer, std::vector<LazyDocument::Container> &containers):
+      _tokenizer { tokenizer },
+      _containers { containers }
+    {
+      // empty
+    }
+
+    inline void onObjectBegin() { _begin(); }
+    inline void onArrayBegin() { _begin(); }
+
+    inline void onEnd() {
+      _containers[_open.back()].end = _tokenizer.offset() - 1;
+      _open.pop_back();
+    }
+
+  private:
+    const JsonTokenizer &_tokenizer; ///< The tokenizer, just past the bracket of the last token.
+    std::vector<LazyDocument::Container> &_containers; ///< Containers, in the order they begin.
+    std::vector<size_t> _open {}; ///< Indices of the containers being parsed, the innermost last.
+
+    inline void _begin() {
+      _open.push_back (_containers.size());
+      _containers.push_back ({ _tokenizer.offset() - 1, 0 });
+    }
+};
+
 // ----------------------------------------------------------------------------
 // JsonParser::parse
 // ----------------------------------------------------------------------------
 std::optional<JsonValue> JsonParser::parse (const char *data, size_t size) {
   if (size == 0) size = std::strlen(data);
 
-  _tokenizer = std::make_unique<JsonTokenizer> (Buffer { data, size });
+  _tokenizer = std::make_unique<JsonTokenizer> (Buffer { data, size, Buffer::Tracking::kLazy }, _options.tokenizer);
 
-  auto token { _tokenizer->next() };
-  if (!token.has_value())
-    return _setError (ErrorCode::kExpectAny);
+  TreeBuilder builder { _options.resource };
+  if (!_parse (builder))
+    return std::nullopt;
 
-  if (token->id() == JsonTokenId::kError)
-    return _setError (static_cast<ErrorCode> (_tokenizer->error()));
-  if (token->id() == JsonTokenId::kObjectBegin)
-    return _parseObject ();
-  if (token->id() == JsonTokenId::kArrayBegin)
-    return _parseArray ();
-
-  return _setError (ErrorCode::kExpectObject);
+  return std::move (builder.root);
 }
 
 // ----------------------------------------------------------------------------
-// JsonParser::_parseObject
+// JsonParser::parseTape
 // ----------------------------------------------------------------------------
-std::optional<JsonValue> JsonParser::_parseObject () {
-  std::unordered_map<std::string, JsonValue> map;
-
-  do {
-    auto k { _tokenizer->next() }; // key
-
-    if (k.has_value() && k->id() == JsonTokenId::kObjectEnd)
-      return JsonValue { std::move (map) };
-
-    auto c { _tokenizer->next() }; // colon
-    auto v { _tokenizer->next() }; // value
-
-    if (
-      k.has_value() && c.has_value() && v.has_value() &&
-      (k->id() == JsonTokenId::kValueString) &&
-      (c->id() == JsonTokenId::kColon)
-    ) {
-      switch (v->id()) {
-        case JsonTokenId::kValueInteger:
-        case JsonTokenId::kValueFloatPoint:
-        case JsonTokenId::kValueBoolean:
-        case JsonTokenId::kValueString:
-        case JsonTokenId::kValueNull:
-          map.emplace (std::move (k->value<std::string>()), JsonValue { std::move (v.value()) });
-          break;
-        case JsonTokenId::kObjectBegin:
-          if (auto obj =_parseObject(); obj.has_value()) {
-            map.emplace (std::move (k->value<std::string>()), std::move (obj.value()));
-            break;
-          }
-
-          return std::nullopt;
-        case JsonTokenId::kArrayBegin:
-          if (auto arr = _parseArray(); arr.has_value()) {
-            map.emplace (std::move (k->value<std::string>()), std::move (arr.value()));
-            break;
-          }
-
-          return std::nullopt;
-        default:
-          return _setError (ErrorCode::kExpectAny);
-      }
-    }
-    else {
-      return _setError (ErrorCode::kExpectPair);
-    }
+std::optional<Tape> JsonParser::parseTape (const char *data, size_t size) {
+  if (size == 0) size = std::strlen(data);
+
+  // strings are copied into the tape, so the tokens do not need their own copy
+  auto options { _options.tokenizer };
+  options.zeroCopy = true;
 
-    const auto n { _tokenizer->next() };
-    if (!n.has_value())
-      return _setError (ErrorCode::kExpectCommaOrEndObj);
+  _tokenizer = std::make_unique<JsonTokenizer> (Buffer { data, size, Buffer::Tracking::kLazy }, options);
 
-    if (n->id() == JsonTokenId::kObjectEnd)
-      return JsonValue { std::move (map) };
+  Tape tape {};
+  tape._words.reserve (size / 8);
 
-    if (n->id() != JsonTokenId::kComma)
-      break;
-  }
-  while (true);
+  TapeBuilder builder { tape };
+  if (!_parse (builder))
+    return std::nullopt;
 
-  return _setError (ErrorCode::kExpectCommaOrEndObj);
+  return tape;
 }
 
 // ----------------------------------------------------------------------------
-// JsonParser::_parseArray
+// JsonParser::parseLazy
 // ----------------------------------------------------------------------------
-std::optional<JsonValue> JsonParser::_parseArray () {
-  std::vector<JsonValue> array;
-
-  do {
-    auto v { _tokenizer->next() };
-    if (v.has_value()) {
-      switch (v->id()) {
-        case JsonTokenId::kValueInteger:
-        case JsonTokenId::kValueFloatPoint:
-        case JsonTokenId::kValueBoolean:
-        case JsonTokenId::kValueString:
-        case JsonTokenId::kValueNull:
-          array.push_back (JsonValue { std::move (v.value()) });
-          break;
-        case JsonTokenId::kObjectBegin:
-          if (auto obj = _parseObject(); obj.has_value()) {
-            array.push_back (std::move (obj.value()));
-            break;
-          }
-          return std::nullopt;
-        case JsonTokenId::kArrayBegin:
-          if (auto arr = _parseArray(); arr.has_value()) {
-            array.push_back (std::move (arr.value()));
-            break;
-          }
-          return std::nullopt;
-        case JsonTokenId::kArrayEnd:
-          return JsonValue { std::move (array) };
-        default:
-          return _setError (ErrorCode::kExpectAny);
-      }
-    }
-    else {
-      return _setError (ErrorCode::kExpectAny);
-    }
+std::optional<LazyDocument> JsonParser::parseLazy (const char *data, size_t size) {
+  if (size == 0) size = std::strlen(data);
+
+  // values are not kept, so strings do not need to be copied
+  auto options { _options.tokenizer };
+  options.zeroCopy = true;
 
-    const auto n { _tokenizer->next() };
-    if (!n.has_value())
-      return _setError (ErrorCode::kExpectCommaOrEndArray);
+  _tokenizer = std::make_unique<JsonTokenizer> (Buffer { data, size, Buffer::Tracking::kLazy }, options);
 
-    if (n->id() == JsonTokenId::kArrayEnd)
-      return JsonValue { std::move (array) };
+  LazyDocument::Layer layer { std::string_view { data, size } };
 
-    if (n->id() != JsonTokenId::kComma)
-      break;
-  }
-  while (true);
+  IndexBuilder builder { *_tokenizer, layer.containers };
+  if (!_parse (builder))
+    return std::nullopt;
 
-  return _setError (ErrorCode::kExpectCommaOrEndArray);
+  return LazyDocument { *this, std::move (layer) };
 }
 
 }
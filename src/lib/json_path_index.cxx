@@ -0,0 +1,100 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#include <algorithm>
+#include <bit>
+
+#include <cppconfig/config_key.h>
+#include <cppconfig/json_object.h>
+#include <cppconfig/json_path_index.h>
+
+
+namespace cppconfig::json {
+
+// ----------------------------------------------------------------------------
+// Constructor
+// ----------------------------------------------------------------------------
+PathIndex::PathIndex (const JsonValue &root) {
+  std::vector<Slot> slots {};
+  std::string path {};
+  _collect (root, path, slots);
+
+  // at most half of the slots are used, so the probes are short
+  _size = slots.size();
+  _slots.resize (std::bit_ceil (std::max<size_t> (2 * _size, 16)));
+
+  const size_t mask { _slots.size() - 1 };
+  for (const auto &slot: slots) {
+    size_t i { slot.hash & mask };
+    while (_slots[i].value != nullptr)
+      i = (i + 1) & mask;
+
+    _slots[i] = slot;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// PathIndex::find
+// ----------------------------------------------------------------------------
+const JsonValue * PathIndex::find (std::string_view path) const {
+  const uint32_t h { JsonObject::hash (path) };
+  const size_t mask { _slots.size() - 1 };
+
+  for (size_t i { h & mask };; i = (i + 1) & mask) {
+    const auto &slot { _slots[i] };
+    if (slot.value == nullptr)
+      return nullptr;
+
+    if ((slot.hash == h) && (std::string_view { _paths.data() + slot.offset, slot.length } == path))
+      return slot.value;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// PathIndex::_collect
+// ----------------------------------------------------------------------------
+void PathIndex::_collect (const JsonValue &value, std::string &path, std::vector<Slot> &slots) {
+  const size_t size { path.size() };
+
+  const auto add { [&] (const JsonValue &child) {
+    slots.push_back (Slot {
+      .value = &child,
+      .offset = _paths.size(),
+      .length = static_cast<uint32_t> (path.size()),
+      .hash = JsonObject::hash (path)
+    });
+    _paths += path;
+
+    _collect (child, path, slots);
+    path.resize (size);
+  } };
+
+  if (value.isObject()) {
+    for (const auto &[key, child]: value.asObject()) {
+      if (!addressable (key))
+        continue;
+
+      if (size > 0)
+        path.push_back ('.');
+
+      for (const auto c: key) {
+        if (c == '.')
+          path.push_back ('\\');
+        path.push_back (c);
+      }
+
+      add (child);
+    }
+  }
+  else if (value.isArray()) {
+    const auto &items { value.asArray() };
+    for (size_t i { 0 }; i < items.size(); ++i) {
+      path += '[' + std::to_string (i) + ']';
+      add (items[i]);
+    }
+  }
+}
+
+}
@@ -0,0 +1,296 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#include <cppconfig/config_key.h>
+#include <cppconfig/json_object.h>
+#include <cppconfig/json_path_trie.h>
+
+
+namespace cppconfig::json {
+
+// ----------------------------------------------------------------------------
+// PathTrie::View::path
+// ----------------------------------------------------------------------------
+std::string_view PathTrie::View::path() const noexcept {
+  const auto &node { _get() };
+  return { _trie->_paths.data() + node.offset, node.length };
+}
+
+// ----------------------------------------------------------------------------
+// PathTrie::View::key
+// ----------------------------------------------------------------------------
+std::string_view PathTrie::View::key() const noexcept {
+  const auto &node { _get() };
+  return { (node.escaped? _trie->_keys : _trie->_paths).data() + node.keyOffset, node.keyLength };
+}
+
+// ----------------------------------------------------------------------------
+// PathTrie::View::isItem
+// ----------------------------------------------------------------------------
+bool PathTrie::View::isItem() const noexcept {
+  return _get().item;
+}
+
+// ----------------------------------------------------------------------------
+// PathTrie::View::index
+// ----------------------------------------------------------------------------
+size_t PathTrie::View::index() const noexcept {
+  return _get().index;
+}
+
+// ----------------------------------------------------------------------------
+// PathTrie::View::value
+// ----------------------------------------------------------------------------
+const JsonValue & PathTrie::View::value() const noexcept {
+  return *_get().value;
+}
+
+// ----------------------------------------------------------------------------
+// PathTrie::View::descendants
+// ----------------------------------------------------------------------------
+size_t PathTrie::View::descendants() const noexcept {
+  return _get().end - _node - 1;
+}
+
+// ----------------------------------------------------------------------------
+// Constructor
+// ----------------------------------------------------------------------------
+PathTrie::PathTrie (const JsonValue &root) {
+  _nodes.push_back (Node { .value = &root });
+
+  std::string path {};
+  _collect (root, path);
+
+  _nodes[0].end = static_cast<uint32_t> (_nodes.size());
+}
+
+// ----------------------------------------------------------------------------
+// PathTrie::find
+// ----------------------------------------------------------------------------
+std::optional<PathTrie::View> PathTrie::find (std::string_view path) const {
+  uint32_t node { 0 };
+  if (!_walk (path, node))
+    return std::nullopt;
+
+  return View { this, node };
+}
+
+// ----------------------------------------------------------------------------
+// PathTrie::prefix
+// ----------------------------------------------------------------------------
+PathTrie::Range PathTrie::prefix (std::string_view path) const {
+  uint32_t node { 0 };
+  if (!_walk (path, node))
+    return Range { this, 0, 0 };
+
+  return Range { this, node + 1, _nodes[node].end };
+}
+
+// ----------------------------------------------------------------------------
+// PathTrie::children
+// ----------------------------------------------------------------------------
+std::vector<PathTrie::View> PathTrie::children (std::string_view path) const {
+  std::vector<View> views {};
+
+  uint32_t node { 0 };
+  if (_walk (path, node)) {
+    for (uint32_t child { node + 1 }; child < _nodes[node].end; child = _nodes[child].end)
+      views.push_back (View { this, child });
+  }
+
+  return views;
+}
+
+// ----------------------------------------------------------------------------
+// PathTrie::match
+// ----------------------------------------------------------------------------
+std::vector<PathTrie::View> PathTrie::match (std::string_view pattern) const {
+  // "[*]" is the same "*" step as ".*", but it is not a valid position for splitKey()
+  std::string rewritten {};
+  if (pattern.find ("[*]") != std::string_view::npos) {
+    for (size_t i { 0 }; i < pattern.size(); ++i) {
+      if (pattern.substr (i, 3) == "[*]") {
+        rewritten += ".*";
+        i += 2;
+      }
+      else
+        rewritten.push_back (pattern[i]);
+    }
+    pattern = rewritten;
+  }
+
+  std::vector<Step> steps {};
+  const bool valid { splitKey (
+    pattern,
+    [&steps] (std::string_view key) {
+      steps.push_back (Step { .key = std::string { key }, .any = (key == "*") });
+      return true;
+    },
+    [&steps] (size_t index) {
+      steps.push_back (Step { .index = index, .item = true });
+      return true;
+    }
+  ) };
+
+  std::vector<View> views {};
+  if (valid)
+    _match (0, steps, views);
+
+  return views;
+}
+
+// ----------------------------------------------------------------------------
+// PathTrie::longestPrefix
+// ----------------------------------------------------------------------------
+PathTrie::View PathTrie::longestPrefix (std::string_view path) const {
+  uint32_t node { 0 };
+  _walk (path, node);
+
+  return View { this, node };
+}
+
+// ----------------------------------------------------------------------------
+// PathTrie::_collect
+// ----------------------------------------------------------------------------
+void PathTrie::_collect (const JsonValue &value, std::string &path) {
+  const size_t size { path.size() };
+
+  const auto add { [&] (const JsonValue &child, Node &&node) {
+    const auto position { _nodes.size() };
+
+    node.value = &child;
+    node.offset = static_cast<uint32_t> (_paths.size());
+    node.length = static_cast<uint32_t> (path.size());
+    if (!node.item && !node.escaped)
+      node.keyOffset = node.offset + node.length - node.keyLength;
+
+    _nodes.push_back (node);
+    _paths += path;
+
+    _collect (child, path);
+    _nodes[position].end = static_cast<uint32_t> (_nodes.size());
+    path.resize (size);
+  } };
+
+  if (value.isObject()) {
+    for (const auto &[key, child]: value.asObject()) {
+      if (!addressable (key))
+        continue;
+
+      if (size > 0)
+        path.push_back ('.');
+
+      Node node {
+        .keyLength = static_cast<uint32_t> (key.size()),
+        .hash = JsonObject::hash (key),
+        .escaped = (key.find ('.') != std::string::npos)
+      };
+
+      // keys with dots are escaped in the path, so they are kept apart as they are
+      if (node.escaped) {
+        node.keyOffset = static_cast<uint32_t> (_keys.size());
+        _keys += key;
+      }
+
+      for (const auto c: key) {
+        if (c == '.')
+          path.push_back ('\\');
+        path.push_back (c);
+      }
+
+      add (child, std::move (node));
+    }
+  }
+  else if (value.isArray()) {
+    const auto &items { value.asArray() };
+    for (size_t i { 0 }; i < items.size(); ++i) {
+      path += '[' + std::to_string (i) + ']';
+      add (items[i], Node { .index = static_cast<uint32_t> (i), .item = true });
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+// PathTrie::_member
+// ----------------------------------------------------------------------------
+uint32_t PathTrie::_member (uint32_t parent, std::string_view key) const {
+  const uint32_t h { JsonObject::hash (key) };
+
+  // siblings are found by skipping the nodes below each one
+  for (uint32_t child { parent + 1 }; child < _nodes[parent].end; child = _nodes[child].end) {
+    const auto &node { _nodes[child] };
+    if (node.item)
+      return 0;
+
+    if ((node.hash == h) && (View { this, child }.key() == key))
+      return child;
+  }
+
+  return 0;
+}
+
+// ----------------------------------------------------------------------------
+// PathTrie::_item
+// ----------------------------------------------------------------------------
+uint32_t PathTrie::_item (uint32_t parent, size_t index) const {
+  size_t i { 0 };
+  for (uint32_t child { parent + 1 }; child < _nodes[parent].end; child = _nodes[child].end, ++i) {
+    if (!_nodes[child].item)
+      return 0;
+
+    if (i == index)
+      return child;
+  }
+
+  return 0;
+}
+
+// ----------------------------------------------------------------------------
+// PathTrie::_walk
+// ----------------------------------------------------------------------------
+bool PathTrie::_walk (std::string_view path, uint32_t &node) const {
+  return splitKey (
+    path,
+    [this, &node] (std::string_view key) {
+      const auto child { _member (node, key) };
+      if (child == 0)
+        return false;
+
+      node = child;
+      return true;
+    },
+    [this, &node] (size_t index) {
+      const auto child { _item (node, index) };
+      if (child == 0)
+        return false;
+
+      node = child;
+      return true;
+    }
+  );
+}
+
+// ----------------------------------------------------------------------------
+// PathTrie::_match
+// ----------------------------------------------------------------------------
+void PathTrie::_match (uint32_t node, std::span<const Step> steps, std::vector<View> &views) const {
+  if (steps.empty()) {
+    views.push_back (View { this, node });
+    return;
+  }
+
+  const auto &step { steps.front() };
+  if (step.any) {
+    for (uint32_t child { node + 1 }; child < _nodes[node].end; child = _nodes[child].end)
+      _match (child, steps.subspan (1), views);
+  }
+  else {
+    const auto child { step.item? _item (node, step.index) : _member (node, step.key) };
+    if (child != 0)
+      _match (child, steps.subspan (1), views);
+  }
+}
+
+}
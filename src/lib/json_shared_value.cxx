@@ -0,0 +1,250 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#include <algorithm>
+
+#include <cppconfig/json_object.h>
+#include <cppconfig/json_shared_value.h>
+
+
+namespace cppconfig::json {
+
+// ----------------------------------------------------------------------------
+// SharedValue::Node
+// ----------------------------------------------------------------------------
+struct SharedValue::Node {
+  bool object { false }; ///< True for an object, false for an array.
+  std::vector<Member> members {}; ///< Members of an object, in insertion order.
+  std::vector<uint32_t> hashes {}; ///< Hash of the key of each member, see JsonObject::hash.
+  std::vector<uint32_t> index {}; ///< Positions of the members sorted by hash, for big objects only.
+  std::vector<SharedValue> items {}; ///< Items of an array.
+
+  // --------------------------------------------------------------------------
+  // find
+  // --------------------------------------------------------------------------
+  size_t find (std::string_view key, uint32_t h) const {
+    if (index.empty()) {
+      for (size_t i { 0 }; i < hashes.size(); ++i) {
+        if ((hashes[i] == h) && (members[i].first == key))
+          return i;
+      }
+      return members.size();
+    }
+
+    auto it { std::lower_bound (index.begin(), index.end(), h, [this] (uint32_t pos, uint32_t value) {
+      return hashes[pos] < value;
+    }) };
+
+    for (; (it != index.end()) && (hashes[*it] == h); ++it) {
+      if (members[*it].first == key)
+        return *it;
+    }
+
+    return members.size();
+  }
+
+  // --------------------------------------------------------------------------
+  // add
+  // --------------------------------------------------------------------------
+  void add (std::string &&key, SharedValue &&value) {
+    hashes.push_back (JsonObject::hash (key));
+    members.emplace_back (std::move (key), std::move (value));
+  }
+
+  // --------------------------------------------------------------------------
+  // reindex
+  // --------------------------------------------------------------------------
+  void reindex() {
+    if (members.size() <= JsonObject::kIndexThreshold)
+      return;
+
+    index.resize (members.size());
+    for (uint32_t i { 0 }; i < index.size(); ++i)
+      index[i] = i;
+
+    std::sort (index.begin(), index.end(), [this] (uint32_t a, uint32_t b) {
+      return hashes[a] < hashes[b];
+    });
+  }
+};
+
+// ----------------------------------------------------------------------------
+// Constructors
+// ----------------------------------------------------------------------------
+SharedValue::SharedValue(): _scalar { JsonToken { JsonTokenId::kValueNull } } {
+  // empty
+}
+
+SharedValue::SharedValue (const JsonValue &value): SharedValue { JsonValue { value } } {
+  // empty
+}
+
+SharedValue::SharedValue (JsonValue &&value): _scalar { JsonToken {} } {
+  if (value.isObject()) {
+    auto node { std::make_shared<Node>() };
+    node->object = true;
+
+    auto &obj { value.asObject() };
+    node->members.reserve (obj.size());
+    node->hashes.reserve (obj.size());
+    for (auto &[k, v]: obj)
+      node->add (std::string { k }, SharedValue { std::move (v) });
+    node->reindex();
+
+    _node = std::move (node);
+  }
+  else if (value.isArray()) {
+    auto node { std::make_shared<Node>() };
+
+    auto &items { value.asArray() };
+    node->items.reserve (items.size());
+    for (auto &item: items)
+      node->items.emplace_back (std::move (item));
+
+    _node = std::move (node);
+  }
+  else {
+    // a borrowed string references the parsed input, which a version may outlive
+    if (value.isString())
+      value.asString();
+
+    _scalar = std::move (value);
+  }
+}
+
+SharedValue::SharedValue (std::shared_ptr<const Node> &&node): _scalar { JsonToken {} }, _node { std::move (node) } {
+  // empty
+}
+
+// ----------------------------------------------------------------------------
+// SharedValue::isObject
+// ----------------------------------------------------------------------------
+bool SharedValue::isObject() const {
+  return (_node != nullptr) && _node->object;
+}
+
+// ----------------------------------------------------------------------------
+// SharedValue::isArray
+// ----------------------------------------------------------------------------
+bool SharedValue::isArray() const {
+  return (_node != nullptr) && !_node->object;
+}
+
+// ----------------------------------------------------------------------------
+// SharedValue::asObject
+// ----------------------------------------------------------------------------
+const std::vector<SharedValue::Member> & SharedValue::asObject() const {
+  if (!isObject())
+    throw std::bad_variant_access {};
+
+  return _node->members;
+}
+
+// ----------------------------------------------------------------------------
+// SharedValue::asArray
+// ----------------------------------------------------------------------------
+const std::vector<SharedValue> & SharedValue::asArray() const {
+  if (!isArray())
+    throw std::bad_variant_access {};
+
+  return _node->items;
+}
+
+// ----------------------------------------------------------------------------
+// SharedValue::size
+// ----------------------------------------------------------------------------
+size_t SharedValue::size() const {
+  if (_node == nullptr)
+    return 0;
+
+  return _node->object? _node->members.size() : _node->items.size();
+}
+
+// ----------------------------------------------------------------------------
+// SharedValue::find
+// ----------------------------------------------------------------------------
+const SharedValue * SharedValue::find (std::string_view key) const {
+  return find (key, JsonObject::hash (key));
+}
+
+const SharedValue * SharedValue::find (std::string_view key, uint32_t h) const {
+  if (!isObject())
+    return nullptr;
+
+  const size_t idx { _node->find (key, h) };
+  return (idx < _node->members.size())? &_node->members[idx].second : nullptr;
+}
+
+// ----------------------------------------------------------------------------
+// SharedValue::at
+// ----------------------------------------------------------------------------
+const SharedValue * SharedValue::at (size_t i) const {
+  if (!isArray() || (i >= _node->items.size()))
+    return nullptr;
+
+  return &_node->items[i];
+}
+
+// ----------------------------------------------------------------------------
+// SharedValue::set
+// ----------------------------------------------------------------------------
+std::optional<SharedValue> SharedValue::set (std::span<const Step> path, SharedValue value) const {
+  return _set (this, path, std::move (value));
+}
+
+// ----------------------------------------------------------------------------
+// SharedValue::_set
+//
+// Copies the container of each step, which shares the containers below it, and
+// replaces the member or item the path goes through with its new version.
+// ----------------------------------------------------------------------------
+std::optional<SharedValue> SharedValue::_set (const SharedValue *base, std::span<const Step> path, SharedValue &&value) {
+  if (path.empty())
+    return std::move (value);
+
+  if (const auto *key { std::get_if<std::string> (&path.front()) }; key != nullptr) {
+    if ((base != nullptr) && !base->isObject())
+      return std::nullopt;
+
+    auto node { (base != nullptr)? std::make_shared<Node> (*base->_node) : std::make_shared<Node>() };
+    node->object = true;
+
+    const size_t idx { node->find (*key, JsonObject::hash (*key)) };
+    const SharedValue *member { (idx < node->members.size())? &node->members[idx].second : nullptr };
+
+    auto result { _set (member, path.subspan (1), std::move (value)) };
+    if (!result.has_value())
+      return std::nullopt;
+
+    if (member != nullptr)
+      node->members[idx].second = std::move (result.value());
+    else {
+      node->add (std::string { *key }, std::move (result.value()));
+      node->reindex();
+    }
+
+    return SharedValue { std::move (node) };
+  }
+
+  const size_t i { std::get<size_t> (path.front()) };
+  if ((base == nullptr) || !base->isArray() || (i > base->size()))
+    return std::nullopt;
+
+  auto node { std::make_shared<Node> (*base->_node) };
+  const SharedValue *item { (i < node->items.size())? &node->items[i] : nullptr };
+
+  auto result { _set (item, path.subspan (1), std::move (value)) };
+  if (!result.has_value())
+    return std::nullopt;
+
+  if (item != nullptr)
+    node->items[i] = std::move (result.value());
+  else
+    node->items.push_back (std::move (result.value()));
+
+  return SharedValue { std::move (node) };
+}
+
+}
@@ -0,0 +1,448 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#include <poll.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <mutex>
+#include <span>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include <cppconfig/json_stream_parser.h>
+
+
+namespace cppconfig::json {
+
+namespace {
+
+// ----------------------------------------------------------------------------
+// DoubleBufferReader
+//
+// Reads a file descriptor from a dedicated thread. The thread fills one buffer while the consumer
+// processes the other one.
+// ----------------------------------------------------------------------------
+class DoubleBufferReader {
+  public:
+    DoubleBufferReader (int fd, size_t chunkSize): _fd { fd } {
+      for (auto &slot: _slots)
+        slot.data.resize (chunkSize);
+
+      _thread = std::thread { [this] { _run(); } };
+    }
+
+    ~DoubleBufferReader() {
+      {
+        const std::lock_guard lock { _mutex };
+        _stop = true;
+      }
+      _stopRead.store (true, std::memory_order_relaxed);
+      _cond.notify_all();
+      _thread.join();
+    }
+
+    DoubleBufferReader (const DoubleBufferReader &) = delete;
+    DoubleBufferReader & operator= (const DoubleBufferReader &) = delete;
+
+    // Waits for the next chunk. An empty chunk means end of file or error.
+    std::span<const char> acquire() {
+      auto &slot { _slots[_consumer] };
+
+      std::unique_lock lock { _mutex };
+      _cond.wait (lock, [&slot] { return slot.full; });
+
+      return { slot.data.data(), slot.size };
+    }
+
+    // Gives the last acquired chunk back to the reader thread.
+    void release() {
+      {
+        const std::lock_guard lock { _mutex };
+        _slots[_consumer].full = false;
+      }
+      _cond.notify_all();
+
+      _consumer ^= 1;
+    }
+
+    // Gets the errno of the failed read, 0 if there was no error.
+    int error() const {
+      const std::lock_guard lock { _mutex };
+      return _errno;
+    }
+
+  private:
+    struct Slot {
+      std::vector<char> data {};
+      size_t size { 0 };
+      bool full { false };
+    };
+
+    const int _fd;
+    std::array<Slot, 2> _slots {};
+    size_t _consumer { 0 };
+    int _errno { 0 };
+    bool _stop { false }; // guarded by _mutex
+    std::atomic<bool> _stopRead { false }; // checked while waiting for data, without the mutex
+    mutable std::mutex _mutex {};
+    std::condition_variable _cond {};
+    std::thread _thread {};
+
+    // Waits until the file descriptor is readable. It returns false if the reader is stopped first.
+    bool _waitReadable() {
+      pollfd pfd { _fd, POLLIN, 0 };
+
+      while (!_stopRead.load (std::memory_order_relaxed)) {
+        if (const auto r { ::poll (&pfd, 1, 100) }; (r > 0) || ((r < 0) && (errno != EINTR)))
+          return true;
+      }
+
+      return false;
+    }
+
+    void _run() {
+      for (size_t producer { 0 }; ; producer ^= 1) {
+        auto &slot { _slots[producer] };
+
+        {
+          std::unique_lock lock { _mutex };
+          _cond.wait (lock, [this, &slot] { return !slot.full || _stop; });
+          if (_stop)
+            return;
+        }
+
+        ssize_t n { 0 };
+        do {
+          if (!_waitReadable())
+            return;
+          n = ::read (_fd, slot.data.data(), slot.data.size());
+        } while ((n < 0) && ((errno == EINTR) || (errno == EAGAIN)));
+
+        {
+          const std::lock_guard lock { _mutex };
+          if (n < 0)
+            _errno = errno;
+          slot.size = (n > 0) ? static_cast<size_t> (n) : 0;
+          slot.full = true;
+        }
+        _cond.notify_all();
+
+        if (n <= 0)
+          return;
+      }
+    }
+};
+
+// Returns true for the characters that delimit tokens outside strings.
+constexpr bool isStructural (char c) {
+  return (c == '{') || (c == '}') || (c == '[') || (c == ']') || (c == ':') || (c == ',');
+}
+
+}
+
+// ----------------------------------------------------------------------------
+// Constructor
+// ----------------------------------------------------------------------------
+JsonStreamParser::JsonStreamParser (const JsonParser::Options &options): _options { options } {
+  _options.tokenizer.zeroCopy = false;
+}
+
+// ----------------------------------------------------------------------------
+// JsonStreamParser::feed
+// ----------------------------------------------------------------------------
+JsonStreamParser::Status JsonStreamParser::feed (const char *data, size_t size) {
+  if (_status != Status::kNeedMore)
+    return _status;
+
+  // find the first and the last structural characters outside strings
+  size_t first { 0 };
+  size_t last { 0 };
+  for (size_t i { 0 }; i < size; ++i) {
+    const char c { data[i] };
+
+    if (_inString) {
+      if (_inEscape)
+        _inEscape = false;
+      else if (c == '\\')
+        _inEscape = true;
+      else if (c == '"')
+        _inString = false;
+    }
+    else if (c == '"') {
+      _inString = true;
+    }
+    else if (isStructural (c)) {
+      if (first == 0)
+        first = i + 1;
+      last = i + 1;
+    }
+  }
+
+  if (last == 0) {
+    _pending.append (data, size);
+    return _status;
+  }
+
+  // the pending token is completed with the beginning of the chunk
+  if (!_pending.empty()) {
+    _pending.append (data, first);
+    _tokenize (_pending.data(), _pending.size());
+    _pending.clear();
+  }
+  else {
+    first = 0;
+  }
+
+  if ((_status == Status::kNeedMore) && (last > first))
+    _tokenize (data + first, last - first);
+
+  if (_status == Status::kNeedMore)
+    _pending.assign (data + last, size - last);
+
+  return _status;
+}
+
+// ----------------------------------------------------------------------------
+// JsonStreamParser::finish
+// ----------------------------------------------------------------------------
+JsonStreamParser::Status JsonStreamParser::finish() {
+  if (_status != Status::kNeedMore)
+    return _status;
+
+  if (!_pending.empty()) {
+    _tokenize (_pending.data(), _pending.size());
+    _pending.clear();
+
+    if (_status != Status::kNeedMore)
+      return _status;
+  }
+
+  // same errors reported by JsonParser when the input ends
+  switch (_expect) {
+    case Expect::kKeyOrEnd:
+    case Expect::kColon:
+    case Expect::kValue:
+      return _setError (JsonParser::ErrorCode::kExpectPair, 0, 0);
+    case Expect::kCommaOrEnd:
+      return _setError (
+        _stack.back().object ? JsonParser::ErrorCode::kExpectCommaOrEndObj : JsonParser::ErrorCode::kExpectCommaOrEndArray, 0, 0
+      );
+    default:
+      return _setError (JsonParser::ErrorCode::kExpectAny, 0, 0);
+  }
+}
+
+// ----------------------------------------------------------------------------
+// JsonStreamParser::parse
+// ----------------------------------------------------------------------------
+std::optional<JsonValue> JsonStreamParser::parse (int fd, size_t chunkSize) {
+  reset();
+
+  {
+    DoubleBufferReader reader { fd, chunkSize };
+
+    for (auto chunk { reader.acquire() }; !chunk.empty(); chunk = reader.acquire()) {
+      feed (chunk.data(), chunk.size());
+      reader.release();
+
+      if (_status != Status::kNeedMore)
+        break;
+    }
+
+    if (const auto err { reader.error() }; (err != 0) && (_status == Status::kNeedMore))
+      throw std::system_error { err, std::generic_category(), "read" };
+  }
+
+  finish();
+
+  return take();
+}
+
+// ----------------------------------------------------------------------------
+// JsonStreamParser::take
+// ----------------------------------------------------------------------------
+std::optional<JsonValue> JsonStreamParser::take() {
+  if (_status != Status::kDone)
+    return std::nullopt;
+
+  return std::exchange (_root, std::nullopt);
+}
+
+// ----------------------------------------------------------------------------
+// JsonStreamParser::reset
+// ----------------------------------------------------------------------------
+void JsonStreamParser::reset() {
+  _status = Status::kNeedMore;
+  _error = {};
+  _pending.clear();
+  _inString = false;
+  _inEscape = false;
+  _stack.clear();
+  _expect = Expect::kRoot;
+  _root.reset();
+  _line = 0;
+  _column = 0;
+}
+
+// ----------------------------------------------------------------------------
+// JsonStreamParser::_tokenize
+// ----------------------------------------------------------------------------
+void JsonStreamParser::_tokenize (const char *data, size_t size) {
+  JsonTokenizer tokenizer { Buffer { data, size, Buffer::Tracking::kLazy }, _options.tokenizer };
+
+  for (auto token { tokenizer.next() }; token.has_value(); token = tokenizer.next()) {
+    if (token->id() == JsonTokenId::kError) {
+      _setError (static_cast<JsonParser::ErrorCode> (tokenizer.error()), tokenizer.line(), tokenizer.column());
+      return;
+    }
+
+    if (const auto code { _push (std::move (token.value())) }; code != JsonParser::ErrorCode::kNoError) {
+      _setError (code, tokenizer.line(), tokenizer.column());
+      return;
+    }
+
+    if (_status == Status::kDone)
+      return;
+  }
+
+  const std::string_view region { data, size };
+  if (const auto nl { region.rfind ('\n') }; nl != std::string_view::npos) {
+    _line += util::SimdUtil::count (data, size, '\n');
+    _column = size - nl - 1;
+  }
+  else {
+    _column += size;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// JsonStreamParser::_push
+// ----------------------------------------------------------------------------
+JsonParser::ErrorCode JsonStreamParser::_push (JsonToken &&token) {
+  const auto id { token.id() };
+
+  switch (_expect) {
+    case Expect::kRoot:
+      if ((id != JsonTokenId::kObjectBegin) && (id != JsonTokenId::kArrayBegin))
+        return JsonParser::ErrorCode::kExpectObject;
+      break;
+
+    case Expect::kKeyOrEnd:
+      if (id == JsonTokenId::kValueString) {
+        _stack.back().key = token.view();
+        _expect = Expect::kColon;
+        return JsonParser::ErrorCode::kNoError;
+      }
+      if (id != JsonTokenId::kObjectEnd)
+        return JsonParser::ErrorCode::kExpectPair;
+      break;
+
+    case Expect::kColon:
+      if (id != JsonTokenId::kColon)
+        return JsonParser::ErrorCode::kExpectPair;
+
+      _expect = Expect::kValue;
+      return JsonParser::ErrorCode::kNoError;
+
+    case Expect::kValue:
+    case Expect::kValueOrEnd:
+      if ((id == JsonTokenId::kArrayEnd) && (_expect == Expect::kValueOrEnd))
+        break;
+
+      switch (id) {
+        case JsonTokenId::kValueInteger:
+        case JsonTokenId::kValueFloatPoint:
+        case JsonTokenId::kValueBoolean:
+        case JsonTokenId::kValueString:
+        case JsonTokenId::kValueNull:
+          _add (JsonValue { std::move (token) });
+          return JsonParser::ErrorCode::kNoError;
+        case JsonTokenId::kObjectBegin:
+        case JsonTokenId::kArrayBegin:
+          break;
+        default:
+          return JsonParser::ErrorCode::kExpectAny;
+      }
+      break;
+
+    case Expect::kCommaOrEnd:
+      if (_stack.back().object) {
+        if (id == JsonTokenId::kComma) {
+          _expect = Expect::kKeyOrEnd;
+          return JsonParser::ErrorCode::kNoError;
+        }
+        if (id != JsonTokenId::kObjectEnd)
+          return JsonParser::ErrorCode::kExpectCommaOrEndObj;
+      }
+      else {
+        if (id == JsonTokenId::kComma) {
+          _expect = Expect::kValueOrEnd;
+          return JsonParser::ErrorCode::kNoError;
+        }
+        if (id != JsonTokenId::kArrayEnd)
+          return JsonParser::ErrorCode::kExpectCommaOrEndArray;
+      }
+      break;
+  }
+
+  // the token opens or closes a container
+  if (((id == JsonTokenId::kObjectBegin) || (id == JsonTokenId::kArrayBegin)) && (_stack.size() >= _options.maxDepth))
+    return JsonParser::ErrorCode::kMaxDepth;
+
+  if (id == JsonTokenId::kObjectBegin) {
+    _stack.push_back (Frame { true });
+    _expect = Expect::kKeyOrEnd;
+  }
+  else if (id == JsonTokenId::kArrayBegin) {
+    _stack.push_back (Frame { false });
+    _expect = Expect::kValueOrEnd;
+  }
+  else {
+    auto frame { std::move (_stack.back()) };
+    _stack.pop_back();
+
+    _add (frame.object ? JsonValue { std::move (frame.map) } : JsonValue { std::move (frame.array) });
+  }
+
+  return JsonParser::ErrorCode::kNoError;
+}
+
+// ----------------------------------------------------------------------------
+// JsonStreamParser::_add
+// ----------------------------------------------------------------------------
+void JsonStreamParser::_add (JsonValue &&value) {
+  if (_stack.empty()) {
+    _root = std::move (value);
+    _status = Status::kDone;
+    return;
+  }
+
+  auto &frame { _stack.back() };
+  if (frame.object)
+    frame.map.emplace (std::move (frame.key), std::move (value));
+  else
+    frame.array.push_back (std::move (value));
+
+  _expect = Expect::kCommaOrEnd;
+}
+
+// ----------------------------------------------------------------------------
+// JsonStreamParser::_setError
+// ----------------------------------------------------------------------------
+JsonStreamParser::Status JsonStreamParser::_setError (JsonParser::ErrorCode code, size_t line, size_t column) {
+  _error.code = code;
+  _error.line = _line + line;
+  _error.column = (line == 0) ? _column + column : column;
+  _status = Status::kError;
+
+  return _status;
+}
+
+}
@@ -0,0 +1,265 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#include <array>
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <immintrin.h>
+#elif defined(__ARM_NEON)
+  #include <arm_neon.h>
+#endif
+
+#include <cppconfig/json_structural_index.h>
+
+
+namespace cppconfig::json {
+
+namespace {
+
+constexpr size_t kBlockSize { 64 }; // bytes classified per bit mask
+constexpr size_t kChunkBlocks { 256 }; // blocks classified per kernel call
+
+constexpr uint8_t kStructural { 1 };
+constexpr uint8_t kWhitespace { 2 };
+
+// Character classes used by the scalar kernel.
+constexpr std::array<uint8_t, 256> kClassTable { [] {
+  std::array<uint8_t, 256> table {};
+
+  for (const auto c: { '"', '\\', '{', '}', '[', ']', ':', ',' })
+    table[static_cast<uint8_t> (c)] = kStructural;
+  for (const auto c: { ' ', '\t', '\n', '\r', '\0' })
+    table[static_cast<uint8_t> (c)] = kWhitespace;
+
+  return table;
+}() };
+
+using ClassifyFn = void (*) (const char *data, size_t blocks, uint64_t *structural, uint64_t *whitespace);
+
+// ----------------------------------------------------------------------------
+// classifyScalar
+// ----------------------------------------------------------------------------
+void classifyScalar (const char *data, size_t blocks, uint64_t *structural, uint64_t *whitespace) {
+  for (size_t b { 0 }; b < blocks; ++b, data += kBlockSize) {
+    uint64_t s { 0 };
+    uint64_t w { 0 };
+
+    for (size_t i { 0 }; i < kBlockSize; ++i) {
+      const auto cls { kClassTable[static_cast<uint8_t> (data[i])] };
+      s |= static_cast<uint64_t> (cls == kStructural) << i;
+      w |= static_cast<uint64_t> (cls == kWhitespace) << i;
+    }
+
+    structural[b] = s;
+    whitespace[b] = w;
+  }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// ----------------------------------------------------------------------------
+// classifySse42
+//
+// PCMPESTRM compares every byte of the input against a set of up to 16 characters. The explicit
+// length form is used so NUL characters are handled as regular input.
+// ----------------------------------------------------------------------------
+__attribute__((target("sse4.2")))
+void classifySse42 (const char *data, size_t blocks, uint64_t *structural, uint64_t *whitespace) {
+  constexpr int32_t kMode { _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_BIT_MASK };
+
+  const __m128i structuralSet { _mm_setr_epi8 ('"', '\\', '{', '}', '[', ']', ':', ',', 0, 0, 0, 0, 0, 0, 0, 0) };
+  const __m128i whitespaceSet { _mm_setr_epi8 (' ', '\t', '\n', '\r', '\0', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0) };
+
+  for (size_t b { 0 }; b < blocks; ++b, data += kBlockSize) {
+    uint64_t s { 0 };
+    uint64_t w { 0 };
+
+    for (size_t i { 0 }; i < kBlockSize; i += 16) {
+      const __m128i v { _mm_loadu_si128 (reinterpret_cast<const __m128i *> (data + i)) };
+
+      const auto sm { static_cast<uint16_t> (_mm_cvtsi128_si32 (_mm_cmpestrm (structuralSet, 8, v, 16, kMode))) };
+      const auto wm { static_cast<uint16_t> (_mm_cvtsi128_si32 (_mm_cmpestrm (whitespaceSet, 5, v, 16, kMode))) };
+
+      s |= static_cast<uint64_t> (sm) << i;
+      w |= static_cast<uint64_t> (wm) << i;
+    }
+
+    structural[b] = s;
+    whitespace[b] = w;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// eqAvx2
+// ----------------------------------------------------------------------------
+__attribute__((target("avx2")))
+inline __m256i eqAvx2 (__m256i v, char c) {
+  return _mm256_cmpeq_epi8 (v, _mm256_set1_epi8 (c));
+}
+
+// ----------------------------------------------------------------------------
+// classifyAvx2
+// ----------------------------------------------------------------------------
+__attribute__((target("avx2")))
+void classifyAvx2 (const char *data, size_t blocks, uint64_t *structural, uint64_t *whitespace) {
+  for (size_t b { 0 }; b < blocks; ++b, data += kBlockSize) {
+    uint64_t s { 0 };
+    uint64_t w { 0 };
+
+    for (size_t i { 0 }; i < kBlockSize; i += 32) {
+      const __m256i v { _mm256_loadu_si256 (reinterpret_cast<const __m256i *> (data + i)) };
+
+      const __m256i sv {
+        _mm256_or_si256 (
+          _mm256_or_si256 (_mm256_or_si256 (eqAvx2 (v, '"'), eqAvx2 (v, '\\')), _mm256_or_si256 (eqAvx2 (v, '{'), eqAvx2 (v, '}'))),
+          _mm256_or_si256 (_mm256_or_si256 (eqAvx2 (v, '['), eqAvx2 (v, ']')), _mm256_or_si256 (eqAvx2 (v, ':'), eqAvx2 (v, ',')))
+        )
+      };
+      const __m256i wv {
+        _mm256_or_si256 (
+          _mm256_or_si256 (_mm256_or_si256 (eqAvx2 (v, ' '), eqAvx2 (v, '\t')), _mm256_or_si256 (eqAvx2 (v, '\n'), eqAvx2 (v, '\r'))),
+          eqAvx2 (v, '\0')
+        )
+      };
+
+      s |= static_cast<uint64_t> (static_cast<uint32_t> (_mm256_movemask_epi8 (sv))) << i;
+      w |= static_cast<uint64_t> (static_cast<uint32_t> (_mm256_movemask_epi8 (wv))) << i;
+    }
+
+    structural[b] = s;
+    whitespace[b] = w;
+  }
+}
+#endif
+
+#if defined(__ARM_NEON)
+// ----------------------------------------------------------------------------
+// movemaskNeon
+//
+// Packs the most significant bit of the 64 lanes of four comparison results into a 64-bit mask.
+// ----------------------------------------------------------------------------
+inline uint64_t movemaskNeon (uint8x16_t m0, uint8x16_t m1, uint8x16_t m2, uint8x16_t m3) {
+  const uint8x16_t bits { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+
+  uint8x16_t sum0 { vpaddq_u8 (vandq_u8 (m0, bits), vandq_u8 (m1, bits)) };
+  uint8x16_t sum1 { vpaddq_u8 (vandq_u8 (m2, bits), vandq_u8 (m3, bits)) };
+  sum0 = vpaddq_u8 (sum0, sum1);
+  sum0 = vpaddq_u8 (sum0, sum0);
+
+  return vgetq_lane_u64 (vreinterpretq_u64_u8 (sum0), 0);
+}
+
+// ----------------------------------------------------------------------------
+// classifyNeon
+// ----------------------------------------------------------------------------
+void classifyNeon (const char *data, size_t blocks, uint64_t *structural, uint64_t *whitespace) {
+  const auto eq = [] (uint8x16_t v, char c) { return vceqq_u8 (v, vdupq_n_u8 (static_cast<uint8_t> (c))); };
+
+  for (size_t b { 0 }; b < blocks; ++b, data += kBlockSize) {
+    std::array<uint8x16_t, 4> sv;
+    std::array<uint8x16_t, 4> wv;
+
+    for (size_t i { 0 }; i < 4; ++i) {
+      const uint8x16_t v { vld1q_u8 (reinterpret_cast<const uint8_t *> (data + i * 16)) };
+
+      sv[i] = vorrq_u8 (
+        vorrq_u8 (vorrq_u8 (eq (v, '"'), eq (v, '\\')), vorrq_u8 (eq (v, '{'), eq (v, '}'))),
+        vorrq_u8 (vorrq_u8 (eq (v, '['), eq (v, ']')), vorrq_u8 (eq (v, ':'), eq (v, ',')))
+      );
+      wv[i] = vorrq_u8 (
+        vorrq_u8 (vorrq_u8 (eq (v, ' '), eq (v, '\t')), vorrq_u8 (eq (v, '\n'), eq (v, '\r'))),
+        eq (v, '\0')
+      );
+    }
+
+    structural[b] = movemaskNeon (sv[0], sv[1], sv[2], sv[3]);
+    whitespace[b] = movemaskNeon (wv[0], wv[1], wv[2], wv[3]);
+  }
+}
+#endif
+
+// ----------------------------------------------------------------------------
+// classifier
+// ----------------------------------------------------------------------------
+ClassifyFn classifier (util::SimdUtil::Isa isa) {
+  switch (isa) {
+#if defined(__x86_64__) || defined(__i386__)
+    case util::SimdUtil::Isa::kSse42: return classifySse42;
+    case util::SimdUtil::Isa::kAvx2: return classifyAvx2;
+#endif
+#if defined(__ARM_NEON)
+    case util::SimdUtil::Isa::kNeon: return classifyNeon;
+#endif
+    default: return classifyScalar;
+  }
+}
+
+}
+
+// ----------------------------------------------------------------------------
+// StructuralIndex::build
+// ----------------------------------------------------------------------------
+bool StructuralIndex::build (const char *data, size_t size, util::SimdUtil::Isa isa) {
+  _positions.clear();
+
+  if (size > kMaxSize)
+    return false;
+
+  _positions.reserve (size / 4);
+
+  const auto classify { classifier (isa) };
+
+  std::array<uint64_t, kChunkBlocks> structural;
+  std::array<uint64_t, kChunkBlocks> whitespace;
+  std::array<char, kBlockSize> tail;
+
+  uint64_t prevWhitespace { 0 }; // 1 if the last byte of the previous block was a whitespace
+  uint64_t prevOther { 0 }; // 1 if the last byte of the previous block was neither structural nor whitespace
+
+  for (size_t offset { 0 }; offset < size; offset += kChunkBlocks * kBlockSize) {
+    const size_t remaining { size - offset };
+    const size_t fullBlocks { std::min (remaining / kBlockSize, kChunkBlocks) };
+
+    classify (data + offset, fullBlocks, structural.data(), whitespace.data());
+
+    size_t blocks { fullBlocks };
+    if ((fullBlocks < kChunkBlocks) && (remaining % kBlockSize)) {
+      // the last partial block is padded with whitespaces, which are masked out below
+      tail.fill (' ');
+      std::memcpy (tail.data(), data + offset + fullBlocks * kBlockSize, remaining % kBlockSize);
+      classify (tail.data(), 1, structural.data() + fullBlocks, whitespace.data() + fullBlocks);
+      ++blocks;
+    }
+
+    for (size_t b { 0 }; b < blocks; ++b) {
+      const size_t base { offset + b * kBlockSize };
+      const uint64_t valid { (size - base >= kBlockSize) ? ~uint64_t { 0 } : (uint64_t { 1 } << (size - base)) - 1 };
+
+      const uint64_t s { structural[b] };
+      const uint64_t w { whitespace[b] };
+      const uint64_t o { ~(s | w) };
+
+      const uint64_t whitespaceStart { w & ~((w << 1) | prevWhitespace) };
+      const uint64_t otherStart { o & ~((o << 1) | prevOther) };
+
+      prevWhitespace = w >> 63;
+      prevOther = o >> 63;
+
+      uint64_t bits { (s | whitespaceStart | otherStart) & valid };
+
+      size_t n { _positions.size() };
+      _positions.resize (n + std::popcount (bits));
+      while (bits) {
+        _positions[n++] = static_cast<uint32_t> (base + std::countr_zero (bits));
+        bits &= bits - 1;
+      }
+    }
+  }
+
+  return true;
+}
+
+}
@@ -0,0 +1,167 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#include <unordered_map>
+
+#include <cppconfig/json_tape.h>
+
+
+namespace cppconfig::json {
+
+// ----------------------------------------------------------------------------
+// Tape::Value::size
+// ----------------------------------------------------------------------------
+size_t Tape::Value::size() const {
+  if (!isObject() && !isArray())
+    return 0;
+
+  size_t count { 0 };
+  const size_t end { _tape->_payload (_idx) - 1 };
+  for (size_t i { _idx + 1 }; i < end; i = _tape->_next (i))
+    ++count;
+
+  return isObject() ? count / 2 : count;
+}
+
+// ----------------------------------------------------------------------------
+// Tape::Value::find
+// ----------------------------------------------------------------------------
+std::optional<Tape::Value> Tape::Value::find (std::string_view key) const {
+  if (!isObject())
+    return std::nullopt;
+
+  const size_t end { _tape->_payload (_idx) - 1 };
+  for (size_t i { _idx + 1 }; i < end; i = _tape->_next (i + 1)) {
+    if (_tape->_string (i) == key)
+      return Value { _tape, i + 1 };
+  }
+
+  return std::nullopt;
+}
+
+// ----------------------------------------------------------------------------
+// Tape::Value::at
+// ----------------------------------------------------------------------------
+std::optional<Tape::Value> Tape::Value::at (size_t n) const {
+  if (!isArray())
+    return std::nullopt;
+
+  const size_t end { _tape->_payload (_idx) - 1 };
+  for (size_t i { _idx + 1 }; i < end; i = _tape->_next (i), --n) {
+    if (n == 0)
+      return Value { _tape, i };
+  }
+
+  return std::nullopt;
+}
+
+// ----------------------------------------------------------------------------
+// Tape::merge
+// ----------------------------------------------------------------------------
+Tape Tape::merge (const Tape &src, const Tape &dst, JsonValue::Arrays arrays) {
+  if (src.empty())
+    return dst;
+  if (dst.empty())
+    return src;
+
+  Tape tape {};
+  tape._words.reserve (src._words.size() + dst._words.size());
+  tape._strings.reserve (src._strings.size() + dst._strings.size());
+
+  tape._merge (src, 0, dst, 0, arrays);
+
+  return tape;
+}
+
+// ----------------------------------------------------------------------------
+// Tape::_copy
+// ----------------------------------------------------------------------------
+void Tape::_copy (const Tape &src, size_t idx) {
+  const size_t end { src._next (idx) };
+
+  // containers keep their layout, so their indices are just shifted
+  const auto delta { static_cast<int64_t> (_words.size()) - static_cast<int64_t> (idx) };
+
+  for (size_t i { idx }; i < end; ++i) {
+    const auto tag { src._tag (i) };
+
+    switch (tag) {
+      case Tag::kObjectBegin:
+      case Tag::kArrayBegin:
+      case Tag::kObjectEnd:
+      case Tag::kArrayEnd:
+        _append (tag, static_cast<uint64_t> (static_cast<int64_t> (src._payload (i)) + delta));
+        break;
+      case Tag::kString:
+        _appendString (src._string (i));
+        break;
+      case Tag::kInteger:
+      case Tag::kFloatPoint:
+        _words.push_back (src._words[i]);
+        _words.push_back (src._words[++i]);
+        break;
+      default:
+        _words.push_back (src._words[i]);
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Tape::_merge
+// ----------------------------------------------------------------------------
+void Tape::_merge (const Tape &src, size_t srcIdx, const Tape &dst, size_t dstIdx, JsonValue::Arrays arrays) {
+  const auto srcTag { src._tag (srcIdx) };
+  const auto dstTag { dst._tag (dstIdx) };
+
+  if ((srcTag == Tag::kObjectBegin) && (dstTag == Tag::kObjectBegin)) {
+    // members of the source, by key; the first one wins if a key is repeated
+    std::unordered_map<std::string_view, size_t> members {};
+    const size_t srcEnd { src._payload (srcIdx) - 1 };
+    for (size_t i { srcIdx + 1 }; i < srcEnd; i = src._next (i + 1))
+      members.emplace (src._string (i), i + 1);
+
+    const auto begin { _appendBegin (Tag::kObjectBegin) };
+
+    // members of the destination, merged with the source ones
+    const size_t dstEnd { dst._payload (dstIdx) - 1 };
+    for (size_t i { dstIdx + 1 }; i < dstEnd; i = dst._next (i + 1)) {
+      const auto key { dst._string (i) };
+      _appendString (key);
+
+      if (const auto it { members.find (key) }; it != members.end()) {
+        _merge (src, it->second, dst, i + 1, arrays);
+        members.erase (it);
+      }
+      else {
+        _copy (dst, i + 1);
+      }
+    }
+
+    // members only present in the source, in their original order
+    for (size_t i { srcIdx + 1 }; i < srcEnd; i = src._next (i + 1)) {
+      if (const auto it { members.find (src._string (i)) }; (it != members.end()) && (it->second == i + 1)) {
+        _appendString (it->first);
+        _copy (src, i + 1);
+      }
+    }
+
+    _appendEnd (Tag::kObjectEnd, begin);
+  }
+  else if ((srcTag == Tag::kArrayBegin) && (dstTag == Tag::kArrayBegin) && (arrays == JsonValue::Arrays::kAppend)) {
+    const auto begin { _appendBegin (Tag::kArrayBegin) };
+
+    for (size_t i { dstIdx + 1 }; i < dst._payload (dstIdx) - 1; i = dst._next (i))
+      _copy (dst, i);
+    for (size_t i { srcIdx + 1 }; i < src._payload (srcIdx) - 1; i = src._next (i))
+      _copy (src, i);
+
+    _appendEnd (Tag::kArrayEnd, begin);
+  }
+  else {
+    _copy (src, srcIdx);
+  }
+}
+
+}
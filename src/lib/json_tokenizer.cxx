@@ -3,22 +3,37 @@
 //
 // Copyright (c) 2023-2024 Carlos Carrasco
 // ----------------------------------------------------------------------------
+#include <algorithm>
+#include <array>
 #include <cctype>
 #include <charconv>
-#include <codecvt>
-#include <cstdlib>
-#include <locale>
-#include <vector>
 
 #include <cppconfig/json_tokenizer.h>
+#include <cppconfig/number_util.h>
 
 
 namespace cppconfig::json {
 
 // ----------------------------------------------------------------------------
-// JsonTokenizer::next
+// Constructor
 // ----------------------------------------------------------------------------
-std::optional<JsonToken> JsonTokenizer::next() {
+JsonTokenizer::JsonTokenizer (Buffer &&buffer, const Options &options):
+  _buffer { std::move (buffer) },
+  _engine { options.engine },
+  _zeroCopy { options.zeroCopy }
+{
+  if (_engine == Engine::kIndexed) {
+    if (_index.build (_buffer.begin(), _buffer.size()))
+      _buffer.seek (_buffer.offset()); // positions are skipped, so line and column are computed lazily
+    else
+      _engine = Engine::kScalar; // too big to be indexed
+  }
+}
+
+// ----------------------------------------------------------------------------
+// JsonTokenizer::_nextScalar
+// ----------------------------------------------------------------------------
+std::optional<JsonToken> JsonTokenizer::_nextScalar() {
   while (!_buffer.endOfData()) {
     const auto c { _buffer.next() };
 
@@ -73,86 +88,194 @@ std::optional<JsonToken> JsonTokenizer::next() {
 // JsonTokenizer::_handleString
 // ----------------------------------------------------------------------------
 JsonToken JsonTokenizer::_handleString () {
-  std::vector<char> str {};
-  bool backslash { false };
-  while (!_buffer.endOfData()) {
-    const char c { _buffer.next() };
+  // fast path: strings without escape sequences are taken in one go
+  const char *begin { _buffer.current() };
+  const char *p { begin };
+  while ((p < _buffer.end()) && (*p != '"') && (*p != '\\'))
+    ++p;
 
-    if (!backslash) {
-      switch (c) {
-        case '"':
-          return JsonToken { std::string_view { str.data(), str.size() } };
-        case '\\':
-          backslash = true;
-          break;
-        default:
-          str.push_back (c);
-      }
+  if (p == _buffer.end()) {
+    _buffer.forward (p - begin);
+    return _setError (Error::kPrematureEnd);
+  }
 
-      continue;
-    }
+  _buffer.forward (p - begin);
+  if (*p == '"') {
+    _buffer.next();
+    return _makeString (std::string_view { begin, static_cast<size_t> (p - begin) });
+  }
+
+  std::string str { begin, p };
+  while (!_buffer.endOfData()) {
+    const char c { _buffer.next() };
 
     switch (c) {
-      case 'b':
-        str.push_back (0x08);
-        break;
-      case 'f':
-        str.push_back (0x0c );
-        break;
-      case 'n':
-        str.push_back (0x0a);
-        break;
-      case 'r':
-        str.push_back (0x0d);
-        break;
-      case 't':
-        str.push_back (0x09);
-        break;
       case '"':
-        str.push_back (0x22);
-        break;
-      case 'u': {
-        const auto hex { _buffer.take (4) };
-
-        if (hex.size() == 4) {
-          try {
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-            std::wstring_convert<std::codecvt_utf8<char16_t>, char16_t> converter;
-            const std::string utf8 { converter.to_bytes(std::stoi (hex.c_str(), nullptr, 16)) };
-            str.insert (str.end(), utf8.begin(), utf8.end());
-            _buffer.forward(4);
-#pragma GCC diagnostic pop
-          }
-          catch (...) {
-            return _setError (Error::kInvalidEscape);
-          }
+        return JsonToken { std::move (str) };
+      case '\\':
+        if (_buffer.endOfData())
+          return _setError (Error::kPrematureEnd);
+
+        if (const auto n { _unescape (_buffer.current(), _buffer.end(), str) }; n > 0) {
+          _buffer.next();
+          _buffer.forward (n - 1);
+          break;
         }
-        break;
-      }
-      default:
+
+        _buffer.next();
         return _setError (Error::kInvalidEscape);
+      default:
+        str.push_back (c);
     }
-
-    backslash = false;
   }
 
   return _setError (Error::kPrematureEnd);
 }
 
+// Value of every hexadecimal digit, -1 for any other character.
+static constexpr std::array<int8_t, 256> kHexTable { [] {
+  std::array<int8_t, 256> table {};
+  table.fill (-1);
+
+  for (int8_t i { 0 }; i < 10; ++i)
+    table['0' + i] = i;
+  for (int8_t i { 0 }; i < 6; ++i) {
+    table['a' + i] = static_cast<int8_t> (10 + i);
+    table['A' + i] = static_cast<int8_t> (10 + i);
+  }
+
+  return table;
+}() };
+
+// Character produced by every single character escape sequence, 0 if the sequence is not valid.
+static constexpr std::array<char, 256> kEscapeTable { [] {
+  std::array<char, 256> table {};
+
+  table['"'] = '"';
+  table['\\'] = '\\';
+  table['/'] = '/';
+  table['b'] = '\b';
+  table['f'] = '\f';
+  table['n'] = '\n';
+  table['r'] = '\r';
+  table['t'] = '\t';
+
+  return table;
+}() };
+
+// ----------------------------------------------------------------------------
+// decodeHex4
+//
+// Decodes the 4 hexadecimal digits at p. Returns -1 if any of them is not a hexadecimal digit.
+// ----------------------------------------------------------------------------
+static inline int32_t decodeHex4 (const char *p) {
+  const int32_t d0 { kHexTable[static_cast<uint8_t> (p[0])] };
+  const int32_t d1 { kHexTable[static_cast<uint8_t> (p[1])] };
+  const int32_t d2 { kHexTable[static_cast<uint8_t> (p[2])] };
+  const int32_t d3 { kHexTable[static_cast<uint8_t> (p[3])] };
+
+  // any invalid digit sets the sign bit
+  return ((d0 | d1 | d2 | d3) < 0) ? -1 : ((d0 << 12) | (d1 << 8) | (d2 << 4) | d3);
+}
+
+// ----------------------------------------------------------------------------
+// encodeUtf8
+// ----------------------------------------------------------------------------
+static inline void encodeUtf8 (uint32_t cp, std::string &str) {
+  if (cp < 0x80) {
+    str.push_back (static_cast<char> (cp));
+  }
+  else if (cp < 0x800) {
+    const char utf8[] { static_cast<char> (0xc0 | (cp >> 6)), static_cast<char> (0x80 | (cp & 0x3f)) };
+    str.append (utf8, sizeof (utf8));
+  }
+  else if (cp < 0x10000) {
+    const char utf8[] {
+      static_cast<char> (0xe0 | (cp >> 12)),
+      static_cast<char> (0x80 | ((cp >> 6) & 0x3f)),
+      static_cast<char> (0x80 | (cp & 0x3f))
+    };
+    str.append (utf8, sizeof (utf8));
+  }
+  else {
+    const char utf8[] {
+      static_cast<char> (0xf0 | (cp >> 18)),
+      static_cast<char> (0x80 | ((cp >> 12) & 0x3f)),
+      static_cast<char> (0x80 | ((cp >> 6) & 0x3f)),
+      static_cast<char> (0x80 | (cp & 0x3f))
+    };
+    str.append (utf8, sizeof (utf8));
+  }
+}
+
+// ----------------------------------------------------------------------------
+// JsonTokenizer::_unescape
+// ----------------------------------------------------------------------------
+size_t JsonTokenizer::_unescape (const char *p, const char *end, std::string &str) {
+  if (*p != 'u') {
+    const char c { kEscapeTable[static_cast<uint8_t> (*p)] };
+    if (c == 0)
+      return 0;
+
+    str.push_back (c);
+    return 1;
+  }
+
+  // \uXXXX
+  if (end - p < 5)
+    return 0;
+
+  const int32_t cp { decodeHex4 (p + 1) };
+  if (cp < 0)
+    return 0;
+
+  if ((cp < 0xd800) || (cp > 0xdfff)) {
+    encodeUtf8 (static_cast<uint32_t> (cp), str);
+    return 5;
+  }
+
+  // a high surrogate must be followed by a \uXXXX low surrogate
+  if ((cp > 0xdbff) || (end - p < 11) || (p[5] != '\\') || (p[6] != 'u'))
+    return 0;
+
+  const int32_t low { decodeHex4 (p + 7) };
+  if ((low < 0xdc00) || (low > 0xdfff))
+    return 0;
+
+  encodeUtf8 (0x10000 + ((static_cast<uint32_t> (cp) - 0xd800) << 10) + (static_cast<uint32_t> (low) - 0xdc00), str);
+  return 11;
+}
+
+// ----------------------------------------------------------------------------
+// parseNumber
+//
+// Parses the number in [first, last). Returns an empty token if the whole range is not a number.
+// ----------------------------------------------------------------------------
+static JsonToken parseNumber (const char *first, const char *last) {
+  const bool isFp { std::any_of (first, last, [] (const char c) { return (c == '.') || (c == 'e') || (c == 'E'); }) };
+
+  if (isFp) {
+    double value {};
+    const auto r { util::NumberUtil::parseDouble (first, last, value) };
+    if (r.ptr == last)
+      return JsonToken { value };
+  }
+  else {
+    int64_t value {};
+    const auto r { std::from_chars (first, last, value) };
+    if (r.ptr == last)
+      return JsonToken { value };
+  }
+
+  return JsonToken {};
+}
+
 // ----------------------------------------------------------------------------
 // JsonTokenizer::_handleNumber
 // ----------------------------------------------------------------------------
 JsonToken JsonTokenizer::_handleNumber () {
-  bool isFp { false };
-
-  const size_t len = _buffer.count ([ &isFp ] (const char c) {
+  const size_t len = _buffer.count ([] (const char c) {
     switch (c) {
-      case '.':
-      case 'e':
-      case 'E':
-        isFp = true;
-        break;
       case ' ':
       case ',':
       case ']':
@@ -163,33 +286,150 @@ JsonToken JsonTokenizer::_handleNumber () {
     return true;
   });
 
-  if (isFp) {
-#if defined(__GNUC__) && !defined(__llvm__)
-    double value {};
-    const auto r { std::from_chars (_buffer.current() - 1, _buffer.current() + len, value) };
-    if (r.ptr == _buffer.current() + len) {
-      _buffer.forward (len);
-      return JsonToken { value };
+  if (auto token { parseNumber (_buffer.current() - 1, _buffer.current() + len) }; token.id() != JsonTokenId::kEmpty) {
+    _buffer.forward (len);
+    return token;
+  }
+
+  return _setError (Error::kPrematureEnd);
+}
+
+// ----------------------------------------------------------------------------
+// JsonTokenizer::_nextIndexed
+// ----------------------------------------------------------------------------
+std::optional<JsonToken> JsonTokenizer::_nextIndexed() {
+  const char *data { _buffer.begin() };
+
+  // a literal followed by other characters (e.g. 'truex') leaves the rest of its run unconsumed
+  if (const auto pos { _buffer.offset() }; (pos < _buffer.size()) && ((_next >= _index.size()) || (pos < _index[_next]))) {
+    switch (data[pos]) {
+      case ' ': case '\t': case '\n': case '\r': case '\0':
+        break;
+      default:
+        return _handleScalarIndexed (pos, (_next < _index.size()) ? _index[_next] : _buffer.size());
     }
-#else
-    auto *end { const_cast<char *> (_buffer.current() + len) };
-    const auto value { std::strtod (_buffer.current() - 1, &end) };
-    if ((value != 0) || (end != _buffer.current())) {
-      _buffer.forward (len);
-      return JsonToken { value };
+  }
+
+  while (_next < _index.size()) {
+    const size_t pos { _index[_next++] };
+    if (pos < _buffer.offset())
+      continue; // inside a token already consumed
+
+    _buffer.seek (pos + 1);
+
+    switch (data[pos]) {
+      case '{': return JsonToken { JsonTokenId::kObjectBegin };
+      case '}': return JsonToken { JsonTokenId::kObjectEnd };
+      case '[': return JsonToken { JsonTokenId::kArrayBegin };
+      case ']': return JsonToken { JsonTokenId::kArrayEnd };
+      case ':': return JsonToken { JsonTokenId::kColon };
+      case ',': return JsonToken { JsonTokenId::kComma };
+      case '"':
+        return _handleStringIndexed (pos);
+      case '\\':
+        return _setError (Error::kPrematureEnd);
+      case ' ':
+      case '\t':
+      case '\n':
+      case '\r':
+      case '\0':
+        break;
+      default:
+        return _handleScalarIndexed (pos, (_next < _index.size()) ? _index[_next] : _buffer.size());
     }
-#endif
   }
-  else {
-    int64_t value {};
-    const auto r { std::from_chars (_buffer.current() - 1, _buffer.end(), value) };
-    if (r.ptr == _buffer.current() + len) {
-      _buffer.forward (len);
-      return JsonToken { value };
+
+  _buffer.seek (_buffer.size());
+
+  return std::nullopt;
+}
+
+// ----------------------------------------------------------------------------
+// JsonTokenizer::_handleStringIndexed
+// ----------------------------------------------------------------------------
+JsonToken JsonTokenizer::_handleStringIndexed (size_t start) {
+  const char *data { _buffer.begin() };
+  const char *end { _buffer.end() };
+
+  std::string str {};
+  size_t from { start + 1 }; // first byte not copied yet
+
+  while (_next < _index.size()) {
+    const size_t pos { _index[_next++] };
+    if (pos < from)
+      continue; // escaped character
+
+    if (data[pos] == '"') {
+      _buffer.seek (pos + 1);
+
+      if (from == start + 1)
+        return _makeString (std::string_view { data + from, pos - from });
+
+      str.append (data + from, pos - from);
+      return JsonToken { std::move (str) };
+    }
+
+    if (data[pos] == '\\') {
+      str.append (data + from, pos - from);
+
+      if (pos + 1 >= _buffer.size()) {
+        _buffer.seek (_buffer.size());
+        return _setError (Error::kPrematureEnd);
+      }
+
+      const auto n { _unescape (data + pos + 1, end, str) };
+      if (n == 0) {
+        _buffer.seek (pos + 2);
+        return _setError (Error::kInvalidEscape);
+      }
+
+      from = pos + 1 + n;
     }
   }
 
+  _buffer.seek (_buffer.size());
+
   return _setError (Error::kPrematureEnd);
 }
 
-}
\ No newline at end of file
+// ----------------------------------------------------------------------------
+// JsonTokenizer::_handleScalarIndexed
+// ----------------------------------------------------------------------------
+JsonToken JsonTokenizer::_handleScalarIndexed (size_t start, size_t end) {
+  const char *data { _buffer.begin() + start };
+  const size_t len { end - start };
+
+  _buffer.seek (start + 1);
+
+  switch (*data) {
+    case 'n':
+      if ((len >= 4) && (std::memcmp (data, "null", 4) == 0)) {
+        _buffer.seek (start + 4);
+        return JsonToken { JsonTokenId::kValueNull };
+      }
+      break;
+    case 't':
+      if ((len >= 4) && (std::memcmp (data, "true", 4) == 0)) {
+        _buffer.seek (start + 4);
+        return JsonToken { true };
+      }
+      break;
+    case 'f':
+      if ((len >= 5) && (std::memcmp (data, "false", 5) == 0)) {
+        _buffer.seek (start + 5);
+        return JsonToken { false };
+      }
+      break;
+    default:
+      if ((*data == '-') || std::isdigit (*data)) {
+        if (auto token { parseNumber (data, data + len) }; token.id() != JsonTokenId::kEmpty) {
+          _buffer.seek (end);
+          return token;
+        }
+      }
+  }
+
+  return _setError (Error::kPrematureEnd);
+}
+
+}
@@ -8,6 +8,16 @@
 
 namespace cppconfig::json {
 
+// ----------------------------------------------------------------------------
+// Constructor
+// ----------------------------------------------------------------------------
+JsonValue::JsonValue (std::unordered_map<std::string, JsonValue> &&map) {
+  _setObject();
+  _value.object->reserve (map.size());
+  for (auto &[k, v]: map)
+    _value.object->try_emplace (std::pmr::string { k }, std::move (v));
+}
+
 // ----------------------------------------------------------------------------
 // Config::merge
 //
@@ -22,36 +32,126 @@ namespace cppconfig::json {
 //   recursively merges the corresponding values.
 // - If both source and destination are arrays, the function appends each element of the
 //   source array to the destination array.
-// - If neither of the above cases applies, the destination is updated to match the source.
+// - If neither of the above cases applies, the destination is updated to match the source,
+//   which includes a null destination and a source object or array.
 // ----------------------------------------------------------------------------
-bool JsonValue::merge (const json::JsonValue &src, json::JsonValue &dst) {
-  if (!src.isNull() && !dst.isNull() && (src.type() != dst.type()))
-    return false;
+bool JsonValue::merge (const json::JsonValue &src, json::JsonValue &dst, Arrays arrays) {
+  if (src.isObject() && dst.isObject()) {
+    bool merged { true };
 
-  if (src.isObject()) {
     for (auto itSrc = src.asObject().begin(); itSrc != src.asObject().end(); ++itSrc) {
       const auto &key { itSrc->first };
 
       const auto itDst { dst.asObject().find (key) };
       if (itDst == dst.asObject().end()) { // source item is NOT present in destination -> insert
         if (!dst.asObject().emplace (key, itSrc->second).second)
-          return false; // could not be inserted
+          merged = false; // could not be inserted
       }
       else { // source item is present in destination -> update
-        if (!merge (itSrc->second, itDst->second))
-          return false;
+        merged = merge (itSrc->second, itDst->second, arrays) && merged;
       }
     }
+
+    return merged;
   }
-  else if (src.isArray()) {
+
+  if (src.isArray() && dst.isArray() && (arrays == Arrays::kAppend)) {
     for (const auto &item: src.asArray())
       dst.asArray().push_back (item);
+
+    return true;
   }
-  else {
-    dst = src;
+
+  // a value of another type is replaced as well, but reported
+  const bool sameType { src.isNull() || dst.isNull() || src._sameType (dst) };
+  dst = src;
+
+  return sameType;
+}
+
+// ----------------------------------------------------------------------------
+// JsonValue::merge
+//
+// Same rules as the copying overload. A member only present in the source is
+// moved with its key, and the items of a source array are moved to the end of
+// the destination one.
+// ----------------------------------------------------------------------------
+bool JsonValue::merge (json::JsonValue &&src, json::JsonValue &dst, Arrays arrays) {
+  if (src.isObject() && dst.isObject()) {
+    auto &members { dst.asObject() };
+    bool merged { true };
+
+    for (auto &[key, value]: src.asObject()) {
+      // the value is only moved if the key is not present in the destination
+      const auto [itDst, inserted] { members.try_emplace (std::move (key), std::move (value)) };
+      if (!inserted)
+        merged = merge (std::move (value), itDst->second, arrays) && merged;
+    }
+
+    return merged;
   }
 
-  return true;
+  if (src.isArray() && dst.isArray() && (arrays == Arrays::kAppend)) {
+    auto &items { dst.asArray() };
+    items.reserve (items.size() + src.asArray().size());
+
+    for (auto &item: src.asArray())
+      items.push_back (std::move (item));
+
+    return true;
+  }
+
+  const bool sameType { src.isNull() || dst.isNull() || src._sameType (dst) };
+  dst = std::move (src);
+
+  return sameType;
 }
 
-}
\ No newline at end of file
+// ----------------------------------------------------------------------------
+// JsonValue::_copy
+// ----------------------------------------------------------------------------
+void JsonValue::_copy (const JsonValue &obj) {
+  std::pmr::polymorphic_allocator<> alloc {};
+
+  switch (obj._tag) {
+    case Tag::kString:
+      _value.string = new std::string { *obj._value.string };
+      break;
+    case Tag::kStringView:
+      // the copy may outlive the memory the string references
+      _value.string = new std::string { obj._value.chars, obj._size };
+      _tag = Tag::kString;
+      break;
+    case Tag::kObject:
+      _value.object = alloc.new_object<Object> (*obj._value.object);
+      break;
+    case Tag::kArray:
+      _value.array = alloc.new_object<Array> (*obj._value.array);
+      break;
+    default:
+      break;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// JsonValue::_release
+// ----------------------------------------------------------------------------
+void JsonValue::_release() noexcept {
+  switch (_tag) {
+    case Tag::kString:
+      delete _value.string;
+      break;
+    case Tag::kObject:
+      std::pmr::polymorphic_allocator<> { _value.object->get_allocator() }.delete_object (_value.object);
+      break;
+    case Tag::kArray:
+      std::pmr::polymorphic_allocator<> { _value.array->get_allocator() }.delete_object (_value.array);
+      break;
+    default:
+      break;
+  }
+
+  _tag = Tag::kEmpty;
+}
+
+}
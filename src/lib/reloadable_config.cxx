@@ -0,0 +1,444 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#ifdef __linux__
+  #include <poll.h>
+  #include <sys/eventfd.h>
+  #include <sys/inotify.h>
+  #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cppconfig/reloadable_config.h>
+
+
+namespace cppconfig {
+
+namespace {
+
+constexpr std::string_view kDropIns { "conf.d" }; // folder of the drop-in files
+
+#ifdef __linux__
+// changes of the files, including the ones replaced by a rename
+constexpr uint32_t kEvents { IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO };
+#endif
+
+// ----------------------------------------------------------------------------
+// isJson
+// ----------------------------------------------------------------------------
+bool isJson (std::string_view fileName) noexcept {
+  return fileName.ends_with (".json");
+}
+
+// ----------------------------------------------------------------------------
+// stripe
+//
+// Group of counters used by the calling thread, so that threads reading at the
+// same time do not update the same cache line.
+// ----------------------------------------------------------------------------
+size_t stripe (size_t stripes) noexcept {
+  static std::atomic<size_t> next { 0 };
+  thread_local const size_t index { next.fetch_add (1, std::memory_order_relaxed) };
+
+  return index % stripes;
+}
+
+// ----------------------------------------------------------------------------
+// held
+//
+// Configurations of the snapshots alive in the calling thread, once per snapshot.
+// ----------------------------------------------------------------------------
+thread_local std::vector<const ReloadableConfig *> held {};
+
+// ----------------------------------------------------------------------------
+// dropIns
+//
+// The JSON files of the drop-in folder, sorted, none if it does not exist.
+// ----------------------------------------------------------------------------
+std::vector<std::filesystem::path> dropIns (const std::filesystem::path &folderName) {
+  std::vector<std::filesystem::path> files {};
+
+  std::error_code error {};
+  for (std::filesystem::directory_iterator it { folderName, error }, end {}; !error && (it != end); it.increment (error)) {
+    if (isJson (it->path().filename().string()))
+      files.push_back (it->path());
+  }
+
+  std::sort (files.begin(), files.end());
+  return files;
+}
+
+// ----------------------------------------------------------------------------
+// times
+//
+// Modification times of the files, the minimum time for the missing ones.
+// ----------------------------------------------------------------------------
+std::vector<std::filesystem::file_time_type> times (const std::vector<std::filesystem::path> &files) {
+  std::vector<std::filesystem::file_time_type> result {};
+
+  for (const auto &file: files) {
+    std::error_code error {};
+    const auto time { std::filesystem::last_write_time (file, error) };
+    result.push_back (error? std::filesystem::file_time_type::min() : time);
+  }
+
+  return result;
+}
+
+}
+
+// ----------------------------------------------------------------------------
+// ReloadableConfig::Watcher
+// ----------------------------------------------------------------------------
+struct ReloadableConfig::Watcher {
+  std::thread thread {}; ///< Runs ReloadableConfig::_watch().
+  std::mutex mutex {}; ///< Guards stop.
+  std::condition_variable condition {}; ///< Signaled when the watcher is stopped.
+  bool stop { false }; ///< True once the watcher is stopped.
+#ifdef __linux__
+  int inotify { -1 }; ///< Descriptor of the inotify instance, -1 if it is not available.
+  int wakeup { -1 }; ///< Event descriptor written when the watcher is stopped.
+  int dropIns { -1 }; ///< Watch of the drop-in folder, -1 if it is not watched.
+#endif
+
+  ~Watcher() {
+    {
+      const std::lock_guard lock { mutex };
+      stop = true;
+    }
+    condition.notify_all();
+
+#ifdef __linux__
+    if (wakeup != -1) {
+      const uint64_t one { 1 };
+      [[maybe_unused]] const auto n { ::write (wakeup, &one, sizeof (one)) };
+    }
+#endif
+
+    if (thread.joinable())
+      thread.join();
+
+#ifdef __linux__
+    if (inotify != -1)
+      ::close (inotify);
+    if (wakeup != -1)
+      ::close (wakeup);
+#endif
+  }
+
+  /// @brief Reloads @p owner. An exception thrown by onError is dropped: it would end the thread,
+  /// and the program with it.
+  static void reload (ReloadableConfig &owner) noexcept {
+    try {
+      owner.reload();
+    }
+    catch (...) {
+      // dropped
+    }
+  }
+
+  /// @brief Waits for @p duration.
+  /// @return False if the watcher is stopped meanwhile.
+  bool sleep (std::chrono::milliseconds duration) {
+    std::unique_lock lock { mutex };
+    return !condition.wait_for (lock, duration, [this] { return stop; });
+  }
+
+#ifdef __linux__
+  /// @brief Watches the drop-in folder @p folderName, or stops watching it if it is gone.
+  void watchDropIns (const std::filesystem::path &folderName) {
+    if (dropIns != -1)
+      ::inotify_rm_watch (inotify, dropIns);
+
+    dropIns = ::inotify_add_watch (inotify, folderName.c_str(), kEvents | IN_ONLYDIR);
+  }
+
+  /// @brief Reads the events of the folder and of its drop-in folder, @p dropInsName, and
+  /// reloads @p owner once they settle.
+  void events (ReloadableConfig &owner, const std::vector<std::string> &names, const std::filesystem::path &dropInsName) {
+    std::array<pollfd, 2> fds { pollfd { inotify, POLLIN, 0 }, pollfd { wakeup, POLLIN, 0 } };
+    alignas (inotify_event) char buffer[4096];
+    std::chrono::steady_clock::time_point deadline {}; // end of the debounce time
+    bool pending { false };
+
+    for (;;) {
+      // while changes are pending, waits for the time left without changes; events of other
+      // files do not extend it
+      int timeout { -1 };
+      if (pending) {
+        const auto left { std::chrono::ceil<std::chrono::milliseconds> (deadline - std::chrono::steady_clock::now()) };
+        timeout = static_cast<int> (std::max<std::chrono::milliseconds::rep> (left.count(), 0));
+      }
+
+      const int n { ::poll (fds.data(), fds.size(), timeout) };
+      if (n < 0) {
+        if (errno == EINTR)
+          continue;
+        return;
+      }
+
+      if (fds[1].revents != 0)
+        return;
+
+      bool changed { false };
+      const auto len { (n > 0)? ::read (inotify, buffer, sizeof (buffer)) : 0 };
+      for (ssize_t i { 0 }; i < len;) {
+        const auto *event { reinterpret_cast<const inotify_event *> (buffer + i) };
+        if ((event->mask & IN_Q_OVERFLOW) != 0)
+          changed = true;
+        else if (event->len > 0) {
+          if (event->wd == dropIns)
+            changed = changed || isJson (event->name);
+          else if (kDropIns == event->name) {
+            // the drop-in folder is created, removed or renamed
+            watchDropIns (dropInsName);
+            changed = true;
+          }
+          else {
+            for (const auto &name: names)
+              changed = changed || (name == event->name);
+          }
+        }
+
+        i += static_cast<ssize_t> (sizeof (inotify_event) + event->len);
+      }
+
+      if (changed) {
+        deadline = std::chrono::steady_clock::now() + owner._options.debounce;
+        pending = true;
+      }
+
+      if (pending && (std::chrono::steady_clock::now() >= deadline)) {
+        pending = false;
+        reload (owner);
+      }
+    }
+  }
+#endif
+
+  /// @brief Checks the modification times of the files every interval and reloads @p owner once
+  /// they settle.
+  /// @param files Gets the files to check, which change as drop-in files come and go.
+  void poll (ReloadableConfig &owner, const std::function<std::vector<std::filesystem::path>()> &files) {
+    auto last { times (files()) };
+
+    while (sleep (owner._options.interval)) {
+      if (times (files()) == last)
+        continue;
+
+      do {
+        last = times (files());
+        if (!sleep (owner._options.debounce))
+          return;
+      } while (times (files()) != last);
+
+      reload (owner);
+    }
+  }
+};
+
+// ----------------------------------------------------------------------------
+// ReloadableConfig::Snapshot::Snapshot
+// ----------------------------------------------------------------------------
+ReloadableConfig::Snapshot::Snapshot (const ReloadableConfig &owner):
+  _owner { &owner }
+{
+  held.push_back (_owner);
+
+  _readers = owner._enter();
+  _config = owner._current.load();
+}
+
+// ----------------------------------------------------------------------------
+// ReloadableConfig::Snapshot::Snapshot
+// ----------------------------------------------------------------------------
+ReloadableConfig::Snapshot::Snapshot (Snapshot &&other) noexcept:
+  _owner { std::exchange (other._owner, nullptr) },
+  _readers { std::exchange (other._readers, nullptr) },
+  _config { std::exchange (other._config, nullptr) }
+{
+  // empty
+}
+
+// ----------------------------------------------------------------------------
+// ReloadableConfig::Snapshot::~Snapshot
+// ----------------------------------------------------------------------------
+ReloadableConfig::Snapshot::~Snapshot() {
+  if (_readers == nullptr)
+    return;
+
+  _readers->fetch_sub (1, std::memory_order_release);
+
+  if (const auto it { std::find (held.rbegin(), held.rend(), _owner) }; it != held.rend())
+    held.erase (std::next (it).base());
+}
+
+// ----------------------------------------------------------------------------
+// Constructor
+// ----------------------------------------------------------------------------
+ReloadableConfig::ReloadableConfig (const std::filesystem::path &folderName, const Config::System &system):
+  ReloadableConfig { folderName, Options {}, system }
+{
+  // empty
+}
+
+// ----------------------------------------------------------------------------
+// Constructor
+// ----------------------------------------------------------------------------
+ReloadableConfig::ReloadableConfig (const std::filesystem::path &folderName, const Options &options, const Config::System &system):
+  _folderName { folderName },
+  _options { options },
+  _system { system }
+{
+  if (!std::filesystem::is_directory (folderName))
+    throw std::invalid_argument { folderName.string() + " is not a folder" };
+
+  // their lookups memoize values under a lock
+  using Storage = Config::Options::Storage;
+  if ((_options.config.storage == Storage::kLazy) || (_options.config.storage == Storage::kLayered))
+    throw std::invalid_argument { "ReloadableConfig does not support Options::Storage::kLazy and kLayered" };
+
+  _current.store (new Config { _folderName, _options.config, _system });
+
+  if (!_options.watch)
+    return;
+
+  try {
+    _watcher = std::make_unique<Watcher>();
+
+#ifdef __linux__
+    // the folders are watched rather than the files, to see the files replaced by a rename
+    _watcher->inotify = ::inotify_init1 (IN_NONBLOCK | IN_CLOEXEC);
+    if (_watcher->inotify != -1) {
+      if (::inotify_add_watch (_watcher->inotify, _folderName.c_str(), kEvents) == -1) {
+        ::close (_watcher->inotify);
+        _watcher->inotify = -1;
+      }
+      else
+        _watcher->watchDropIns (_folderName / kDropIns);
+    }
+
+    if (_watcher->inotify != -1)
+      _watcher->wakeup = ::eventfd (0, EFD_CLOEXEC);
+#endif
+
+    _watcher->thread = std::thread { &ReloadableConfig::_watch, this };
+  }
+  catch (...) {
+    _watcher.reset();
+    delete _current.load();
+    throw;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Destructor
+// ----------------------------------------------------------------------------
+ReloadableConfig::~ReloadableConfig() {
+  _watcher.reset();
+  delete _current.load();
+}
+
+// ----------------------------------------------------------------------------
+// ReloadableConfig::reload
+// ----------------------------------------------------------------------------
+bool ReloadableConfig::reload() {
+  // the previous version could not be released while the thread holds it
+  if (std::find (held.cbegin(), held.cend(), this) != held.cend())
+    throw std::logic_error { "ReloadableConfig::reload called by a thread that holds a snapshot" };
+
+  const std::lock_guard lock { _reloading };
+
+  const Config *config { nullptr };
+  try {
+    config = new Config { _folderName, _options.config, _system };
+  }
+  catch (...) {
+    if (_options.onError)
+      _options.onError (std::current_exception());
+    return false;
+  }
+
+  const auto *previous { _current.exchange (config) };
+  _version.fetch_add (1, std::memory_order_release);
+
+  _synchronize();
+  delete previous;
+
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+// ReloadableConfig::_enter
+// ----------------------------------------------------------------------------
+std::atomic<uint64_t> * ReloadableConfig::_enter() const noexcept {
+  auto &readers { _readers[stripe (kStripes)] };
+
+  // a reader counted in an epoch that has just ended could be missed by
+  // _synchronize(): it tries again in the new one
+  for (;;) {
+    const auto epoch { _epoch.load() };
+    auto &count { readers.count[epoch & 1] };
+
+    count.fetch_add (1);
+    if (_epoch.load() == epoch)
+      return &count;
+
+    count.fetch_sub (1, std::memory_order_release);
+  }
+}
+
+// ----------------------------------------------------------------------------
+// ReloadableConfig::_synchronize
+// ----------------------------------------------------------------------------
+void ReloadableConfig::_synchronize() noexcept {
+  // readers that entered before the new epoch may still hold the previous
+  // version; the ones entering now read the new one
+  const auto epoch { _epoch.fetch_add (1) };
+
+  for (const auto &readers: _readers) {
+    while (readers.count[epoch & 1].load() != 0)
+      std::this_thread::yield();
+  }
+}
+
+// ----------------------------------------------------------------------------
+// ReloadableConfig::_watch
+// ----------------------------------------------------------------------------
+void ReloadableConfig::_watch() {
+  const auto defaultFileName { _folderName / "default.json" };
+  const auto envFileName { (_folderName / _system.getEnvName()).replace_extension ("json") };
+  const auto hostFileName { (_folderName / _system.getHostName()).replace_extension ("json") };
+  const auto dropInsName { _folderName / kDropIns };
+
+#ifdef __linux__
+  if ((_watcher->inotify != -1) && (_watcher->wakeup != -1)) {
+    _watcher->events (*this, {
+      defaultFileName.filename().string(), envFileName.filename().string(), hostFileName.filename().string()
+    }, dropInsName);
+    return;
+  }
+#endif
+
+  // the drop-in folder changes when a file is added or removed, and its files when they are written
+  _watcher->poll (*this, [&] {
+    std::vector<std::filesystem::path> files { defaultFileName, envFileName, hostFileName, dropInsName };
+    for (auto &fileName: dropIns (dropInsName))
+      files.push_back (std::move (fileName));
+    return files;
+  });
+}
+
+}
@@ -0,0 +1,166 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#include <algorithm>
+#include <array>
+#include <bit>
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <immintrin.h>
+#elif defined(__ARM_NEON)
+  #include <arm_neon.h>
+#endif
+
+#include <cppconfig/simd_util.h>
+
+
+namespace cppconfig::util {
+
+namespace {
+
+using CountFn = size_t (*) (const char *data, size_t size, char c);
+
+// ----------------------------------------------------------------------------
+// countScalar
+// ----------------------------------------------------------------------------
+size_t countScalar (const char *data, size_t size, char c) {
+  return static_cast<size_t> (std::count (data, data + size, c));
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// ----------------------------------------------------------------------------
+// countSse42
+// ----------------------------------------------------------------------------
+__attribute__((target("sse4.2,popcnt")))
+size_t countSse42 (const char *data, size_t size, char c) {
+  const __m128i needle { _mm_set1_epi8 (c) };
+
+  size_t counter { 0 };
+  size_t i { 0 };
+  for (; i + 16 <= size; i += 16) {
+    const __m128i v { _mm_loadu_si128 (reinterpret_cast<const __m128i *> (data + i)) };
+    counter += std::popcount (static_cast<uint32_t> (_mm_movemask_epi8 (_mm_cmpeq_epi8 (v, needle))));
+  }
+
+  return counter + countScalar (data + i, size - i, c);
+}
+
+// ----------------------------------------------------------------------------
+// countAvx2
+// ----------------------------------------------------------------------------
+__attribute__((target("avx2,popcnt")))
+size_t countAvx2 (const char *data, size_t size, char c) {
+  const __m256i needle { _mm256_set1_epi8 (c) };
+
+  size_t counter { 0 };
+  size_t i { 0 };
+  for (; i + 32 <= size; i += 32) {
+    const __m256i v { _mm256_loadu_si256 (reinterpret_cast<const __m256i *> (data + i)) };
+    counter += std::popcount (static_cast<uint32_t> (_mm256_movemask_epi8 (_mm256_cmpeq_epi8 (v, needle))));
+  }
+
+  return counter + countScalar (data + i, size - i, c);
+}
+#endif
+
+#if defined(__ARM_NEON)
+// ----------------------------------------------------------------------------
+// countNeon
+//
+// Matches are accumulated in 8-bit lanes (a match is 0xff, so subtracting adds one) and reduced
+// before the lanes can overflow.
+// ----------------------------------------------------------------------------
+size_t countNeon (const char *data, size_t size, char c) {
+  const uint8x16_t needle { vdupq_n_u8 (static_cast<uint8_t> (c)) };
+
+  size_t counter { 0 };
+  size_t i { 0 };
+  while (i + 16 <= size) {
+    uint8x16_t acc { vdupq_n_u8 (0) };
+
+    for (size_t n { 0 }; (n < 255) && (i + 16 <= size); ++n, i += 16) {
+      const uint8x16_t v { vld1q_u8 (reinterpret_cast<const uint8_t *> (data + i)) };
+      acc = vsubq_u8 (acc, vceqq_u8 (v, needle));
+    }
+
+    counter += vaddlvq_u8 (acc);
+  }
+
+  return counter + countScalar (data + i, size - i, c);
+}
+#endif
+
+// ----------------------------------------------------------------------------
+// counter
+// ----------------------------------------------------------------------------
+CountFn counter (SimdUtil::Isa isa) {
+  switch (isa) {
+#if defined(__x86_64__) || defined(__i386__)
+    case SimdUtil::Isa::kSse42: return countSse42;
+    case SimdUtil::Isa::kAvx2: return countAvx2;
+#endif
+#if defined(__ARM_NEON)
+    case SimdUtil::Isa::kNeon: return countNeon;
+#endif
+    default: return countScalar;
+  }
+}
+
+}
+
+// ----------------------------------------------------------------------------
+// SimdUtil::supports
+// ----------------------------------------------------------------------------
+bool SimdUtil::supports (Isa isa) {
+  switch (isa) {
+    case Isa::kScalar:
+      return true;
+#if defined(__x86_64__) || defined(__i386__)
+    case Isa::kSse42:
+      return __builtin_cpu_supports ("sse4.2");
+    case Isa::kAvx2:
+      return __builtin_cpu_supports ("avx2");
+#elif defined(__ARM_NEON)
+    case Isa::kNeon:
+      return true;
+#endif
+    default:
+      return false;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// SimdUtil::isa
+// ----------------------------------------------------------------------------
+SimdUtil::Isa SimdUtil::isa() {
+  static const Isa isa { [] {
+    for (const auto candidate: std::array { Isa::kAvx2, Isa::kSse42, Isa::kNeon }) {
+      if (supports (candidate))
+        return candidate;
+    }
+
+    return Isa::kScalar;
+  }() };
+
+  return isa;
+}
+
+// ----------------------------------------------------------------------------
+// SimdUtil::count
+// ----------------------------------------------------------------------------
+size_t SimdUtil::count (const char *data, size_t size, char c) {
+  static const CountFn fn { counter (isa()) };
+
+  return fn (data, size, c);
+}
+
+// ----------------------------------------------------------------------------
+// SimdUtil::count
+// ----------------------------------------------------------------------------
+size_t SimdUtil::count (const char *data, size_t size, char c, Isa isa) {
+  return counter (isa) (data, size, c);
+}
+
+}
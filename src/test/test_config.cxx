@@ -3,7 +3,14 @@
 //
 // Copyright (c) 2023-2024 Carlos Carrasco
 // ----------------------------------------------------------------------------
+#include <algorithm>
+#include <cstdlib>
 #include <cstring>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -23,8 +30,13 @@ struct MockSystem: public cppconfig::Config::System {
     return env;
   }
 
+  std::vector<std::pair<std::string, std::string>> getOverrides() const override {
+    return overrides;
+  }
+
   std::string hostName;
   std::string env;
+  std::vector<std::pair<std::string, std::string>> overrides {};
 };
 
 
@@ -36,6 +48,11 @@ TEST (System, test_system) {
 
   ASSERT_FALSE (system.getHostName().empty());
   ASSERT_TRUE (system.getEnvName().empty());
+
+  ::setenv ("CPPCONFIG__system__test", "1", 1);
+  const auto overrides { system.getOverrides() };
+  ::unsetenv ("CPPCONFIG__system__test");
+  ASSERT_NE (std::find (overrides.begin(), overrides.end(), std::pair<std::string, std::string> { "CPPCONFIG__system__test", "1" }), overrides.end());
 }
 
 // ----------------------------------------------------------------------------
@@ -65,6 +82,59 @@ TEST (Config, test_array_types) {
   ASSERT_EQ (config3.get<std::vector<std::string>> ("array").value()[1], "world");
 }
 
+// ----------------------------------------------------------------------------
+// test_views
+// ----------------------------------------------------------------------------
+TEST (Config, test_views) {
+  constexpr const char *kJson { R"({ "name": "server", "ports": [ 80, 443 ], "weights": [ 0.5, 1.5 ], "mixed": [ 1, "a" ] })" };
+
+  using Storage = cppconfig::Config::Options::Storage;
+  for (const auto storage: { Storage::kTree, Storage::kTape, Storage::kLazy, Storage::kLayered, Storage::kShared }) {
+    cppconfig::Config::Options options {};
+    options.storage = storage;
+
+    cppconfig::Config config { kJson, 0, options };
+    ASSERT_EQ (config.get<std::string_view> ("name"), std::string_view ("server"));
+
+    // an array is converted once for every type
+    const auto ports { config.get<std::span<const uint16_t>> ("ports").value() };
+    ASSERT_EQ (ports.size(), 2);
+    ASSERT_EQ (ports[1], 443);
+    ASSERT_EQ (config.get<std::span<const uint16_t>> (cppconfig::Config::Path { "ports" }).value().data(), ports.data());
+    ASSERT_EQ (config.get<std::span<const int64_t>> ("ports").value()[0], 80);
+
+    const auto weights { config.get<std::span<const double>> ("weights").value() };
+    ASSERT_EQ (weights.size(), 2);
+    ASSERT_EQ (weights[0], 0.5);
+    ASSERT_EQ (config.get<std::span<const float>> ("weights").value()[1], 1.5f);
+
+    // threads converting the same array at once get the same items
+    std::vector<const int32_t *> data (4, nullptr);
+    std::vector<std::thread> readers {};
+    for (size_t i { 0 }; i < data.size(); ++i)
+      readers.emplace_back ([&config, &data, i] { data[i] = config.get<std::span<const int32_t>> ("ports").value().data(); });
+    for (auto &reader: readers)
+      reader.join();
+    ASSERT_EQ (std::count (data.begin(), data.end(), data[0]), 4);
+
+    ASSERT_FALSE (config.get<std::span<const int32_t>> ("missing").has_value());
+    ASSERT_THROW (config.get<std::span<const int32_t>> ("mixed"), std::bad_variant_access);
+    ASSERT_THROW (config.get<std::span<const int32_t>> ("name"), std::bad_variant_access);
+
+    // the converted arrays are dropped with the values they come from
+    if (storage == Storage::kShared) {
+      std::vector<cppconfig::json::JsonValue> items {};
+      items.emplace_back (cppconfig::json::JsonToken { int64_t { 8080 } });
+      ASSERT_TRUE (config.set ("ports", cppconfig::json::JsonValue { std::move (items) }));
+    }
+    else {
+      ASSERT_TRUE (config.parse (R"({ "ports": [ 8080 ] })"));
+    }
+    ASSERT_EQ (config.get<std::span<const uint16_t>> ("ports").value().size(), 1);
+    ASSERT_EQ (config.get<std::span<const uint16_t>> ("ports").value()[0], 8080);
+  }
+}
+
 // ----------------------------------------------------------------------------
 // test_basic_types
 // ----------------------------------------------------------------------------
@@ -107,6 +177,124 @@ TEST (Config, test_object_multilevel) {
 TEST (Config, test_key_with_dot) {
   cppconfig::Config config0 { R"({ "key.01": { "key.02": "test" } })" };
   ASSERT_EQ (config0.get<std::string> ("key\\.01.key\\.02").value(), "test");
+
+  cppconfig::Config config1 { R"({ "a.long.key.with.dots": [ { "b\\c": 1 } ] })" };
+  ASSERT_EQ (config1.get<int32_t> ("a\\.long\\.key\\.with\\.dots[0].b\\c").value(), 1);
+  ASSERT_FALSE (config1.get<int32_t> ("a.long.key.with.dots[0].b\\c").has_value());
+}
+
+// ----------------------------------------------------------------------------
+// test_path
+// ----------------------------------------------------------------------------
+TEST (Config, test_path) {
+  const auto *json { R"({ "a": { "b.c": [ 10, { "d": "x" } ], "e": 2.5 }, "f": [ [ 1, 2 ], [ 3 ] ] })" };
+
+  const cppconfig::Config::Path bc { "a.b\\.c[0]" };
+  const cppconfig::Config::Path d { "a.b\\.c[1].d" };
+  const cppconfig::Config::Path e { "a.e" };
+  const cppconfig::Config::Path f { "f[1]" };
+  const cppconfig::Config::Path missing { "a.b\\.c[2].d" };
+
+  ASSERT_EQ (d.str(), "a.b\\.c[1].d");
+  ASSERT_EQ (d.segments().size(), 4);
+  ASSERT_EQ (d.segments()[1].key, "b.c");
+  ASSERT_TRUE (d.segments()[2].item);
+  ASSERT_EQ (d.segments()[2].index, 1);
+
+  for (const auto storage: {
+    cppconfig::Config::Options::Storage::kTree, cppconfig::Config::Options::Storage::kTape,
+    cppconfig::Config::Options::Storage::kLazy, cppconfig::Config::Options::Storage::kLayered,
+    cppconfig::Config::Options::Storage::kShared
+  }) {
+    cppconfig::Config::Options options {};
+    options.storage = storage;
+
+    const cppconfig::Config config { json, 0, options };
+    ASSERT_EQ (config.get<int32_t> (bc), 10);
+    ASSERT_EQ (config.get<std::string> (d), std::string ("x"));
+    ASSERT_EQ (config.get<double> (e), 2.5);
+    ASSERT_EQ (config.get<std::vector<int32_t>> (f).value(), std::vector<int32_t> { 3 });
+    ASSERT_FALSE (config.get<std::string> (missing).has_value());
+    ASSERT_THROW (config.get<int32_t> (d), std::bad_variant_access);
+  }
+
+  ASSERT_THROW (cppconfig::Config::Path { "a[x]" }, std::invalid_argument);
+}
+
+// ----------------------------------------------------------------------------
+// test_index
+// ----------------------------------------------------------------------------
+TEST (Config, test_index) {
+  const auto folder { cppconfig::util::PathUtil::getProgramDirPath() / "data" / "test" / "config03" };
+  const MockSystem mock { "myhostname", "myenvname" };
+
+  cppconfig::Config::Options options {};
+  options.index = true;
+
+  cppconfig::Config config { folder, options, mock };
+
+  ASSERT_EQ (config.get<bool> ("key_1"), false);
+  ASSERT_EQ (config.get<int32_t> ("key_2"), 100);
+  ASSERT_EQ (config.get<std::string> ("sub_key_1.key_1_1"), std::string ("val1111"));
+  ASSERT_EQ (config.get<bool> ("sub_key_1.new"), true);
+  ASSERT_EQ (config.get<std::string> ("sub_key_1.sub_key_1_3.key_1_3_1[2]"), std::string ("foo"));
+  ASSERT_EQ (config.get<std::string> (cppconfig::Config::Path { "sub_key_1.key_1_1" }), std::string ("val1111"));
+  ASSERT_FALSE (config.get<int32_t> ("sub_key_1.missing").has_value());
+
+  // keys written differently are walked
+  ASSERT_EQ (config.get<std::string> ("sub_key_1..key_1_1"), std::string ("val1111"));
+
+  // the index follows the parsed document
+  ASSERT_TRUE (config.parse (R"({ "a": { "b": [ 1, { "c.d": 2 } ] } })"));
+  ASSERT_EQ (config.get<int32_t> ("a.b[1].c\\.d"), 2);
+  ASSERT_FALSE (config.get<int32_t> ("key_2").has_value());
+}
+
+// ----------------------------------------------------------------------------
+// test_trie
+// ----------------------------------------------------------------------------
+TEST (Config, test_trie) {
+  const auto folder { cppconfig::util::PathUtil::getProgramDirPath() / "data" / "test" / "config03" };
+  const MockSystem mock { "myhostname", "myenvname" };
+
+  cppconfig::Config config { folder, {}, mock };
+  const auto trie { config.trie() };
+
+  ASSERT_EQ (trie.find ("sub_key_1.sub_key_1_3.key_1_3_1[2]")->value().asStringView(), "foo");
+  ASSERT_EQ (trie.longestPrefix ("sub_key_1.key_1_1.missing").path(), "sub_key_1.key_1_1");
+
+  const auto below { trie.prefix ("sub_key_1.sub_key_1_3") };
+  ASSERT_FALSE (below.empty());
+  for (const auto view: below)
+    ASSERT_TRUE (view.path().starts_with ("sub_key_1.sub_key_1_3."));
+
+  cppconfig::Config::Options options {};
+  options.storage = cppconfig::Config::Options::Storage::kShared;
+  const cppconfig::Config shared { folder, options, mock };
+  ASSERT_THROW (shared.trie(), std::logic_error);
+}
+
+// ----------------------------------------------------------------------------
+// test_key_literal
+// ----------------------------------------------------------------------------
+TEST (Config, test_key_literal) {
+  using namespace cppconfig::literals;
+
+  // the key is split and hashed by the compiler
+  constexpr auto key { "a.b\\.c[12].d"_key };
+  static_assert (key.str() == "a.b\\.c[12].d");
+  static_assert (key.key (0) == "a");
+  static_assert (key.key (1) == "b.c");
+  static_assert (key.segments[1].hash == cppconfig::json::JsonObject::hash ("b.c"));
+  static_assert (key.segments[2].item && (key.segments[2].index == 12));
+  static_assert (key.key (3) == "d");
+  static_assert ("[0][1]"_key.segments[1].index == 1);
+
+  const cppconfig::Config config { R"({ "database": { "port": 5432, "hosts": [ "a", "b" ] }, "b.c": true })" };
+  ASSERT_EQ ((config.get<uint16_t, "database.port"_key>()), 5432);
+  ASSERT_EQ ((config.get<std::string, "database.hosts[1]"_key>()), std::string ("b"));
+  ASSERT_EQ ((config.get<bool, "b\\.c"_key>()), true);
+  ASSERT_FALSE ((config.get<int32_t, "database.missing"_key>().has_value()));
 }
 
 // ----------------------------------------------------------------------------
@@ -228,6 +416,249 @@ TEST (Config, test_folder_load_def_host) {
   );
 }
 
+// ----------------------------------------------------------------------------
+// test_folder_zero_copy
+// ----------------------------------------------------------------------------
+TEST (Config, test_folder_zero_copy) {
+  const auto folder { cppconfig::util::PathUtil::getProgramDirPath() / "data" / "test" / "config03" };
+  const MockSystem mock { "myhostname", "myenvname" };
+
+  cppconfig::Config::Options options {};
+  options.parser.tokenizer.zeroCopy = true;
+
+  const cppconfig::Config config { folder, options, mock };
+
+  ASSERT_EQ (config.get<int32_t> ("key_2"), 100);
+  ASSERT_EQ (config.get<std::string> ("sub_key_1.key_1_1"), std::string ("val1111"));
+  ASSERT_EQ (
+    config.get<std::vector<std::string>> ("sub_key_1.sub_key_1_3.key_1_3_1").value(),
+    (std::vector<std::string> { "one", "two", "foo" })
+  );
+}
+
+// ----------------------------------------------------------------------------
+// test_folder_tape
+// ----------------------------------------------------------------------------
+TEST (Config, test_folder_tape) {
+  const auto folder { cppconfig::util::PathUtil::getProgramDirPath() / "data" / "test" / "config03" };
+  const MockSystem mock { "myhostname", "myenvname" };
+
+  cppconfig::Config::Options options {};
+  options.storage = cppconfig::Config::Options::Storage::kTape;
+
+  const cppconfig::Config config { folder, options, mock };
+
+  ASSERT_EQ (config.get<bool> ("key_1"), false);
+  ASSERT_EQ (config.get<int32_t> ("key_2"), 100);
+  ASSERT_EQ (config.get<uint32_t> ("key_3"), 20);
+  ASSERT_EQ (config.get<std::string> ("sub_key_1.key_1_1"), std::string ("val1111"));
+  ASSERT_EQ (config.get<float> ("sub_key_1.key_1_2"), 2.0);
+  ASSERT_EQ (config.get<bool> ("sub_key_1.new"), true);
+  ASSERT_EQ (
+    config.get<std::vector<std::string>> ("sub_key_1.sub_key_1_3.key_1_3_1").value(),
+    (std::vector<std::string> { "one", "two", "foo" })
+  );
+  ASSERT_FALSE (config.get<int32_t> ("sub_key_1.missing").has_value());
+  ASSERT_THROW (config.get<int32_t> ("sub_key_1.key_1_1"), std::bad_variant_access);
+
+  const cppconfig::Config config0 { R"({ "array": [ { "a": 1 }, { "b": [ 2.5, 3.5 ] } ] })", 0, options };
+  ASSERT_EQ (config0.get<int32_t> ("array[0].a").value(), 1);
+  ASSERT_EQ (config0.get<std::vector<float>> ("array[1].b").value(), (std::vector<float> { 2.5f, 3.5f }));
+  ASSERT_EQ (config0.get<double> ("array[1].b[1]").value(), 3.5);
+  ASSERT_FALSE (config0.get<int32_t> ("array[2].a").has_value());
+}
+
+// ----------------------------------------------------------------------------
+// test_folder_lazy
+// ----------------------------------------------------------------------------
+TEST (Config, test_folder_lazy) {
+  const auto folder { cppconfig::util::PathUtil::getProgramDirPath() / "data" / "test" / "config03" };
+  const MockSystem mock { "myhostname", "myenvname" };
+
+  cppconfig::Config::Options options {};
+  options.storage = cppconfig::Config::Options::Storage::kLazy;
+
+  const cppconfig::Config config { folder, options, mock };
+
+  ASSERT_EQ (config.get<bool> ("key_1"), false);
+  ASSERT_EQ (config.get<int32_t> ("key_2"), 100);
+  ASSERT_EQ (config.get<uint32_t> ("key_3"), 20);
+  ASSERT_EQ (config.get<std::string> ("sub_key_1.key_1_1"), std::string ("val1111"));
+  ASSERT_EQ (config.get<float> ("sub_key_1.key_1_2"), 2.0);
+  ASSERT_EQ (config.get<bool> ("sub_key_1.new"), true);
+  ASSERT_EQ (
+    config.get<std::vector<std::string>> ("sub_key_1.sub_key_1_3.key_1_3_1").value(),
+    (std::vector<std::string> { "one", "two", "foo" })
+  );
+  ASSERT_EQ (config.get<std::string> ("sub_key_1.sub_key_1_3.key_1_3_1[2]"), std::string ("foo"));
+  ASSERT_FALSE (config.get<int32_t> ("sub_key_1.missing").has_value());
+  ASSERT_THROW (config.get<int32_t> ("sub_key_1.key_1_1"), std::bad_variant_access);
+
+  // a buffer is copied, the caller can release it
+  auto json { std::make_unique<std::string> (R"({ "a": { "b": "c" } })") };
+  cppconfig::Config buffer { json->data(), json->size(), options };
+  json.reset();
+  ASSERT_EQ (buffer.get<std::string> ("a.b"), std::string ("c"));
+
+  json = std::make_unique<std::string> (R"({ "a": { "b": "d" } })");
+  ASSERT_TRUE (buffer.parse (json->data(), json->size()));
+  json.reset();
+  ASSERT_EQ (buffer.get<std::string> ("a.b"), std::string ("d"));
+}
+
+// ----------------------------------------------------------------------------
+// test_folder_layered
+// ----------------------------------------------------------------------------
+TEST (Config, test_folder_layered) {
+  const auto folder { cppconfig::util::PathUtil::getProgramDirPath() / "data" / "test" / "config03" };
+  const MockSystem mock { "myhostname", "myenvname" };
+
+  cppconfig::Config::Options options {};
+  options.storage = cppconfig::Config::Options::Storage::kLayered;
+
+  const cppconfig::Config config { folder, options, mock };
+
+  ASSERT_EQ (config.get<bool> ("key_1"), false);
+  ASSERT_EQ (config.get<int32_t> ("key_2"), 100);
+  ASSERT_EQ (config.get<uint32_t> ("key_3"), 20);
+  ASSERT_EQ (config.get<std::string> ("sub_key_1.key_1_1"), std::string ("val1111"));
+  ASSERT_EQ (config.get<float> ("sub_key_1.key_1_2"), 2.0);
+  ASSERT_EQ (config.get<bool> ("sub_key_1.new"), true);
+  ASSERT_EQ (
+    config.get<std::vector<std::string>> ("sub_key_1.sub_key_1_3.key_1_3_1").value(),
+    (std::vector<std::string> { "one", "two", "foo" })
+  );
+  ASSERT_EQ (config.get<std::string> ("sub_key_1.sub_key_1_3.key_1_3_1[2]"), std::string ("foo"));
+  ASSERT_FALSE (config.get<int32_t> ("sub_key_1.missing").has_value());
+  ASSERT_THROW (config.get<int32_t> ("sub_key_1.key_1_1"), std::bad_variant_access);
+}
+
+// ----------------------------------------------------------------------------
+// test_layers
+// ----------------------------------------------------------------------------
+TEST (Config, test_layers) {
+  cppconfig::Config::Options options {};
+  options.storage = cppconfig::Config::Options::Storage::kLayered;
+
+  cppconfig::Config config { R"({ "db": { "host": "localhost", "port": 5432 }, "debug": false })", 0, options };
+  ASSERT_TRUE (config.parseLayer ("host", R"({ "db": { "port": 6432 } })"));
+
+  ASSERT_EQ (config.get<std::string> ("db.host"), std::string ("localhost"));
+  ASSERT_EQ (config.get<int32_t> ("db.port"), 6432);
+  ASSERT_EQ (config.get<bool> ("debug"), false);
+  ASSERT_FALSE (config.get<bool> ("db.tls").has_value());
+
+  // the host layer is swapped, the lookups made before are forgotten
+  ASSERT_TRUE (config.parseLayer ("host", R"({ "db": { "tls": true }, "debug": true })"));
+  ASSERT_EQ (config.get<int32_t> ("db.port"), 5432);
+  ASSERT_EQ (config.get<bool> ("db.tls"), true);
+  ASSERT_EQ (config.get<bool> ("debug"), true);
+
+  // a layer that cannot be parsed leaves the configuration as it was
+  ASSERT_FALSE (config.parseLayer ("host", R"({ "db": )"));
+  ASSERT_EQ (config.get<bool> ("debug"), true);
+
+  ASSERT_TRUE (config.removeLayer ("host"));
+  ASSERT_FALSE (config.removeLayer ("host"));
+  ASSERT_EQ (config.get<bool> ("debug"), false);
+  ASSERT_FALSE (config.get<bool> ("db.tls").has_value());
+
+  // a document that cannot be parsed keeps the layers, and the lookups made on them
+  ASSERT_EQ (config.get<int32_t> ("db.port"), 5432);
+  ASSERT_FALSE (config.parse (R"({ "db": )"));
+  ASSERT_EQ (config.get<int32_t> ("db.port"), 5432);
+  ASSERT_TRUE (config.parse (R"({ "db": { "port": 7432 } })"));
+  ASSERT_EQ (config.get<int32_t> ("db.port"), 7432);
+  ASSERT_FALSE (config.get<std::string> ("db.host").has_value());
+
+  cppconfig::Config tree { R"({ "a": 1 })", 0, cppconfig::Config::Options {} };
+  ASSERT_THROW (tree.parseLayer ("host", R"({ "a": 2 })"), std::logic_error);
+}
+
+// ----------------------------------------------------------------------------
+// test_folder_shared
+// ----------------------------------------------------------------------------
+TEST (Config, test_folder_shared) {
+  const auto folder { cppconfig::util::PathUtil::getProgramDirPath() / "data" / "test" / "config03" };
+  const MockSystem mock { "myhostname", "myenvname" };
+
+  cppconfig::Config::Options options {};
+  options.storage = cppconfig::Config::Options::Storage::kShared;
+
+  cppconfig::Config config { folder, options, mock };
+
+  ASSERT_EQ (config.get<bool> ("key_1"), false);
+  ASSERT_EQ (config.get<int32_t> ("key_2"), 100);
+  ASSERT_EQ (config.get<uint32_t> ("key_3"), 20);
+  ASSERT_EQ (config.get<std::string> ("sub_key_1.key_1_1"), std::string ("val1111"));
+  ASSERT_EQ (config.get<float> ("sub_key_1.key_1_2"), 2.0);
+  ASSERT_EQ (config.get<bool> ("sub_key_1.new"), true);
+  ASSERT_EQ (
+    config.get<std::vector<std::string>> ("sub_key_1.sub_key_1_3.key_1_3_1").value(),
+    (std::vector<std::string> { "one", "two", "foo" })
+  );
+  ASSERT_EQ (config.get<std::string> ("sub_key_1.sub_key_1_3.key_1_3_1[2]"), std::string ("foo"));
+  ASSERT_FALSE (config.get<int32_t> ("sub_key_1.missing").has_value());
+  ASSERT_THROW (config.get<int32_t> ("sub_key_1.key_1_1"), std::bad_variant_access);
+
+  // a snapshot keeps the version it was taken from
+  const auto before { config.snapshot() };
+  ASSERT_TRUE (config.set ("sub_key_1.key_1_2", cppconfig::json::JsonValue { cppconfig::json::JsonToken { 3.0 } }));
+  ASSERT_TRUE (config.set ("sub_key_1.sub_key_1_3.key_1_3_1[1]", cppconfig::json::JsonValue { cppconfig::json::JsonToken { std::string { "bar" } } }));
+  ASSERT_TRUE (config.set ("new\\.key", cppconfig::json::JsonValue { cppconfig::json::JsonToken { int64_t { 1 } } }));
+  ASSERT_FALSE (config.set ("key_2.a", cppconfig::json::JsonValue { cppconfig::json::JsonToken { int64_t { 1 } } }));
+
+  ASSERT_EQ (config.get<float> ("sub_key_1.key_1_2"), 3.0);
+  ASSERT_EQ (config.get<std::string> ("sub_key_1.sub_key_1_3.key_1_3_1[1]"), std::string ("bar"));
+  ASSERT_EQ (config.get<int32_t> ("new\\.key"), 1);
+  ASSERT_EQ (before.find ("sub_key_1")->find ("key_1_2")->asFloat(), 2.0);
+  ASSERT_EQ (before.find ("new.key"), nullptr);
+
+  cppconfig::Config tree { R"({ "a": 1 })", 0, cppconfig::Config::Options {} };
+  ASSERT_THROW (tree.snapshot(), std::logic_error);
+}
+
+// ----------------------------------------------------------------------------
+// test_folder_arena
+// ----------------------------------------------------------------------------
+TEST (Config, test_folder_arena) {
+  const auto folder { cppconfig::util::PathUtil::getProgramDirPath() / "data" / "test" / "config03" };
+  const MockSystem mock { "myhostname", "myenvname" };
+
+  cppconfig::Config::Options options {};
+  options.arena = true;
+
+  cppconfig::Config config { folder, options, mock };
+
+  ASSERT_EQ (config.get<bool> ("key_1"), false);
+  ASSERT_EQ (config.get<int32_t> ("key_2"), 100);
+  ASSERT_EQ (config.get<uint32_t> ("key_3"), 20);
+  ASSERT_EQ (config.get<std::string> ("sub_key_1.key_1_1"), std::string ("val1111"));
+  ASSERT_EQ (config.get<bool> ("sub_key_1.new"), true);
+  ASSERT_EQ (
+    config.get<std::vector<std::string>> ("sub_key_1.sub_key_1_3.key_1_3_1").value(),
+    (std::vector<std::string> { "one", "two", "foo" })
+  );
+
+  // the arena moves along with the values
+  const cppconfig::Config moved { std::move (config) };
+  ASSERT_EQ (moved.get<std::string> ("sub_key_1.sub_key_1_3.key_1_3_1[2]"), std::string ("foo"));
+
+  // copies and snapshots own their strings, they outlive the arena
+  std::optional<cppconfig::json::JsonValue> copy {};
+  std::optional<cppconfig::json::SharedValue> snapshot {};
+  {
+    const cppconfig::Config tree { folder, options, mock };
+    copy.emplace (tree.trie().find ("sub_key_1")->value());
+
+    options.storage = cppconfig::Config::Options::Storage::kShared;
+    const cppconfig::Config shared { folder, options, mock };
+    snapshot.emplace (shared.snapshot());
+  }
+  ASSERT_EQ (copy.value()["key_1_1"].asString(), std::string ("val1111"));
+  ASSERT_EQ (snapshot.value().find ("sub_key_1")->find ("key_1_1")->asStringView(), std::string_view ("val1111"));
+}
+
 // ----------------------------------------------------------------------------
 // test_folder_missing_default
 // ----------------------------------------------------------------------------
@@ -236,3 +667,171 @@ TEST (Config, test_folder_missing_default) {
 
   ASSERT_THROW (cppconfig::Config config (folder), std::ios_base::failure);
 }
+
+// ----------------------------------------------------------------------------
+// test_folder_drop_ins
+// ----------------------------------------------------------------------------
+TEST (Config, test_folder_drop_ins) {
+  const auto folder { cppconfig::util::PathUtil::getProgramDirPath() / "data" / "test" / "config06" };
+  const MockSystem mock { "myhostname", "myenvname" };
+
+  using Storage = cppconfig::Config::Options::Storage;
+  for (const auto storage: { Storage::kTree, Storage::kTape, Storage::kLazy, Storage::kLayered, Storage::kShared }) {
+    for (const size_t threads: { 0, 1, 4 }) {
+      cppconfig::Config::Options options {};
+      options.storage = storage;
+      options.threads = threads;
+
+      // default.json, then conf.d in alphabetical order, then the environment file
+      const cppconfig::Config config { folder, options, mock };
+      ASSERT_EQ (config.get<int32_t> ("a"), 10);
+      ASSERT_EQ (config.get<int32_t> ("b"), 20);
+      ASSERT_EQ (config.get<int32_t> ("c"), 30);
+      ASSERT_EQ (config.get<int32_t> ("d"), 1);
+      ASSERT_EQ (config.get<std::string> ("server.host"), std::string ("localhost"));
+      ASSERT_EQ (config.get<int32_t> ("server.port"), 8080);
+    }
+  }
+
+  // every drop-in file is a layer
+  cppconfig::Config::Options options {};
+  options.storage = Storage::kLayered;
+  cppconfig::Config config { folder, options, mock };
+  config.removeLayer ("conf.d/20-second.json");
+  ASSERT_EQ (config.get<int32_t> ("b"), 10);
+}
+
+// ----------------------------------------------------------------------------
+// test_folder_type_conflicts
+// ----------------------------------------------------------------------------
+TEST (Config, test_folder_type_conflicts) {
+  const auto folder { cppconfig::util::PathUtil::getProgramDirPath() / "data" / "test" / "config07" };
+  const MockSystem mock { "myhostname", "myenvname" };
+
+  // a value whose type differs from the one of a previous file replaces it, whatever the storage
+  using Storage = cppconfig::Config::Options::Storage;
+  for (const auto storage: { Storage::kTree, Storage::kTape, Storage::kLazy, Storage::kLayered, Storage::kShared }) {
+    cppconfig::Config::Options options {};
+    options.storage = storage;
+
+    const cppconfig::Config config { folder, options, mock };
+    ASSERT_EQ (config.get<std::string> ("a"), std::string ("one"));
+    ASSERT_EQ (config.get<int32_t> ("b"), 2);
+    ASSERT_EQ (config.get<std::vector<int32_t>> ("c"), (std::vector<int32_t> { 3 }));
+    ASSERT_EQ (config.get<std::vector<int32_t>> ("d"), (std::vector<int32_t> { 1, 2, 3 }));
+    ASSERT_EQ (config.get<double> ("e"), 1.5);
+    ASSERT_EQ (config.get<int32_t> ("f.g"), 0);
+    ASSERT_EQ (config.get<std::string> ("f.k"), std::string ("keep"));
+    ASSERT_EQ (config.get<int32_t> ("z"), 7);
+  }
+}
+
+// ----------------------------------------------------------------------------
+// test_folder_environment
+// ----------------------------------------------------------------------------
+TEST (Config, test_folder_environment) {
+  const auto folder { cppconfig::util::PathUtil::getProgramDirPath() / "data" / "test" / "config06" };
+  MockSystem mock { "myhostname", "myenvname" };
+  mock.overrides = {
+    { "CPPCONFIG__a", "100" },
+    { "CPPCONFIG__server__host", "example.org" },
+    { "CPPCONFIG__server__port", "9090" },
+    { "CPPCONFIG__server__tls", "true" },
+    { "CPPCONFIG__ratio", "0.5" },
+    { "CPPCONFIG__zip", "007" },
+    { "CPPCONFIG__list", "[ 1, 2, 3 ]" },
+    { "CPPCONFIG__limits", "{ \"max\": 5 }" },
+    { "CPPCONFIG__name", "\"quoted\"" },
+    { "CPPCONFIG__broken", "{ \"x\": " },
+    { "CPPCONFIG__trailing", "[ 1 ] ]" },
+    { "CPPCONFIG____empty", "1" },
+    { "CPPCONFIG__server__port", "9191" },
+    { "CPPCONFIG__dup", "1" },
+    { "CPPCONFIG__dup", "2" },
+    { "OTHER__a", "1" }
+  };
+
+  using Storage = cppconfig::Config::Options::Storage;
+  for (const auto storage: { Storage::kTree, Storage::kTape, Storage::kLazy, Storage::kLayered, Storage::kShared }) {
+    cppconfig::Config::Options options {};
+    options.storage = storage;
+
+    const cppconfig::Config config { folder, options, mock };
+    ASSERT_EQ (config.get<int32_t> ("a"), 100);
+    ASSERT_EQ (config.get<int32_t> ("b"), 20);
+    ASSERT_EQ (config.get<int32_t> ("c"), 30);
+    ASSERT_EQ (config.get<std::string> ("server.host"), std::string ("example.org"));
+    ASSERT_EQ (config.get<int32_t> ("server.port"), 9191);
+    ASSERT_EQ (config.get<bool> ("server.tls"), true);
+    ASSERT_EQ (config.get<double> ("ratio"), 0.5);
+    ASSERT_EQ (config.get<std::string> ("zip"), std::string ("007"));
+    ASSERT_EQ (config.get<int32_t> ("list[2]"), 3);
+    ASSERT_EQ (config.get<int32_t> ("limits.max"), 5);
+    ASSERT_EQ (config.get<std::string> ("name"), std::string ("quoted"));
+    ASSERT_EQ (config.get<std::string> ("broken"), std::string ("{ \"x\": "));
+    ASSERT_EQ (config.get<std::string> ("trailing"), std::string ("[ 1 ] ]"));
+    ASSERT_FALSE (config.get<int32_t> ("empty").has_value());
+    ASSERT_EQ (config.get<int32_t> ("dup"), 2);
+  }
+
+  // a variable replaces the value of the files whatever its type, arrays included, and does not
+  // prevent the other ones from being applied
+  const auto conflicts { cppconfig::util::PathUtil::getProgramDirPath() / "data" / "test" / "config07" };
+  mock.overrides = {
+    { "CPPCONFIG__a", "123" },
+    { "CPPCONFIG__b", "text" },
+    { "CPPCONFIG__e", "2" },
+    { "CPPCONFIG__f__g", "1.5" },
+    { "CPPCONFIG__d", "[ 9 ]" },
+    { "CPPCONFIG__c", "{ \"x\": [ 4 ] }" },
+    { "CPPCONFIG__z", "8" }
+  };
+
+  for (const auto storage: { Storage::kTree, Storage::kTape, Storage::kLazy, Storage::kLayered, Storage::kShared }) {
+    cppconfig::Config::Options options {};
+    options.storage = storage;
+
+    const cppconfig::Config config { conflicts, options, mock };
+    ASSERT_EQ (config.get<int32_t> ("a"), 123);
+    ASSERT_EQ (config.get<std::string> ("b"), std::string ("text"));
+    ASSERT_EQ (config.get<int32_t> ("e"), 2);
+    ASSERT_EQ (config.get<double> ("f.g"), 1.5);
+    ASSERT_EQ (config.get<std::string> ("f.k"), std::string ("keep"));
+    ASSERT_EQ (config.get<std::vector<int32_t>> ("d"), (std::vector<int32_t> { 9 }));
+    ASSERT_EQ (config.get<std::vector<int32_t>> ("c.x"), (std::vector<int32_t> { 4 }));
+    ASSERT_EQ (config.get<int32_t> ("z"), 8);
+  }
+
+  cppconfig::Config::Options options {};
+  options.environment = false;
+  const cppconfig::Config files { folder, options, mock };
+  ASSERT_EQ (files.get<int32_t> ("a"), 10);
+
+  // the variables are a layer of their own
+  options.environment = true;
+  options.storage = Storage::kLayered;
+  cppconfig::Config layered { folder, options, mock };
+  layered.removeLayer ("environment");
+  ASSERT_EQ (layered.get<int32_t> ("a"), 10);
+  ASSERT_EQ (layered.get<int32_t> ("server.port"), 8080);
+}
+
+// ----------------------------------------------------------------------------
+// test_files
+// ----------------------------------------------------------------------------
+TEST (Config, test_files) {
+  const auto data { cppconfig::util::PathUtil::getProgramDirPath() / "data" / "test" };
+
+  // a folder in the list stands for its JSON files
+  const cppconfig::Config config { { data / "config03" / "default.json", data / "config06" / "conf.d" } };
+  ASSERT_EQ (config.get<bool> ("key_1"), true);
+  ASSERT_EQ (config.get<int32_t> ("b"), 20);
+
+  cppconfig::Config::Options options {};
+  options.arena = true;
+  const cppconfig::Config arena { { data / "config06" / "default.json", data / "config06" / "myenvname.json" }, options };
+  ASSERT_EQ (arena.get<int32_t> ("c"), 30);
+
+  ASSERT_THROW (cppconfig::Config { std::vector<std::filesystem::path> {} }, std::invalid_argument);
+  ASSERT_THROW ((cppconfig::Config { { data / "config06" / "default.json", data / "missing.json" } }), std::ios_base::failure);
+}
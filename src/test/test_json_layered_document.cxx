@@ -0,0 +1,83 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+#include <cppconfig/json_layered_document.h>
+#include <cppconfig/json_parser.h>
+
+
+namespace {
+
+// ----------------------------------------------------------------------------
+// parse
+// ----------------------------------------------------------------------------
+cppconfig::json::JsonValue parse (std::string_view json) {
+  cppconfig::json::JsonParser parser {};
+  return std::move (parser.parse (json.data(), json.size()).value());
+}
+
+}
+
+// ----------------------------------------------------------------------------
+// test_layers
+// ----------------------------------------------------------------------------
+TEST (LayeredDocument, test_layers) {
+  cppconfig::json::LayeredDocument doc {};
+  doc.set ("default", parse (R"({ "a": 1, "b": { "c": "x", "d": [ 1 ] }, "e": "keep", "f": { "g": 1 } })"));
+  doc.set ("host", parse (R"({ "b": { "d": [ 2, 3 ], "h": true }, "a": 2, "e": 5, "f": null })"));
+  ASSERT_EQ (doc.size(), 2);
+
+  const auto root { doc.root() };
+  ASSERT_EQ (doc.value (root.find ("a").value()).asInt(), 2);
+  ASSERT_EQ (doc.value (root.find ("b").value().find ("c").value()).asStringView(), "x");
+  ASSERT_TRUE (doc.value (root.find ("b").value().find ("h").value()).asBool());
+  ASSERT_EQ (doc.value (root.find ("e").value()).asInt(), 5);
+  ASSERT_TRUE (doc.value (root.find ("f").value()).isNull());
+  ASSERT_FALSE (root.find ("f").value().find ("g").has_value());
+  ASSERT_FALSE (root.find ("missing").has_value());
+
+  // arrays are concatenated
+  const auto d { root.find ("b").value().find ("d").value() };
+  ASSERT_EQ (doc.value (d.at (0).value()).asInt(), 1);
+  ASSERT_EQ (doc.value (d.at (2).value()).asInt(), 3);
+  ASSERT_FALSE (d.at (3).has_value());
+  ASSERT_EQ (doc.value (d).asArray().size(), 3);
+
+  // containers of several layers are merged once
+  const auto &b { doc.value (root.find ("b").value()) };
+  ASSERT_EQ (b["d"].asArray().size(), 3);
+  ASSERT_EQ (&doc.value (root.find ("b").value()), &b);
+
+  // values of a single layer are not copied
+  const auto &g { doc.value (doc.root().find ("a").value()) };
+  ASSERT_EQ (g.asInt(), 2);
+}
+
+// ----------------------------------------------------------------------------
+// test_replace
+// ----------------------------------------------------------------------------
+TEST (LayeredDocument, test_replace) {
+  cppconfig::json::LayeredDocument doc {};
+  doc.set ("default", parse (R"({ "a": 1, "b": 1 })"));
+  doc.set ("env", parse (R"({ "a": 2, "b": 2 })"));
+  doc.set ("host", parse (R"({ "a": 3 })"));
+
+  ASSERT_EQ (doc.value (doc.root().find ("a").value()).asInt(), 3);
+  ASSERT_EQ (doc.value (doc.root().find ("b").value()).asInt(), 2);
+
+  // a replaced layer keeps its precedence
+  doc.set ("env", parse (R"({ "a": 4, "b": 4 })"));
+  ASSERT_EQ (doc.size(), 3);
+  ASSERT_EQ (doc.value (doc.root().find ("a").value()).asInt(), 3);
+  ASSERT_EQ (doc.value (doc.root().find ("b").value()).asInt(), 4);
+
+  ASSERT_TRUE (doc.remove ("host"));
+  ASSERT_FALSE (doc.remove ("host"));
+  ASSERT_EQ (doc.size(), 2);
+  ASSERT_EQ (doc.value (doc.root().find ("a").value()).asInt(), 4);
+}
@@ -0,0 +1,100 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+#include <cppconfig/json_parser.h>
+
+
+constexpr std::string_view kJsonStr01 { R"({
+  "name": "lazy \"doc\"",
+  "enabled" : true,
+  "nothing": null,
+  "items": [ 1, "two", [ 3.5, { "four": 4 } ], {}, ],
+  "nested": { "a": { "b": [ "}", "]" ] }, "cA": false },
+  "name": "repeated"
+})" };
+
+
+// ----------------------------------------------------------------------------
+// test_lookup
+// ----------------------------------------------------------------------------
+TEST (LazyDocument, test_lookup) {
+  cppconfig::json::JsonParser parser {};
+  const auto doc { parser.parseLazy (kJsonStr01.data(), kJsonStr01.size()) };
+  ASSERT_TRUE (doc.has_value());
+
+  const auto root { doc.value().root() };
+  ASSERT_EQ (doc.value().value (root.find ("name").value()).asStringView(), "lazy \"doc\"");
+  ASSERT_TRUE (doc.value().value (root.find ("enabled").value()).asBool());
+  ASSERT_TRUE (doc.value().value (root.find ("nothing").value()).isNull());
+  ASSERT_FALSE (root.find ("missing").has_value());
+  ASSERT_FALSE (root.at (0).has_value());
+
+  const auto items { root.find ("items").value() };
+  ASSERT_EQ (doc.value().value (items.at (1).value()).asStringView(), "two");
+  ASSERT_EQ (doc.value().value (items.at (2).value().at (1).value().find ("four").value()).asInt(), 4);
+  ASSERT_TRUE (doc.value().value (items.at (3).value()).isObject());
+  ASSERT_FALSE (items.at (4).has_value());
+  ASSERT_FALSE (items.find ("four").has_value());
+
+  const auto nested { root.find ("nested").value() };
+  ASSERT_EQ (doc.value().value (nested.find ("a").value().find ("b").value().at (1).value()).asStringView(), "]");
+  ASSERT_FALSE (doc.value().value (nested.find ("cA").value()).asBool());
+
+  // containers are parsed once and memoized
+  const auto &value { doc.value().value (nested) };
+  ASSERT_EQ (value["a"]["b"].asArray().size(), 2);
+  ASSERT_EQ (&doc.value().value (root.find ("nested").value()), &value);
+}
+
+// ----------------------------------------------------------------------------
+// test_invalid
+// ----------------------------------------------------------------------------
+TEST (LazyDocument, test_invalid) {
+  for (const std::string_view json: { "", "12", "{", "{ \"a\": [ 1 2 ] }", "{ \"a\": { \"b\": tru } }" }) {
+    cppconfig::json::JsonParser parser {};
+    ASSERT_TRUE (parser.parse (json.data(), json.size()) == std::nullopt) << json;
+
+    const auto error { parser.error() };
+    ASSERT_FALSE (parser.parseLazy (json.data(), json.size()).has_value()) << json;
+    ASSERT_EQ (parser.error().code, error.code) << json;
+    ASSERT_EQ (parser.error().line, error.line) << json;
+    ASSERT_EQ (parser.error().column, error.column) << json;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// test_overlay
+// ----------------------------------------------------------------------------
+TEST (LazyDocument, test_overlay) {
+  constexpr std::string_view kBottom { R"({ "a": 1, "b": { "c": "x", "d": [ 1 ] }, "e": "keep", "f": { "g": 1 } })" };
+  constexpr std::string_view kTop { R"({ "b": { "d": [ 2, 3 ], "h": true }, "a": 2, "e": 5, "f": null })" };
+
+  cppconfig::json::JsonParser parser {};
+  auto doc { parser.parseLazy (kBottom.data(), kBottom.size()) };
+  auto top { parser.parseLazy (kTop.data(), kTop.size()) };
+  ASSERT_TRUE (doc.has_value() && top.has_value());
+
+  doc.value().overlay (std::move (top.value()));
+
+  const auto root { doc.value().root() };
+  ASSERT_EQ (doc.value().value (root.find ("a").value()).asInt(), 2);
+  ASSERT_EQ (doc.value().value (root.find ("b").value().find ("c").value()).asStringView(), "x");
+  ASSERT_TRUE (doc.value().value (root.find ("b").value().find ("h").value()).asBool());
+  ASSERT_EQ (doc.value().value (root.find ("e").value()).asInt(), 5);
+  ASSERT_TRUE (doc.value().value (root.find ("f").value()).isNull());
+  ASSERT_FALSE (root.find ("f").value().find ("g").has_value());
+
+  // arrays are concatenated
+  const auto d { root.find ("b").value().find ("d").value() };
+  ASSERT_EQ (doc.value().value (d.at (0).value()).asInt(), 1);
+  ASSERT_EQ (doc.value().value (d.at (2).value()).asInt(), 3);
+  ASSERT_FALSE (d.at (3).has_value());
+  ASSERT_EQ (doc.value().value (d).asArray().size(), 3);
+  ASSERT_EQ (doc.value().value (root.find ("b").value())["d"].asArray().size(), 3);
+}
@@ -4,6 +4,9 @@
 // Copyright (c) 2023-2024 Carlos Carrasco
 // ----------------------------------------------------------------------------
 #include <cstring>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
 
 #include <gtest/gtest.h>
 
@@ -268,3 +271,135 @@ TEST (JsonParser, test_error5) {
   ASSERT_EQ (parser.error().line, 1);
   ASSERT_EQ (parser.error().column, 10);
 }
+
+// ----------------------------------------------------------------------------
+// test_max_depth
+// ----------------------------------------------------------------------------
+TEST (JsonParser, test_max_depth) {
+  cppconfig::json::JsonParser::Options options {};
+  options.maxDepth = 3;
+
+  cppconfig::json::JsonParser parser { options };
+  ASSERT_TRUE (parser.parse (R"({ "a": [ { "b": 1 }, {} ] })").has_value());
+  ASSERT_TRUE (parser.parseTape (R"({ "a": [ { "b": 1 }, {} ] })").has_value());
+
+  ASSERT_FALSE (parser.parse (R"({ "a": [ { "b": [] } ] })").has_value());
+  ASSERT_EQ (parser.error().code, cppconfig::json::JsonParser::ErrorCode::kMaxDepth);
+  ASSERT_EQ (parser.error().line, 0);
+  ASSERT_EQ (parser.error().column, 17);
+
+  ASSERT_FALSE (parser.parseTape (R"({ "a": [ { "b": [] } ] })").has_value());
+  ASSERT_EQ (parser.error().code, cppconfig::json::JsonParser::ErrorCode::kMaxDepth);
+
+  // far deeper than the default limit: rejected without exhausting the call stack
+  const std::string deep { std::string (100000, '[') + std::string (100000, ']') };
+
+  cppconfig::json::JsonParser defaultParser {};
+  ASSERT_FALSE (defaultParser.parse (deep.data(), deep.size()).has_value());
+  ASSERT_EQ (defaultParser.error().code, cppconfig::json::JsonParser::ErrorCode::kMaxDepth);
+  ASSERT_EQ (defaultParser.error().column, 1025);
+
+  options.maxDepth = deep.size();
+  cppconfig::json::JsonParser deepParser { options };
+  const auto root { deepParser.parse (deep.data(), deep.size()) };
+  ASSERT_TRUE (root.has_value());
+  ASSERT_EQ (root.value()[0][0][0].asArray().size(), 1);
+}
+
+// ----------------------------------------------------------------------------
+// test_resource
+// ----------------------------------------------------------------------------
+TEST (JsonParser, test_resource) {
+  // counts the bytes requested to an upstream resource
+  struct Counter: std::pmr::memory_resource {
+    size_t bytes { 0 };
+
+    void * do_allocate (size_t n, size_t align) override {
+      bytes += n;
+      return std::pmr::new_delete_resource()->allocate (n, align);
+    }
+
+    void do_deallocate (void *p, size_t n, size_t align) override {
+      std::pmr::new_delete_resource()->deallocate (p, n, align);
+    }
+
+    bool do_is_equal (const std::pmr::memory_resource &other) const noexcept override {
+      return this == &other;
+    }
+  };
+
+  constexpr char kJson[] = R"({ "a long key, not a short string": [ 1, "s\u00e9", { "b": null } ], "c": "value" })";
+
+  Counter counter {};
+  std::pmr::monotonic_buffer_resource arena { &counter };
+
+  cppconfig::json::JsonParser::Options options {};
+  options.resource = &arena;
+
+  cppconfig::json::JsonParser parser { options };
+  auto root { parser.parse (kJson, std::strlen (kJson)) };
+  ASSERT_TRUE (root.has_value());
+  ASSERT_GT (counter.bytes, 0);
+
+  const auto &array { root.value()["a long key, not a short string"] };
+  ASSERT_EQ (array.asArray().get_allocator().resource(), &arena);
+  ASSERT_EQ (array[1].asStringView(), "s\xc3\xa9");
+  ASSERT_TRUE (array[2]["b"].isNull());
+  ASSERT_EQ (array[2].asObject().get_allocator().resource(), &arena);
+  ASSERT_EQ (root.value()["c"].asStringView(), "value");
+
+  // strings are copied to the arena, so the input is not needed
+  ASSERT_TRUE (array[1].asStringView().data() < kJson || array[1].asStringView().data() >= kJson + sizeof (kJson));
+
+  // copies do not use the arena
+  const cppconfig::json::JsonValue copy { array };
+  ASSERT_NE (copy.asArray().get_allocator().resource(), &arena);
+  ASSERT_EQ (copy[2]["b"].isNull(), true);
+}
+
+// ----------------------------------------------------------------------------
+// test_handler
+// ----------------------------------------------------------------------------
+TEST (JsonParser, test_handler) {
+  struct Recorder {
+    std::string events {};
+
+    void onObjectBegin() { events += "{"; }
+    void onArrayBegin() { events += "["; }
+    void onEnd() { events += "}"; }
+    void onKey (std::string_view key) { events += std::string { key } + ":"; }
+    void onString (std::string_view str) { events += "s(" + std::string { str } + ")"; }
+    void onInt (int64_t v) { events += "i(" + std::to_string (v) + ")"; }
+    void onDouble (double v) { events += "d(" + std::to_string (v) + ")"; }
+    void onBool (bool v) { events += v ? "t" : "f"; }
+    void onNull() { events += "n"; }
+  };
+
+  constexpr const char *json { R"({ "a": [ 1, 2.5, "x\ty", true, false, null ], "b": {}, "cA": [] })" };
+
+  cppconfig::json::JsonParser parser;
+
+  Recorder recorder {};
+  ASSERT_TRUE (parser.parse (json, 0, recorder));
+  ASSERT_EQ (recorder.events, "{a:[i(1)d(2.500000)s(x\ty)tfn}b:{}cA:[}}");
+
+  // a handler only defines the events it needs
+  struct Table {
+    std::unordered_map<std::string, int64_t> values {};
+    std::string key {};
+
+    void onKey (std::string_view k) { key = k; }
+    void onInt (int64_t v) { values.emplace (key, v); }
+  };
+
+  constexpr const char *table { R"({ "one": 1, "two": 2, "skip": "str", "three": 3 })" };
+
+  Table handler {};
+  ASSERT_TRUE (parser.parse (table, 0, handler));
+  ASSERT_EQ (handler.values, (std::unordered_map<std::string, int64_t> { { "one", 1 }, { "two", 2 }, { "three", 3 } }));
+
+  Recorder invalid {};
+  ASSERT_FALSE (parser.parse (R"({ "a": [ 1, 2 })", 0, invalid));
+  ASSERT_EQ (parser.error().code, cppconfig::json::JsonParser::ErrorCode::kExpectCommaOrEndArray);
+  ASSERT_EQ (invalid.events, "{a:[i(1)i(2)");
+}
@@ -0,0 +1,60 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <cppconfig/json_parser.h>
+#include <cppconfig/json_path_index.h>
+
+
+// ----------------------------------------------------------------------------
+// test_find
+// ----------------------------------------------------------------------------
+TEST (PathIndex, test_find) {
+  cppconfig::json::JsonParser parser {};
+  const auto root { parser.parse (
+    R"({ "servers": [ { "host": "a", "port": 1 }, { "host": "b" } ], "a.b": { "c": [ [ 1, 2 ] ] }, "x[0]": 1, "": 2 })"
+  ) };
+  ASSERT_TRUE (root.has_value());
+
+  const cppconfig::json::PathIndex index { root.value() };
+
+  ASSERT_EQ (index.find ("servers")->asArray().size(), 2);
+  ASSERT_EQ (index.find ("servers[0].port")->asInt(), 1);
+  ASSERT_EQ (index.find ("servers[1].host")->asStringView(), "b");
+  ASSERT_EQ (index.find ("a\\.b.c[0][1]")->asInt(), 2);
+  ASSERT_EQ (index.find ("servers[1].port"), nullptr);
+  ASSERT_EQ (index.find ("servers.0.port"), nullptr);
+  ASSERT_EQ (index.find ("a.b"), nullptr);
+  ASSERT_EQ (index.find (""), nullptr);
+
+  // keys that cannot be written in a path are left out
+  ASSERT_EQ (index.find ("x[0]"), nullptr);
+  ASSERT_EQ (index.size(), 11);
+
+  // big trees
+  std::string json { "{" };
+  for (int i { 0 }; i < 1000; ++i) {
+    const auto n { std::to_string (i) };
+    json += i? ", \"k" : "\"k";
+    json += n;
+    json += "\": { \"v\": [ ";
+    json += n;
+    json += " ] }";
+  }
+  json += "}";
+
+  const auto big { parser.parse (json.c_str()) };
+  const cppconfig::json::PathIndex bigIndex { big.value() };
+  ASSERT_EQ (bigIndex.size(), 3000);
+  for (int i { 0 }; i < 1000; ++i) {
+    std::string path { "k" };
+    path += std::to_string (i);
+    path += ".v[0]";
+    ASSERT_EQ (bigIndex.find (path)->asInt(), i);
+  }
+}
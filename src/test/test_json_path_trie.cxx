@@ -0,0 +1,133 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <cppconfig/json_parser.h>
+#include <cppconfig/json_path_trie.h>
+
+
+namespace {
+
+// ----------------------------------------------------------------------------
+// paths
+// ----------------------------------------------------------------------------
+template<typename Views>
+std::vector<std::string> paths (const Views &views) {
+  std::vector<std::string> result {};
+  for (const auto view: views)
+    result.emplace_back (view.path());
+
+  return result;
+}
+
+}
+
+// ----------------------------------------------------------------------------
+// test_find
+// ----------------------------------------------------------------------------
+TEST (PathTrie, test_find) {
+  cppconfig::json::JsonParser parser {};
+  const auto root { parser.parse (
+    R"({ "servers": [ { "host": "a", "port": 1 }, { "host": "b" } ], "a.b": { "c": [ [ 1, 2 ] ] }, "x[0]": 1, "": 2 })"
+  ) };
+  ASSERT_TRUE (root.has_value());
+
+  const cppconfig::json::PathTrie trie { root.value() };
+
+  // the root, and everything but the keys that cannot be written in a path
+  ASSERT_EQ (trie.size(), 12);
+  ASSERT_EQ (trie.root().descendants(), 11);
+  ASSERT_EQ (&trie.find ("")->value(), &root.value());
+
+  const auto port { trie.find ("servers[0].port") };
+  ASSERT_TRUE (port.has_value());
+  ASSERT_EQ (port->value().asInt(), 1);
+  ASSERT_EQ (port->key(), "port");
+  ASSERT_EQ (port->path(), "servers[0].port");
+
+  const auto item { trie.find ("a\\.b.c[0][1]") };
+  ASSERT_TRUE (item->isItem());
+  ASSERT_EQ (item->index(), 1);
+  ASSERT_EQ (item->key(), "");
+  ASSERT_EQ (item->value().asInt(), 2);
+  ASSERT_EQ (trie.find ("a\\.b")->key(), "a.b");
+
+  ASSERT_FALSE (trie.find ("servers[1].port").has_value());
+  ASSERT_FALSE (trie.find ("servers[2]").has_value());
+  ASSERT_FALSE (trie.find ("servers.host").has_value());
+  ASSERT_FALSE (trie.find ("a.b").has_value());
+  ASSERT_FALSE (trie.find ("x[0]").has_value());
+}
+
+// ----------------------------------------------------------------------------
+// test_prefix
+// ----------------------------------------------------------------------------
+TEST (PathTrie, test_prefix) {
+  cppconfig::json::JsonParser parser {};
+  const auto root { parser.parse (
+    R"({ "features": { "beta": true, "dark": { "enabled": false, "users": [ 1, 2 ] } }, "port": 80 })"
+  ) };
+  const cppconfig::json::PathTrie trie { root.value() };
+
+  ASSERT_EQ (paths (trie.prefix ("features")), (std::vector<std::string> {
+    "features.beta", "features.dark", "features.dark.enabled", "features.dark.users",
+    "features.dark.users[0]", "features.dark.users[1]"
+  }));
+  ASSERT_EQ (trie.prefix ("").size(), trie.size() - 1);
+  ASSERT_TRUE (trie.prefix ("features.beta").empty());
+  ASSERT_TRUE (trie.prefix ("missing").empty());
+
+  ASSERT_EQ (paths (trie.children ("features")), (std::vector<std::string> { "features.beta", "features.dark" }));
+  ASSERT_EQ (paths (trie.children ("")), (std::vector<std::string> { "features", "port" }));
+  ASSERT_TRUE (trie.children ("port").empty());
+
+  // longest prefix
+  ASSERT_EQ (trie.longestPrefix ("features.beta.rollout.percent").path(), "features.beta");
+  ASSERT_EQ (trie.longestPrefix ("features.dark.users[1]").path(), "features.dark.users[1]");
+  ASSERT_EQ (trie.longestPrefix ("features.dark.users[7]").path(), "features.dark.users");
+  ASSERT_EQ (trie.longestPrefix ("missing.key"), trie.root());
+
+  // big trees
+  std::string json { "{ \"flags\": {" };
+  for (int i { 0 }; i < 1000; ++i) {
+    json += i? ", \"f" : "\"f";
+    json += std::to_string (i);
+    json += "\": { \"on\": true }";
+  }
+  json += "} }";
+
+  const auto big { parser.parse (json.c_str()) };
+  const cppconfig::json::PathTrie bigTrie { big.value() };
+  ASSERT_EQ (bigTrie.prefix ("flags").size(), 2000);
+  ASSERT_EQ (bigTrie.children ("flags").size(), 1000);
+  ASSERT_EQ (bigTrie.find ("flags.f999.on")->value().asBool(), true);
+}
+
+// ----------------------------------------------------------------------------
+// test_match
+// ----------------------------------------------------------------------------
+TEST (PathTrie, test_match) {
+  cppconfig::json::JsonParser parser {};
+  const auto root { parser.parse (R"({
+    "upstreams": { "auth": { "timeout": 5 }, "cache": { "size": 1 }, "db": { "timeout": 30 } },
+    "servers": [ { "host": "a" }, { "host": "b" } ]
+  })") };
+  const cppconfig::json::PathTrie trie { root.value() };
+
+  const auto timeouts { trie.match ("upstreams.*.timeout") };
+  ASSERT_EQ (paths (timeouts), (std::vector<std::string> { "upstreams.auth.timeout", "upstreams.db.timeout" }));
+  ASSERT_EQ (timeouts[1].value().asInt(), 30);
+
+  ASSERT_EQ (paths (trie.match ("servers[*].host")), (std::vector<std::string> { "servers[0].host", "servers[1].host" }));
+  ASSERT_EQ (paths (trie.match ("servers.*.host")), (std::vector<std::string> { "servers[0].host", "servers[1].host" }));
+  ASSERT_EQ (trie.match ("*.*").size(), 5);
+  ASSERT_EQ (paths (trie.match ("servers[1]")), (std::vector<std::string> { "servers[1]" }));
+  ASSERT_TRUE (trie.match ("upstreams.*.missing").empty());
+  ASSERT_TRUE (trie.match ("servers[x]").empty());
+}
@@ -0,0 +1,98 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <cppconfig/json_parser.h>
+#include <cppconfig/json_shared_value.h>
+
+
+namespace {
+
+constexpr const char *kJsonStr01 {
+  R"({ "a": 1, "b": { "c": "x", "d": [ 1, { "e": true } ] }, "f": { "g": null, "h": 2.5 } })"
+};
+
+}
+
+// ----------------------------------------------------------------------------
+// test_lookup
+// ----------------------------------------------------------------------------
+TEST (SharedValue, test_lookup) {
+  cppconfig::json::JsonParser parser {};
+  const cppconfig::json::SharedValue root { parser.parse (kJsonStr01).value() };
+
+  ASSERT_TRUE (root.isObject());
+  ASSERT_EQ (root.size(), 3);
+  ASSERT_EQ (root.find ("a")->asInt(), 1);
+  ASSERT_EQ (root.find ("b")->find ("c")->asStringView(), "x");
+  ASSERT_TRUE (root.find ("b")->find ("d")->at (1)->find ("e")->asBool());
+  ASSERT_TRUE (root.find ("f")->find ("g")->isNull());
+  ASSERT_EQ (root.find ("f")->find ("h")->asFloat(), 2.5);
+  ASSERT_EQ (root.find ("missing"), nullptr);
+  ASSERT_EQ (root.find ("b")->find ("d")->at (2), nullptr);
+  ASSERT_EQ (root.find ("a")->find ("x"), nullptr);
+  ASSERT_THROW (root.find ("a")->asStringView(), std::bad_variant_access);
+  ASSERT_THROW (root.find ("b")->asArray(), std::bad_variant_access);
+  ASSERT_EQ (root.asObject()[1].first, "b");
+
+  // big objects are indexed
+  std::string json { "{" };
+  for (int i { 0 }; i < 100; ++i)
+    json += (i? ", \"k" : "\"k") + std::to_string (i) + "\": " + std::to_string (i);
+  json += "}";
+
+  const cppconfig::json::SharedValue big { parser.parse (json.c_str()).value() };
+  for (int i { 0 }; i < 100; ++i)
+    ASSERT_EQ (big.find ("k" + std::to_string (i))->asInt(), i);
+  ASSERT_EQ (big.find ("k100"), nullptr);
+}
+
+// ----------------------------------------------------------------------------
+// test_set
+// ----------------------------------------------------------------------------
+TEST (SharedValue, test_set) {
+  using Step = cppconfig::json::SharedValue::Step;
+
+  cppconfig::json::JsonParser parser {};
+  const cppconfig::json::SharedValue v1 { parser.parse (kJsonStr01).value() };
+
+  const std::vector<Step> path { "b", "d", size_t { 1 }, "e" };
+  const auto v2 { v1.set (path, cppconfig::json::SharedValue { cppconfig::json::JsonValue { cppconfig::json::JsonToken { false } } }) };
+  ASSERT_TRUE (v2.has_value());
+
+  // the previous version is not modified
+  ASSERT_TRUE (v1.find ("b")->find ("d")->at (1)->find ("e")->asBool());
+  ASSERT_FALSE (v2->find ("b")->find ("d")->at (1)->find ("e")->asBool());
+
+  // only the containers along the path are copied
+  ASSERT_FALSE (v2->shares (v1));
+  ASSERT_FALSE (v2->find ("b")->shares (*v1.find ("b")));
+  ASSERT_FALSE (v2->find ("b")->find ("d")->shares (*v1.find ("b")->find ("d")));
+  ASSERT_TRUE (v2->find ("f")->shares (*v1.find ("f")));
+  ASSERT_EQ (v2->find ("b")->find ("c")->asStringView(), "x");
+  ASSERT_EQ (v2->find ("a")->asInt(), 1);
+
+  // missing members are added, items appended
+  const std::vector<Step> added { "x", "y" };
+  const auto v3 { v2->set (added, v1) };
+  ASSERT_TRUE (v3.has_value());
+  ASSERT_TRUE (v3->find ("x")->find ("y")->shares (v1));
+  ASSERT_EQ (v2->find ("x"), nullptr);
+
+  const std::vector<Step> appended { "b", "d", size_t { 2 } };
+  const auto v4 { v3->set (appended, cppconfig::json::SharedValue {}) };
+  ASSERT_TRUE (v4.has_value());
+  ASSERT_EQ (v4->find ("b")->find ("d")->size(), 3);
+  ASSERT_TRUE (v4->find ("b")->find ("d")->at (2)->isNull());
+
+  // paths through values that are not containers of the right kind
+  ASSERT_FALSE (v1.set (std::vector<Step> { "a", "b" }, v1).has_value());
+  ASSERT_FALSE (v1.set (std::vector<Step> { "b", size_t { 0 } }, v1).has_value());
+  ASSERT_FALSE (v1.set (std::vector<Step> { "b", "d", size_t { 3 } }, v1).has_value());
+  ASSERT_FALSE (v1.set (std::vector<Step> { "z", size_t { 0 } }, v1).has_value());
+}
@@ -0,0 +1,147 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#include <unistd.h>
+
+#include <string_view>
+#include <thread>
+#include <tuple>
+
+#include <gtest/gtest.h>
+
+#include <cppconfig/json_stream_parser.h>
+
+
+constexpr std::string_view kJsonStr01 { R"({
+  "name": "stream \"parser\" é😀",
+  "enabled": true,
+  "disabled": false,
+  "nothing": null,
+  "count": 1234567,
+  "ratio": -12.5e-3,
+  "items": [ 1, "two", [ 3.5, { "four": 4 } ], {} ],
+  "nested": { "a": { "b": { "c": [] } } }
+})" };
+
+
+// ----------------------------------------------------------------------------
+// equals
+// ----------------------------------------------------------------------------
+static bool equals (const cppconfig::json::JsonValue &a, const cppconfig::json::JsonValue &b) {
+  if (a.type() != b.type())
+    return false;
+
+  if (a.isBool()) return a.asBool() == b.asBool();
+  if (a.isInt()) return a.asInt() == b.asInt();
+  if (a.isFloat()) return a.asFloat() == b.asFloat();
+  if (a.isString()) return a.asStringView() == b.asStringView();
+  if (a.isNull()) return true;
+
+  if (a.isArray()) {
+    if (a.asArray().size() != b.asArray().size())
+      return false;
+    for (size_t i { 0 }; i < a.asArray().size(); ++i) {
+      if (!equals (a[i], b[i]))
+        return false;
+    }
+    return true;
+  }
+
+  if (a.asObject().size() != b.asObject().size())
+    return false;
+  for (const auto &[k, v]: a.asObject()) {
+    if (!b.exists (k) || !equals (v, b[k]))
+      return false;
+  }
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+// test_chunks
+// ----------------------------------------------------------------------------
+TEST (JsonStreamParser, test_chunks) {
+  cppconfig::json::JsonParser parser {};
+  const auto expected { parser.parse (kJsonStr01.data(), kJsonStr01.size()) };
+  ASSERT_TRUE (expected.has_value());
+
+  for (const size_t chunkSize: { size_t { 1 }, size_t { 2 }, size_t { 3 }, size_t { 7 }, size_t { 64 }, kJsonStr01.size() }) {
+    cppconfig::json::JsonStreamParser stream {};
+
+    for (size_t i { 0 }; i < kJsonStr01.size(); i += chunkSize) {
+      const auto status { stream.feed (kJsonStr01.data() + i, std::min (chunkSize, kJsonStr01.size() - i)) };
+      ASSERT_NE (status, cppconfig::json::JsonStreamParser::Status::kError) << chunkSize;
+    }
+
+    ASSERT_EQ (stream.finish(), cppconfig::json::JsonStreamParser::Status::kDone) << chunkSize;
+
+    const auto root { stream.take() };
+    ASSERT_TRUE (root.has_value());
+    ASSERT_TRUE (equals (root.value(), expected.value())) << chunkSize;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// test_errors
+// ----------------------------------------------------------------------------
+TEST (JsonStreamParser, test_errors) {
+  using ErrorCode = cppconfig::json::JsonParser::ErrorCode;
+
+  const std::string deep (2000, '[');
+
+  const std::vector<std::tuple<std::string_view, ErrorCode, size_t, size_t>> invalid {
+    { "", ErrorCode::kExpectAny, 0, 0 },
+    { "12", ErrorCode::kExpectObject, 0, 2 },
+    { "{", ErrorCode::kExpectPair, 0, 1 },
+    { "{ \"a\"", ErrorCode::kExpectPair, 0, 5 },
+    { "{ \"a\":", ErrorCode::kExpectPair, 0, 6 },
+    { "{ \"a\": 1", ErrorCode::kExpectCommaOrEndObj, 0, 8 },
+    { "{ \"a\": 1 \"b\" }", ErrorCode::kExpectCommaOrEndObj, 0, 12 },
+    { "[ 1,\n 2 ", ErrorCode::kExpectCommaOrEndArray, 1, 3 },
+    { "[ 1,\n :", ErrorCode::kExpectAny, 1, 2 },
+    { "{\n \"a\": [ tru ] }", ErrorCode::kPrematureEnd, 1, 9 },
+    { "{\n\"test\":\n \"aa\\kbbb\" }", ErrorCode::kInvalidEscape, 2, 6 },
+    { "{ \"test", ErrorCode::kPrematureEnd, 0, 7 },
+    { std::string_view { deep }.substr (0, 1025), ErrorCode::kMaxDepth, 0, 1025 }
+  };
+
+  for (const auto &[json, code, line, column]: invalid) {
+    for (const size_t chunkSize: { size_t { 1 }, size_t { 5 }, std::max (json.size(), size_t { 1 }) }) {
+      cppconfig::json::JsonStreamParser stream {};
+
+      for (size_t i { 0 }; i < json.size(); i += chunkSize)
+        stream.feed (json.data() + i, std::min (chunkSize, json.size() - i));
+
+      ASSERT_EQ (stream.finish(), cppconfig::json::JsonStreamParser::Status::kError) << json;
+      ASSERT_FALSE (stream.take().has_value());
+      ASSERT_EQ (stream.error().code, code) << json;
+      ASSERT_EQ (stream.error().line, line) << json << " " << chunkSize;
+      ASSERT_EQ (stream.error().column, column) << json << " " << chunkSize;
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+// test_fd
+// ----------------------------------------------------------------------------
+TEST (JsonStreamParser, test_fd) {
+  int fds[2];
+  ASSERT_EQ (pipe (fds), 0);
+
+  std::thread writer { [fd = fds[1]] {
+    for (size_t i { 0 }; i < kJsonStr01.size(); i += 5)
+      (void) !write (fd, kJsonStr01.data() + i, std::min (size_t { 5 }, kJsonStr01.size() - i));
+    close (fd);
+  } };
+
+  cppconfig::json::JsonStreamParser stream {};
+  const auto root { stream.parse (fds[0], 16) };
+  writer.join();
+  close (fds[0]);
+
+  ASSERT_TRUE (root.has_value());
+  ASSERT_EQ (root.value()["count"].asInt(), 1234567);
+  ASSERT_EQ (root.value()["items"][2][1]["four"].asInt(), 4);
+  ASSERT_EQ (root.value()["name"].asStringView(), "stream \"parser\" \xc3\xa9\xf0\x9f\x98\x80");
+}
@@ -0,0 +1,102 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#include <cstring>
+#include <random>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <cppconfig/json_structural_index.h>
+
+
+// ----------------------------------------------------------------------------
+// test_empty
+// ----------------------------------------------------------------------------
+TEST (StructuralIndex, test_empty) {
+  cppconfig::json::StructuralIndex index {};
+
+  ASSERT_TRUE (index.build (nullptr, 0));
+  ASSERT_EQ (index.size(), 0);
+}
+
+// ----------------------------------------------------------------------------
+// test_positions
+// ----------------------------------------------------------------------------
+TEST (StructuralIndex, test_positions) {
+  constexpr const char *json { R"({ "a b": [12, true],"c":"x\"y" })" };
+
+  cppconfig::json::StructuralIndex index {};
+  ASSERT_TRUE (index.build (json, std::strlen (json)));
+
+  const std::vector<uint32_t> expected {
+    0,  // {
+    1,  // whitespace
+    2,  // "
+    3,  // a
+    4,  // whitespace
+    5,  // b
+    6,  // "
+    7,  // :
+    8,  // whitespace
+    9,  // [
+    10, // 12
+    12, // ,
+    13, // whitespace
+    14, // true
+    18, // ]
+    19, // ,
+    20, // "
+    21, // c
+    22, // "
+    23, // :
+    24, // "
+    25, // x
+    26, // backslash
+    27, // "
+    28, // y
+    29, // "
+    30, // whitespace
+    31  // }
+  };
+
+  ASSERT_EQ (index.positions(), expected);
+}
+
+// ----------------------------------------------------------------------------
+// test_isa
+// ----------------------------------------------------------------------------
+TEST (StructuralIndex, test_isa) {
+  std::mt19937 rng { 1234 };
+  std::uniform_int_distribution<size_t> dist { 0, 19 };
+  constexpr const char kAlphabet[] { "{}[]:,\"\\ \t\n\r\0a1.-xyz" };
+
+  std::string json (64 * 300 + 17, ' ');
+  for (auto &c: json)
+    c = kAlphabet[dist (rng)];
+
+  cppconfig::json::StructuralIndex reference {};
+  ASSERT_TRUE (reference.build (json.data(), json.size(), cppconfig::util::SimdUtil::Isa::kScalar));
+
+  for (const auto isa: {
+    cppconfig::util::SimdUtil::Isa::kSse42,
+    cppconfig::util::SimdUtil::Isa::kAvx2,
+    cppconfig::util::SimdUtil::Isa::kNeon
+  }) {
+    if (!cppconfig::util::SimdUtil::supports (isa))
+      continue;
+
+    for (const size_t size: { json.size(), size_t { 64 }, size_t { 63 }, size_t { 1 } }) {
+      cppconfig::json::StructuralIndex expected {};
+      ASSERT_TRUE (expected.build (json.data(), size, cppconfig::util::SimdUtil::Isa::kScalar));
+
+      cppconfig::json::StructuralIndex index {};
+      ASSERT_TRUE (index.build (json.data(), size, isa));
+      ASSERT_EQ (index.positions(), expected.positions()) << cppconfig::util::SimdUtil::toCString (isa);
+    }
+  }
+
+  ASSERT_GT (reference.size(), 0);
+}
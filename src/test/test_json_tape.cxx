@@ -0,0 +1,109 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <cppconfig/json_parser.h>
+
+
+constexpr std::string_view kJsonStr01 { R"({
+  "name": "tape \"test\"",
+  "enabled": true,
+  "disabled": false,
+  "nothing": null,
+  "count": 1234567,
+  "ratio": -12.5e-3,
+  "items": [ 1, "two", [ 3.5, { "four": 4 } ], {} ],
+  "last": "end"
+})" };
+
+
+// ----------------------------------------------------------------------------
+// test_parse
+// ----------------------------------------------------------------------------
+TEST (Tape, test_parse) {
+  cppconfig::json::JsonParser parser {};
+  const auto tape { parser.parseTape (kJsonStr01.data(), kJsonStr01.size()) };
+  ASSERT_TRUE (tape.has_value());
+
+  const auto root { tape.value().root() };
+  ASSERT_TRUE (root.isObject());
+  ASSERT_EQ (root.size(), 8);
+
+  ASSERT_EQ (root.find ("name").value().asStringView(), "tape \"test\"");
+  ASSERT_TRUE (root.find ("enabled").value().asBool());
+  ASSERT_FALSE (root.find ("disabled").value().asBool());
+  ASSERT_TRUE (root.find ("nothing").value().isNull());
+  ASSERT_EQ (root.find ("count").value().asInt(), 1234567);
+  ASSERT_EQ (root.find ("ratio").value().asFloat(), -12.5e-3);
+  ASSERT_FALSE (root.find ("missing").has_value());
+  ASSERT_THROW (root.find ("count").value().asFloat(), std::bad_variant_access);
+
+  // containers are skipped in one step
+  const auto items { root.find ("items").value() };
+  ASSERT_EQ (items.size(), 4);
+  ASSERT_EQ (items.at (2).value().at (1).value().find ("four").value().asInt(), 4);
+  ASSERT_EQ (items.at (3).value().size(), 0);
+  ASSERT_FALSE (items.at (4).has_value());
+  ASSERT_EQ (root.find ("last").value().asStringView(), "end");
+
+  std::vector<cppconfig::json::Tape::Tag> tags {};
+  for (const auto &v: items.asArray())
+    tags.push_back (v.tag());
+  ASSERT_EQ (tags, (std::vector<cppconfig::json::Tape::Tag> {
+    cppconfig::json::Tape::Tag::kInteger,
+    cppconfig::json::Tape::Tag::kString,
+    cppconfig::json::Tape::Tag::kArrayBegin,
+    cppconfig::json::Tape::Tag::kObjectBegin
+  }));
+}
+
+// ----------------------------------------------------------------------------
+// test_parse_errors
+// ----------------------------------------------------------------------------
+TEST (Tape, test_parse_errors) {
+  for (const std::string_view json: { "", "12", "{", "{ \"a\": 1", "{ \"a\": [ 1 2 ] }", "{ \"a\": tru }" }) {
+    cppconfig::json::JsonParser parser {};
+    ASSERT_TRUE (parser.parse (json.data(), json.size()) == std::nullopt) << json;
+
+    const auto error { parser.error() };
+    ASSERT_FALSE (parser.parseTape (json.data(), json.size()).has_value()) << json;
+    ASSERT_EQ (parser.error().code, error.code) << json;
+    ASSERT_EQ (parser.error().line, error.line) << json;
+    ASSERT_EQ (parser.error().column, error.column) << json;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// test_merge
+// ----------------------------------------------------------------------------
+TEST (Tape, test_merge) {
+  constexpr std::string_view kDst { R"({ "a": 1, "b": { "c": "x", "d": [ 1 ] }, "e": "keep", "f": null })" };
+  constexpr std::string_view kSrc { R"({ "b": { "d": [ 2, 3 ], "g": true }, "a": 2.5, "e": 5, "f": "set", "h": {} })" };
+
+  cppconfig::json::JsonParser parser {};
+  const auto dst { parser.parseTape (kDst.data(), kDst.size()) };
+  const auto src { parser.parseTape (kSrc.data(), kSrc.size()) };
+  ASSERT_TRUE (dst.has_value() && src.has_value());
+
+  const auto tape { cppconfig::json::Tape::merge (src.value(), dst.value()) };
+  const auto root { tape.root() };
+
+  ASSERT_EQ (root.size(), 5);
+  ASSERT_EQ (root.find ("a").value().asFloat(), 2.5); // a value of another type replaces it
+  ASSERT_EQ (root.find ("b").value().find ("c").value().asStringView(), "x");
+  ASSERT_TRUE (root.find ("b").value().find ("g").value().asBool());
+  ASSERT_EQ (root.find ("e").value().asInt(), 5);
+  ASSERT_EQ (root.find ("f").value().asStringView(), "set");
+  ASSERT_EQ (root.find ("h").value().size(), 0);
+
+  std::vector<int64_t> d {};
+  for (const auto &v: root.find ("b").value().find ("d").value().asArray())
+    d.push_back (v.asInt());
+  ASSERT_EQ (d, (std::vector<int64_t> { 1, 2, 3 }));
+}
@@ -51,3 +51,22 @@ TEST (JsonToken, test_constructor) {
   ASSERT_EQ (jt16.id(), cppconfig::json::JsonTokenId::kValueBoolean);
   ASSERT_EQ (jt16.value<bool>(), true);
 }
+
+// ----------------------------------------------------------------------------
+// test_borrow
+// ----------------------------------------------------------------------------
+TEST (JsonToken, test_borrow) {
+  const std::string str { "Hello World!" };
+
+  auto jt01 { cppconfig::json::JsonToken::borrow (str) };
+  ASSERT_EQ (jt01.id(), cppconfig::json::JsonTokenId::kValueString);
+  ASSERT_TRUE (jt01.borrowed());
+  ASSERT_EQ (jt01.view().data(), str.data());
+  ASSERT_EQ (jt01.takeString(), str);
+  ASSERT_EQ (jt01.view(), str);
+
+  cppconfig::json::JsonToken jt02 { std::string { "Hello!" } };
+  ASSERT_FALSE (jt02.borrowed());
+  ASSERT_EQ (jt02.view(), "Hello!");
+  ASSERT_EQ (jt02.takeString(), "Hello!");
+}
@@ -197,3 +197,160 @@ TEST (JsonTokenizer, test_escape_error) {
   ASSERT_EQ (tokenizer0.line(), 2);
   ASSERT_EQ (tokenizer0.column(), 6);
 }
+
+// ----------------------------------------------------------------------------
+// test_unicode_escape
+// ----------------------------------------------------------------------------
+TEST (JsonTokenizer, test_unicode_escape) {
+  const std::vector<std::pair<std::string_view, std::string_view>> valid {
+    { R"("A")", "A" },
+    { R"("éé")", "\xc3\xa9\xc3\xa9" },
+    { R"("€")", "\xe2\x82\xac" },
+    { R"("😀!")", "\xf0\x9f\x98\x80!" },
+    { R"("\u0000")", std::string_view { "\0", 1 } },
+    { R"("a\\b\/c")", "a\\b/c" }
+  };
+  const std::vector<std::string_view> invalid {
+    R"("\u12g4")", R"("\ud83d")", R"("\ud83dx\ude00")", R"("\ude00")", R"("\ud83dA")", R"("\u12")"
+  };
+
+  for (const auto engine: { cppconfig::json::JsonTokenizer::Engine::kScalar, cppconfig::json::JsonTokenizer::Engine::kIndexed }) {
+    const cppconfig::json::JsonTokenizer::Options options { engine };
+
+    for (const auto &[json, expected]: valid) {
+      cppconfig::json::JsonTokenizer tokenizer { cppconfig::json::Buffer { json.data(), json.size() }, options };
+      const auto token { tokenizer.next() };
+      ASSERT_EQ (token->id(), cppconfig::json::JsonTokenId::kValueString) << json;
+      ASSERT_EQ (token->view(), expected) << json;
+    }
+
+    for (const auto &json: invalid) {
+      cppconfig::json::JsonTokenizer tokenizer { cppconfig::json::Buffer { json.data(), json.size() }, options };
+      ASSERT_EQ (tokenizer.next()->id(), cppconfig::json::JsonTokenId::kError) << json;
+      ASSERT_EQ (tokenizer.error(), cppconfig::json::JsonTokenizer::Error::kInvalidEscape) << json;
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+// test_lazy_position
+// ----------------------------------------------------------------------------
+TEST (JsonTokenizer, test_lazy_position) {
+  constexpr const char *str0 { "{\n  \"a\": 1,\n  \"b\":\n 1a }" };
+  const size_t len { std::strlen (str0) };
+
+  cppconfig::json::JsonTokenizer eager { cppconfig::json::Buffer { str0, len } };
+  cppconfig::json::JsonTokenizer lazy { cppconfig::json::Buffer { str0, len, cppconfig::json::Buffer::Tracking::kLazy } };
+
+  for (size_t i { 0 }; i < 8; ++i) {
+    ASSERT_EQ (eager.next()->id(), lazy.next()->id());
+    ASSERT_EQ (eager.line(), lazy.line());
+    ASSERT_EQ (eager.column(), lazy.column());
+  }
+
+  ASSERT_EQ (lazy.error(), cppconfig::json::JsonTokenizer::Error::kPrematureEnd);
+  ASSERT_EQ (lazy.line(), 3);
+  ASSERT_EQ (lazy.column(), 2);
+}
+
+// ----------------------------------------------------------------------------
+// test_next_indexed
+// ----------------------------------------------------------------------------
+TEST (JsonTokenizer, test_next_indexed) {
+  const cppconfig::json::JsonTokenizer::Options options { cppconfig::json::JsonTokenizer::Engine::kIndexed };
+
+  cppconfig::json::Buffer buffer { kJsonStr01, std::strlen (kJsonStr01) };
+  cppconfig::json::JsonTokenizer tokenizer { std::move (buffer), options };
+  ASSERT_EQ (tokenizer.engine(), cppconfig::json::JsonTokenizer::Engine::kIndexed);
+
+  size_t idx { 0 };
+  for (auto token = tokenizer.next(); token.has_value(); token = tokenizer.next(), ++idx) {
+    ASSERT_EQ (token->id(), kJsonId01[idx]);
+
+    if (kJsonValue01[idx].has_value()) {
+      if (typeid(const char *) == kJsonValue01[idx].type())
+        EXPECT_EQ (token->value<std::string>(), std::any_cast<const char *> (kJsonValue01[idx]));
+      else if (typeid(int64_t) == kJsonValue01[idx].type())
+        EXPECT_EQ (token->value<int64_t>(), std::any_cast<int64_t> (kJsonValue01[idx]));
+      else if (typeid(double) == kJsonValue01[idx].type())
+        EXPECT_EQ (token->value<double>(), std::any_cast<double> (kJsonValue01[idx]));
+      else if (typeid(bool) == kJsonValue01[idx].type())
+        EXPECT_EQ (token->value<bool>(), std::any_cast<bool> (kJsonValue01[idx]));
+      else
+        ASSERT_TRUE (false);
+    }
+  }
+  ASSERT_EQ (kJsonId01.size(), idx);
+}
+
+// ----------------------------------------------------------------------------
+// test_zero_copy
+// ----------------------------------------------------------------------------
+TEST (JsonTokenizer, test_zero_copy) {
+  constexpr std::string_view kJson { R"(["abc", "", "a\"b", "x\u0041"])" };
+
+  for (const auto engine: { cppconfig::json::JsonTokenizer::Engine::kScalar, cppconfig::json::JsonTokenizer::Engine::kIndexed }) {
+    const cppconfig::json::JsonTokenizer::Options options { engine, true };
+
+    cppconfig::json::JsonTokenizer tokenizer { cppconfig::json::Buffer { kJson.data(), kJson.size() }, options };
+
+    std::vector<cppconfig::json::JsonToken> strings {};
+    for (auto token = tokenizer.next(); token.has_value(); token = tokenizer.next()) {
+      if (token->id() == cppconfig::json::JsonTokenId::kValueString)
+        strings.push_back (std::move (token.value()));
+    }
+    ASSERT_EQ (tokenizer.error(), cppconfig::json::JsonTokenizer::Error::kNoError);
+    ASSERT_EQ (strings.size(), 4);
+
+    ASSERT_TRUE (strings[0].borrowed());
+    ASSERT_EQ (strings[0].view(), "abc");
+    ASSERT_EQ (strings[0].view().data(), kJson.data() + 2);
+    ASSERT_TRUE (strings[1].borrowed());
+    ASSERT_EQ (strings[1].view(), "");
+    ASSERT_FALSE (strings[2].borrowed());
+    ASSERT_EQ (strings[2].view(), "a\"b");
+    ASSERT_FALSE (strings[3].borrowed());
+    ASSERT_EQ (strings[3].view(), "xA");
+  }
+}
+
+// ----------------------------------------------------------------------------
+// test_error_indexed
+// ----------------------------------------------------------------------------
+TEST (JsonTokenizer, test_error_indexed) {
+  const cppconfig::json::JsonTokenizer::Options options { cppconfig::json::JsonTokenizer::Engine::kIndexed };
+
+  constexpr const char *str0 { "{ \"test" };
+  cppconfig::json::JsonTokenizer tokenizer0 { cppconfig::json::Buffer { str0, std::strlen (str0) }, options };
+  ASSERT_EQ (tokenizer0.next()->id(), cppconfig::json::JsonTokenId::kObjectBegin);
+  ASSERT_EQ (tokenizer0.next()->id(), cppconfig::json::JsonTokenId::kError);
+  ASSERT_EQ (tokenizer0.error(), cppconfig::json::JsonTokenizer::Error::kPrematureEnd);
+  ASSERT_EQ (tokenizer0.line(), 0);
+  ASSERT_EQ (tokenizer0.column(), 7);
+
+  constexpr const char *str1 { "{ \"test\":\n1a }" };
+  cppconfig::json::JsonTokenizer tokenizer1 { cppconfig::json::Buffer { str1, std::strlen (str1) }, options };
+  ASSERT_EQ (tokenizer1.next()->id(), cppconfig::json::JsonTokenId::kObjectBegin);
+  ASSERT_EQ (tokenizer1.next()->id(), cppconfig::json::JsonTokenId::kValueString);
+  ASSERT_EQ (tokenizer1.next()->id(), cppconfig::json::JsonTokenId::kColon);
+  ASSERT_EQ (tokenizer1.next()->id(), cppconfig::json::JsonTokenId::kError);
+  ASSERT_EQ (tokenizer1.error(), cppconfig::json::JsonTokenizer::Error::kPrematureEnd);
+  ASSERT_EQ (tokenizer1.line(), 1);
+  ASSERT_EQ (tokenizer1.column(), 1);
+
+  constexpr const char *str2 { "{\n\"test\":\n \"aa\\kbbb\" }" };
+  cppconfig::json::JsonTokenizer tokenizer2 { cppconfig::json::Buffer { str2, std::strlen (str2) }, options };
+  ASSERT_EQ (tokenizer2.next()->id(), cppconfig::json::JsonTokenId::kObjectBegin);
+  ASSERT_EQ (tokenizer2.next()->id(), cppconfig::json::JsonTokenId::kValueString);
+  ASSERT_EQ (tokenizer2.next()->id(), cppconfig::json::JsonTokenId::kColon);
+  ASSERT_EQ (tokenizer2.next()->id(), cppconfig::json::JsonTokenId::kError);
+  ASSERT_EQ (tokenizer2.error(), cppconfig::json::JsonTokenizer::Error::kInvalidEscape);
+  ASSERT_EQ (tokenizer2.line(), 2);
+  ASSERT_EQ (tokenizer2.column(), 6);
+
+  constexpr const char *str3 { "[ truex ]" };
+  cppconfig::json::JsonTokenizer tokenizer3 { cppconfig::json::Buffer { str3, std::strlen (str3) }, options };
+  ASSERT_EQ (tokenizer3.next()->id(), cppconfig::json::JsonTokenId::kArrayBegin);
+  ASSERT_EQ (tokenizer3.next()->id(), cppconfig::json::JsonTokenId::kValueBoolean);
+  ASSERT_EQ (tokenizer3.next()->id(), cppconfig::json::JsonTokenId::kError);
+}
@@ -3,6 +3,11 @@
 //
 // Copyright (c) 2024 Carlos Carrasco
 // ----------------------------------------------------------------------------
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include <cppconfig/json_parser.h>
@@ -86,6 +91,56 @@ TEST (JsonValue, test_as) {
   ASSERT_EQ (v6.asArray().size(), 1);
 }
 
+// ----------------------------------------------------------------------------
+// test_copy_move
+// ----------------------------------------------------------------------------
+TEST (JsonValue, test_copy_move) {
+  ASSERT_EQ (sizeof (cppconfig::json::JsonValue), 16);
+
+  constexpr std::string_view kText { "borrowed" };
+
+  // items are moved in, an initializer list would copy them
+  std::vector<cppconfig::json::JsonValue> items {};
+  items.emplace_back (cppconfig::json::JsonToken { std::string { "owned" } });
+  items.emplace_back (cppconfig::json::JsonToken::borrow (kText));
+  cppconfig::json::JsonValue v0 { std::move (items) };
+
+  // copies are deep and own their strings, the original keeps referencing the same memory
+  cppconfig::json::JsonValue v1 { v0 };
+  v1[0].asString() += "!";
+  ASSERT_EQ (v0[0].asStringView(), "owned");
+  ASSERT_EQ (v1[0].asStringView(), "owned!");
+  ASSERT_EQ (v0[1].asStringView().data(), kText.data());
+  ASSERT_NE (v1[1].asStringView().data(), kText.data());
+  ASSERT_EQ (v1[1].asStringView(), "borrowed");
+
+  // a const borrowed string is only read as a view, a mutable one becomes owned
+  ASSERT_THROW (std::as_const (v0[1]).asString(), std::bad_variant_access);
+  ASSERT_THROW (std::as_const (v0[1]).get<std::string>(), std::bad_variant_access);
+  ASSERT_EQ (v0[1].asStringView().data(), kText.data());
+  ASSERT_EQ (v0[1].asString(), "borrowed");
+  ASSERT_NE (v0[1].asStringView().data(), kText.data());
+
+  v1[1].asString() += "?";
+  ASSERT_EQ (v1[1].asStringView(), "borrowed?");
+  ASSERT_EQ (kText, "borrowed");
+
+  // moves leave the source empty
+  cppconfig::json::JsonValue v2 { std::move (v1) };
+  ASSERT_TRUE (v1.empty());
+  ASSERT_EQ (v2.asArray().size(), 2);
+
+  // a value can be replaced by one of its items
+  v2 = std::move (v2[0]);
+  ASSERT_EQ (v2.asStringView(), "owned!");
+  v0 = v0[1];
+  ASSERT_EQ (v0.asStringView(), "borrowed");
+
+  ASSERT_THROW (v0.asInt(), std::bad_variant_access);
+  ASSERT_THROW (v0.asObject(), std::bad_variant_access);
+  ASSERT_FALSE (v0.exists ("a"));
+}
+
 // ----------------------------------------------------------------------------
 // test_type
 // ----------------------------------------------------------------------------
@@ -117,6 +172,7 @@ TEST (JsonValue, test_merge_invalid_types) {
   cppconfig::json::JsonValue v2 { cppconfig::json::JsonToken { int64_t(123) } };
 
   ASSERT_FALSE (cppconfig::json::JsonValue::merge (v1, v2));
+  ASSERT_TRUE (v2.asBool());
 }
 
 // ----------------------------------------------------------------------------
@@ -155,6 +211,21 @@ TEST (JsonValue, test_merge_basic_types) {
   ASSERT_TRUE (v12.isNull());
 }
 
+// ----------------------------------------------------------------------------
+// test_merge_null
+// ----------------------------------------------------------------------------
+TEST (JsonValue, test_merge_null) {
+  cppconfig::json::JsonParser parser;
+
+  auto src { parser.parse (R"({ "a": { "b": 1 }, "c": [ 1 ], "d": null })") };
+  auto dst { parser.parse (R"({ "a": null, "c": null, "d": { "e": 2 } })") };
+
+  ASSERT_TRUE (cppconfig::json::JsonValue::merge (src.value(), dst.value()));
+  ASSERT_EQ (dst.value()["a"]["b"].asInt(), 1);
+  ASSERT_EQ (dst.value()["c"].asArray().size(), 1);
+  ASSERT_TRUE (dst.value()["d"].isNull());
+}
+
 // ----------------------------------------------------------------------------
 // test_merge_object
 // ----------------------------------------------------------------------------
@@ -212,3 +283,108 @@ TEST (JsonValue, test_merge_array_object) {
   ASSERT_EQ (root2.value()["obj1"][0]["b"].asInt(), 2);
   ASSERT_EQ (root2.value()["obj1"][1]["a"].asInt(), 1);
 }
+
+// ----------------------------------------------------------------------------
+// test_object
+// ----------------------------------------------------------------------------
+TEST (JsonValue, test_object) {
+  for (const size_t n: { size_t { 3 }, cppconfig::json::JsonObject::kIndexThreshold, size_t { 1000 } }) {
+    std::string json { "{" };
+    for (size_t i { 0 }; i < n; ++i)
+      json += "\"k" + std::to_string (i) + "\": " + std::to_string (i) + ", ";
+    json += "\"k0\": -1 }";
+
+    cppconfig::json::JsonParser parser;
+    const auto root { parser.parse (json.c_str()) };
+
+    ASSERT_TRUE (root.has_value());
+    ASSERT_EQ (root->asObject().size(), n);
+
+    // insertion order is kept and the first occurrence of a key wins
+    size_t i { 0 };
+    for (const auto &[k, v]: root->asObject()) {
+      ASSERT_EQ (std::string_view { k }, "k" + std::to_string (i));
+      ASSERT_EQ (v.asInt(), static_cast<int64_t> (i++));
+    }
+
+    for (i = 0; i < n; ++i) {
+      ASSERT_TRUE (root->exists ("k" + std::to_string (i)));
+      ASSERT_EQ ((*root)["k" + std::to_string (i)].asInt(), static_cast<int64_t> (i));
+    }
+    ASSERT_FALSE (root->exists ("k"));
+    ASSERT_FALSE (root->exists ("k" + std::to_string (n)));
+
+    // copies and merges keep the lookups working
+    cppconfig::json::JsonValue copy { *root };
+    ASSERT_TRUE (cppconfig::json::JsonValue::merge (cppconfig::json::JsonValue { std::unordered_map<std::string, cppconfig::json::JsonValue> {
+      { "extra", cppconfig::json::JsonValue { cppconfig::json::JsonToken { true } } }
+    } }, copy));
+    ASSERT_EQ (copy.asObject().size(), n + 1);
+    ASSERT_TRUE (copy["extra"].asBool());
+    ASSERT_EQ (copy["k" + std::to_string (n - 1)].asInt(), static_cast<int64_t> (n - 1));
+  }
+}
+
+// ----------------------------------------------------------------------------
+// test_find
+// ----------------------------------------------------------------------------
+TEST (JsonValue, test_find) {
+  cppconfig::json::JsonParser parser;
+  auto root { parser.parse (R"({ "a": { "b": 1 }, "c": [ 2 ] })") };
+
+  ASSERT_TRUE (root.has_value());
+  ASSERT_NE (root->find ("a"), nullptr);
+  ASSERT_EQ (root->find ("a")->find ("b")->asInt(), 1);
+  ASSERT_EQ (root->find (std::string_view { "ab" }.substr (0, 1)), &(*root)["a"]);
+  ASSERT_EQ (root->find ("b"), nullptr);
+  ASSERT_EQ (root->find ("c")->find ("b"), nullptr);
+  ASSERT_EQ (root->find ("a")->find ("b")->find ("b"), nullptr);
+
+  // non-const lookups return a mutable value
+  *root->find ("c") = cppconfig::json::JsonValue { cppconfig::json::JsonToken { true } };
+  ASSERT_TRUE ((*root)["c"].asBool());
+
+  const auto &obj { root->asObject() };
+  ASSERT_EQ (obj.find ("c", cppconfig::json::JsonObject::hash ("c")), obj.find ("c"));
+  ASSERT_EQ (obj.find ("d", cppconfig::json::JsonObject::hash ("d")), obj.end());
+}
+
+// ----------------------------------------------------------------------------
+// test_merge_move
+// ----------------------------------------------------------------------------
+TEST (JsonValue, test_merge_move) {
+  const char *src { R"({ "a": { "x": 1, "y": [ 1 ] }, "b": { "big": [ 1, 2, 3 ] }, "c": "s", "d": null, "e": 1 })" };
+  const char *dst { R"({ "a": { "x": 0, "y": [ 0 ], "z": true }, "c": "t", "d": { "k": 1 }, "e": "no" })" };
+
+  cppconfig::json::JsonParser parser;
+  auto src1 { parser.parse (src) };
+  auto dst1 { parser.parse (dst) };
+  auto src2 { parser.parse (src) };
+  auto dst2 { parser.parse (dst) };
+
+  // "e" has different types, it is replaced and reported, and the other members are merged
+  ASSERT_FALSE (cppconfig::json::JsonValue::merge (src1.value(), dst1.value()));
+
+  // subtrees that are only in the source are moved, not copied
+  const auto *big { &src2.value()["b"].asObject() };
+  ASSERT_FALSE (cppconfig::json::JsonValue::merge (std::move (src2.value()), dst2.value()));
+  ASSERT_EQ (&dst2.value()["b"].asObject(), big);
+
+  for (const auto *root: { &dst1.value(), &dst2.value() }) {
+    ASSERT_EQ ((*root)["a"]["x"].asInt(), 1);
+    ASSERT_EQ ((*root)["a"]["y"].asArray().size(), 2);
+    ASSERT_EQ ((*root)["a"]["y"][0].asInt(), 0);
+    ASSERT_EQ ((*root)["a"]["y"][1].asInt(), 1);
+    ASSERT_TRUE ((*root)["a"]["z"].asBool());
+    ASSERT_EQ ((*root)["b"]["big"].asArray().size(), 3);
+    ASSERT_EQ ((*root)["c"].asStringView(), "s");
+    ASSERT_TRUE ((*root)["d"].isNull());
+    ASSERT_EQ ((*root)["e"].asInt(), 1);
+  }
+
+  ASSERT_TRUE (cppconfig::json::JsonValue::merge (std::move (parser.parse ("[ 2 ]").value()), dst2.value()["a"]["y"]));
+  ASSERT_EQ (dst2.value()["a"]["y"].asArray().size(), 3);
+
+  ASSERT_FALSE (cppconfig::json::JsonValue::merge (cppconfig::json::JsonValue { cppconfig::json::JsonToken { int64_t (1) } }, dst2.value()));
+  ASSERT_EQ (dst2.value().asInt(), 1);
+}
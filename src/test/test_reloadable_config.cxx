@@ -0,0 +1,243 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <cppconfig/reloadable_config.h>
+
+
+namespace {
+
+// ----------------------------------------------------------------------------
+struct TestSystem: public cppconfig::Config::System {
+  const std::string & getHostName() const override {
+    return hostName;
+  }
+
+  const std::string & getEnvName() const override {
+    return env;
+  }
+
+  std::string hostName { "myhostname" };
+  std::string env { "myenvname" };
+};
+
+// ----------------------------------------------------------------------------
+// Folder
+//
+// Temporary configuration folder, removed with all its files.
+// ----------------------------------------------------------------------------
+struct Folder {
+  explicit Folder (const char *name):
+    path { std::filesystem::temp_directory_path() / (name + std::to_string (::getpid())) }
+  {
+    std::filesystem::remove_all (path);
+    std::filesystem::create_directories (path);
+  }
+
+  ~Folder() {
+    std::filesystem::remove_all (path);
+  }
+
+  // writes a file in place
+  void write (const char *fileName, const char *json) const {
+    std::ofstream { path / fileName } << json;
+  }
+
+  // writes a file aside and renames it, as editors and deployment tools do
+  void replace (const char *fileName, const char *json) const {
+    write (".tmp", json);
+    std::filesystem::rename (path / ".tmp", path / fileName);
+  }
+
+  std::filesystem::path path;
+};
+
+// ----------------------------------------------------------------------------
+// waitForVersion
+// ----------------------------------------------------------------------------
+bool waitForVersion (const cppconfig::ReloadableConfig &config, uint64_t version) {
+  const auto deadline { std::chrono::steady_clock::now() + std::chrono::seconds { 10 } };
+  while (config.version() < version) {
+    if (std::chrono::steady_clock::now() > deadline)
+      return false;
+    std::this_thread::sleep_for (std::chrono::milliseconds { 5 });
+  }
+
+  return true;
+}
+
+}
+
+// ----------------------------------------------------------------------------
+// test_reload
+// ----------------------------------------------------------------------------
+TEST (ReloadableConfig, test_reload) {
+  const TestSystem system {};
+  const Folder folder { "cppconfig_reload_" };
+  folder.write ("default.json", R"({ "a": 1, "b": { "c": "x" } })");
+  folder.write ("myenvname.json", R"({ "a": 2 })");
+
+  int errors { 0 };
+  cppconfig::ReloadableConfig::Options options {};
+  options.watch = false;
+  options.onError = [&errors] (std::exception_ptr) { ++errors; };
+
+  cppconfig::ReloadableConfig config { folder.path, options, system };
+  ASSERT_EQ (config.get<int32_t> ("a"), 2);
+  ASSERT_EQ (config.get<std::string> ("b.c"), std::string ("x"));
+  ASSERT_EQ (config.version(), 0);
+
+  folder.write ("default.json", R"({ "a": 1, "b": { "c": "y" } })");
+  folder.write ("myhostname.json", R"({ "a": 3 })");
+  ASSERT_TRUE (config.reload());
+  ASSERT_EQ (config.version(), 1);
+  ASSERT_EQ (config.get<int32_t> ("a"), 3);
+  ASSERT_EQ (config.get<std::string> (cppconfig::Config::Path { "b.c" }), std::string ("y"));
+
+  // a snapshot keeps its version, which is released once the snapshot is gone
+  std::thread reloader {};
+  {
+    const auto snapshot { config.snapshot() };
+    folder.write ("myhostname.json", R"({ "a": 4 })");
+    reloader = std::thread { [&config] { config.reload(); } };
+    ASSERT_TRUE (waitForVersion (config, 2));
+    ASSERT_EQ (config.get<int32_t> ("a"), 4);
+    ASSERT_EQ (snapshot->get<int32_t> ("a"), 3);
+  }
+  reloader.join();
+
+  // a thread cannot wait for its own snapshot to be released
+  {
+    const auto snapshot { config.snapshot() };
+    ASSERT_THROW (config.reload(), std::logic_error);
+  }
+
+  // a broken file keeps the current version
+  folder.write ("default.json", R"({ "a": )");
+  ASSERT_FALSE (config.reload());
+  ASSERT_EQ (errors, 1);
+  ASSERT_EQ (config.version(), 2);
+  ASSERT_EQ (config.get<int32_t> ("a"), 4);
+
+  ASSERT_THROW (cppconfig::ReloadableConfig (folder.path / "default.json", options, system), std::invalid_argument);
+
+  // storages whose lookups take a lock
+  options.config.storage = cppconfig::Config::Options::Storage::kLazy;
+  ASSERT_THROW (cppconfig::ReloadableConfig (folder.path, options, system), std::invalid_argument);
+  options.config.storage = cppconfig::Config::Options::Storage::kLayered;
+  ASSERT_THROW (cppconfig::ReloadableConfig (folder.path, options, system), std::invalid_argument);
+}
+
+// ----------------------------------------------------------------------------
+// test_watch
+// ----------------------------------------------------------------------------
+TEST (ReloadableConfig, test_watch) {
+  const TestSystem system {};
+  const Folder folder { "cppconfig_watch_" };
+  folder.write ("default.json", R"({ "port": 80 })");
+
+  std::atomic<int> errors { 0 };
+  cppconfig::ReloadableConfig::Options options {};
+  options.debounce = std::chrono::milliseconds { 20 };
+  options.interval = std::chrono::milliseconds { 20 };
+  options.onError = [&errors] (std::exception_ptr) {
+    ++errors;
+    throw std::runtime_error { "rethrown by onError" };
+  };
+
+  cppconfig::ReloadableConfig config { folder.path, options, system };
+  ASSERT_EQ (config.get<int32_t> ("port"), 80);
+
+  folder.replace ("default.json", R"({ "port": 8080 })");
+  ASSERT_TRUE (waitForVersion (config, 1));
+  ASSERT_EQ (config.get<int32_t> ("port"), 8080);
+
+  folder.write ("myenvname.json", R"({ "port": 9090 })");
+  ASSERT_TRUE (waitForVersion (config, 2));
+  ASSERT_EQ (config.get<int32_t> ("port"), 9090);
+
+  // the drop-in folder is watched once it appears, until it is removed
+  std::filesystem::create_directory (folder.path / "drop-ins");
+  folder.write ("drop-ins/10-host.json", R"({ "host": "example.org" })");
+  std::filesystem::rename (folder.path / "drop-ins", folder.path / "conf.d");
+  ASSERT_TRUE (waitForVersion (config, 3));
+  ASSERT_EQ (config.get<std::string> ("host"), std::string ("example.org"));
+
+  folder.replace ("conf.d/10-host.json", R"({ "host": "example.com" })");
+  ASSERT_TRUE (waitForVersion (config, 4));
+  ASSERT_EQ (config.get<std::string> ("host"), std::string ("example.com"));
+
+  std::filesystem::remove_all (folder.path / "conf.d");
+  ASSERT_TRUE (waitForVersion (config, 5));
+  ASSERT_FALSE (config.get<std::string> ("host").has_value());
+
+  // an exception thrown by onError does not stop the watcher
+  folder.replace ("default.json", R"({ "port": )");
+  const auto deadline { std::chrono::steady_clock::now() + std::chrono::seconds { 10 } };
+  while ((errors == 0) && (std::chrono::steady_clock::now() < deadline))
+    std::this_thread::sleep_for (std::chrono::milliseconds { 5 });
+  ASSERT_GT (errors, 0);
+
+  folder.replace ("default.json", R"({ "port": 80, "tls": true })");
+  ASSERT_TRUE (waitForVersion (config, 6));
+  ASSERT_EQ (config.get<bool> ("tls"), true);
+}
+
+// ----------------------------------------------------------------------------
+// test_readers
+// ----------------------------------------------------------------------------
+TEST (ReloadableConfig, test_readers) {
+  const TestSystem system {};
+  const Folder folder { "cppconfig_readers_" };
+  folder.write ("default.json", R"({ "a": 0, "b": 0 })");
+
+  cppconfig::ReloadableConfig::Options options {};
+  options.watch = false;
+
+  cppconfig::ReloadableConfig config { folder.path, options, system };
+
+  // every version has a == b: a reader never sees two versions at once
+  std::atomic<bool> done { false };
+  std::atomic<int> mismatches { 0 };
+  std::vector<std::thread> readers {};
+  for (int i { 0 }; i < 4; ++i) {
+    readers.emplace_back ([&] {
+      while (!done.load()) {
+        const auto snapshot { config.snapshot() };
+        if (snapshot->get<int32_t> ("a") != snapshot->get<int32_t> ("b"))
+          ++mismatches;
+      }
+    });
+  }
+
+  for (int i { 1 }; i <= 50; ++i) {
+    std::string json { "{ \"a\": " };
+    json += std::to_string (i);
+    json += ", \"b\": ";
+    json += std::to_string (i);
+    json += " }";
+    folder.write ("default.json", json.c_str());
+    ASSERT_TRUE (config.reload());
+  }
+
+  done = true;
+  for (auto &reader: readers)
+    reader.join();
+
+  ASSERT_EQ (mismatches.load(), 0);
+  ASSERT_EQ (config.get<int32_t> ("a"), 50);
+}
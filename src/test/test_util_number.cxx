@@ -0,0 +1,94 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <cppconfig/number_util.h>
+
+
+// ----------------------------------------------------------------------------
+// test_parse_double
+// ----------------------------------------------------------------------------
+TEST (NumberUtil, test_parse_double) {
+  // the compiler converts the literals with correct rounding
+  const std::vector<std::pair<std::string_view, double>> values {
+    { "0", 0.0 },
+    { "-0.0", -0.0 },
+    { "1", 1.0 },
+    { "1.", 1.0 },
+    { ".5", 0.5 },
+    { "-12.5e-3", -12.5e-3 },
+    { "0.1", 0.1 },
+    { "3.141592653589793", 3.141592653589793 },
+    { "1E22", 1e22 },
+    { "1e23", 1e23 },
+    { "9007199254740993", 9007199254740993.0 },
+    { "7.2057594037927933e16", 7.2057594037927933e16 },
+    { "2.2250738585072011e-308", 2.2250738585072011e-308 },
+    { "2.2250738585072014e-308", 2.2250738585072014e-308 },
+    { "4.9406564584124654e-324", 4.9406564584124654e-324 },
+    { "1.7976931348623157e308", 1.7976931348623157e308 },
+    { "123456789012345678901234567890e-10", 123456789012345678901234567890e-10 },
+    { "0.000000000000000000000000000000000000000000001e45", 1.0 },
+    // exactly halfway between 1 and the next double: rounds to even
+    { "1.00000000000000011102230246251565404236316680908203125", 1.0 },
+    // just above halfway: rounds up
+    { "1.00000000000000011102230246251565404236316680908203126", 1.0000000000000002 }
+  };
+
+  for (const auto &[str, expected]: values) {
+    double value {};
+    const auto r { cppconfig::util::NumberUtil::parseDouble (str.data(), str.data() + str.size(), value) };
+
+    ASSERT_EQ (r.ec, std::errc {}) << str;
+    ASSERT_EQ (r.ptr, str.data() + str.size()) << str;
+    ASSERT_EQ (std::bit_cast<uint64_t> (value), std::bit_cast<uint64_t> (expected)) << str;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// test_parse_double_errors
+// ----------------------------------------------------------------------------
+TEST (NumberUtil, test_parse_double_errors) {
+  for (const std::string_view str: { "", "-", ".", "-.e1", "e1", "+1" }) {
+    double value { 7.0 };
+    const auto r { cppconfig::util::NumberUtil::parseDouble (str.data(), str.data() + str.size(), value) };
+
+    ASSERT_EQ (r.ec, std::errc::invalid_argument) << str;
+    ASSERT_EQ (r.ptr, str.data()) << str;
+    ASSERT_EQ (value, 7.0);
+  }
+
+  // the exponent is only consumed if it has digits
+  for (const std::string_view str: { "1e", "1e+", "1.5E-x" }) {
+    double value {};
+    const auto r { cppconfig::util::NumberUtil::parseDouble (str.data(), str.data() + str.size(), value) };
+
+    ASSERT_EQ (r.ec, std::errc {}) << str;
+    ASSERT_EQ (*r.ptr, str[str.find_first_of ("eE")]) << str;
+  }
+
+  double value {};
+  constexpr std::string_view kOverflow { "-1e400" };
+  ASSERT_EQ (
+    cppconfig::util::NumberUtil::parseDouble (kOverflow.data(), kOverflow.data() + kOverflow.size(), value).ec,
+    std::errc::result_out_of_range
+  );
+  ASSERT_EQ (value, -std::numeric_limits<double>::infinity());
+
+  constexpr std::string_view kUnderflow { "1e-400" };
+  ASSERT_EQ (
+    cppconfig::util::NumberUtil::parseDouble (kUnderflow.data(), kUnderflow.data() + kUnderflow.size(), value).ec,
+    std::errc::result_out_of_range
+  );
+  ASSERT_EQ (value, 0.0);
+}
@@ -0,0 +1,49 @@
+// ----------------------------------------------------------------------------
+// MIT License
+//
+// Copyright (c) 2024 Carlos Carrasco
+// ----------------------------------------------------------------------------
+#include <algorithm>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <cppconfig/simd_util.h>
+
+
+// ----------------------------------------------------------------------------
+// test_isa
+// ----------------------------------------------------------------------------
+TEST (SimdUtil, test_isa) {
+  ASSERT_TRUE (cppconfig::util::SimdUtil::supports (cppconfig::util::SimdUtil::Isa::kScalar));
+  ASSERT_TRUE (cppconfig::util::SimdUtil::supports (cppconfig::util::SimdUtil::isa()));
+}
+
+// ----------------------------------------------------------------------------
+// test_count
+// ----------------------------------------------------------------------------
+TEST (SimdUtil, test_count) {
+  std::string str {};
+  for (size_t i { 0 }; i < 70000; ++i)
+    str.push_back ((i % 7 == 0) ? '\n' : static_cast<char> ('a' + i % 26));
+
+  for (const auto isa: {
+    cppconfig::util::SimdUtil::Isa::kScalar,
+    cppconfig::util::SimdUtil::Isa::kSse42,
+    cppconfig::util::SimdUtil::Isa::kAvx2,
+    cppconfig::util::SimdUtil::Isa::kNeon
+  }) {
+    if (!cppconfig::util::SimdUtil::supports (isa))
+      continue;
+
+    for (const size_t size: { str.size(), size_t { 4097 }, size_t { 33 }, size_t { 15 }, size_t { 0 } }) {
+      const auto expected { static_cast<size_t> (std::count (str.data(), str.data() + size, '\n')) };
+      ASSERT_EQ (cppconfig::util::SimdUtil::count (str.data(), size, '\n', isa), expected);
+    }
+  }
+
+  ASSERT_EQ (
+    cppconfig::util::SimdUtil::count (str.data(), str.size(), 'z'),
+    static_cast<size_t> (std::count (str.begin(), str.end(), 'z'))
+  );
+}